@@ -0,0 +1,76 @@
+#include "bench_common.h"
+#include "../c_graph.h"
+#include <stdexcept>
+#include <unordered_set>
+
+namespace {
+	/**
+	 * @brief The original unordered_map based A*, kept here as the baseline to compare against.
+	 * @note  is_valid_move is skipped since it is private and always passes for 4-way neighbours.
+	 */
+	std::vector<std::pair<int, int>> a_star_unordered(const c_graph& graph, const Node& start, const Node& goal) {
+		std::priority_queue<std::pair<Node, double>, std::vector<std::pair<Node, double>>, NodeComparator> open_set;
+		std::unordered_map<Node, Node> came_from;
+		std::unordered_map<Node, double> g_score;
+		std::unordered_map<Node, double> f_score;
+		std::unordered_set<Node> closed_set;
+
+		open_set.emplace(start, 0.0);
+		g_score[start] = 0.0;
+		f_score[start] = graph.manhattan_distance(start, goal);
+
+		while (!open_set.empty()) {
+			Node current = open_set.top().first;
+			open_set.pop();
+			if (current == goal) {
+				std::vector<std::pair<int, int>> path;
+				while (came_from.find(current) != came_from.end()) {
+					path.emplace_back(current.x, current.y);
+					current = came_from.at(current);
+				}
+				path.emplace_back(current.x, current.y);
+				std::reverse(path.begin(), path.end());
+				return path;
+			}
+			closed_set.insert(current);
+			for (const auto& neighbor : graph.get_neighbors(current)) {
+				if (closed_set.find(neighbor) != closed_set.end() || neighbor.is_wall) continue;
+				double tentative_g_score = g_score[current] + graph.euclidean_distance(current, neighbor);
+				if (g_score.find(neighbor) == g_score.end() || tentative_g_score < g_score[neighbor]) {
+					came_from[neighbor] = current;
+					g_score[neighbor] = tentative_g_score;
+					f_score[neighbor] = g_score[neighbor] + graph.manhattan_distance(neighbor, goal);
+					open_set.emplace(neighbor, f_score[neighbor]);
+				}
+			}
+		}
+		return {};
+	}
+
+
+	// Times both implementations on one map after checking they return identical paths.
+	void compare_on_map(const std::string& label, const std::vector<std::vector<char>>& map) {
+		c_graph graph(map);
+		c_search_state state;
+		const Node start = find_node(graph, map, 's');
+		const Node goal = find_node(graph, map, 'x');
+
+		if (graph.a_star(start, goal, state) != a_star_unordered(graph, start, goal)) {
+			throw std::runtime_error("a_star and the unordered_map baseline disagree on " + label);
+		}
+		run_timed("a_star_unordered/" + label, [&] { a_star_unordered(graph, start, goal); });
+		run_timed("a_star_flat/" + label, [&] { graph.a_star(start, goal, state); });
+	}
+}
+
+BENCHMARK(bm_a_star_shipped_maps) {
+	for (const char* name : { "ValidMap1", "ValidMap2", "ValidMapNoPath1", "ValidMapNoPath2" }) {
+		compare_on_map(name, load_shipped_map(std::string("maps/") + name + ".txt"));
+	}
+}
+
+BENCHMARK(bm_a_star_generated_maps) {
+	for (int size : { 256, 1024 }) {
+		compare_on_map(std::to_string(size) + "x" + std::to_string(size), make_random_map(size, size, 20, 1234));
+	}
+}
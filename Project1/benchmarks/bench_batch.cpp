@@ -0,0 +1,59 @@
+#include "bench_common.h"
+#include "../c_batch_runner.h"
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// The batch runner over the shipped maps and a generated corpus, checking every generated map has a path from start to
+// exit and the output is the same for 1 to 8 threads, then timed in maps per second against the thread count.
+BENCHMARK(bm_batch) {
+	const int size = std::min(512, max_map_size());
+	std::vector<BatchJob> jobs;
+	for (const char* shipped : { "maps/ValidMap1.txt", "maps/ValidMap2.txt", "maps/ValidMapNoPath1.txt", "maps/ValidMapNoPath2.txt" }) {
+		jobs.push_back({ shipped, {} });
+	}
+	std::vector<std::string> generated;
+	for (int i = 0; i < 16; ++i) {
+		const MapKind kind = static_cast<MapKind>(i % 4);
+		generated.push_back("bench_batch_" + std::to_string(i) + ".txt");
+		write_map_file(generated.back(), make_map(kind, size, size, static_cast<std::uint32_t>(i + 1)));
+		jobs.push_back({ generated.back(), { { { 1, 1 }, { size - 2, size - 2 } } } });
+		jobs.push_back({ generated.back(), {} });
+	}
+
+	// Every generated map has its start and exit in one region.
+	std::vector<BatchJob> start_to_exit;
+	for (const std::string& filename : generated) start_to_exit.push_back({ filename, {} });
+	std::ostringstream discard;
+	const BatchSummary connected = c_batch_runner(1, false).run(start_to_exit, discard);
+	if (connected.failed != 0 || connected.paths_found != generated.size()) {
+		throw std::runtime_error("A generated map has no path from start to exit");
+	}
+
+	std::string reference;
+	for (unsigned threads : { 1u, 2u, 4u, 8u }) {
+		c_batch_runner runner(threads, false);
+		std::ostringstream out;
+		if (runner.run(jobs, out).failed != 0) {
+			throw std::runtime_error("A batch job failed:\n" + out.str());
+		}
+		if (reference.empty()) {
+			reference = out.str();
+		} else if (out.str() != reference) {
+			throw std::runtime_error("Batch output differs with " + std::to_string(threads) + " threads");
+		}
+
+		// Timed with timings on, as a real run would be.
+		c_batch_runner timed(threads, true);
+		std::uint64_t batches = 0;
+		double seconds = 0.0;
+		while (seconds < 1.0) {
+			discard.str("");
+			seconds += timed.run(jobs, discard).seconds;
+			++batches;
+		}
+		report("batch/threads:" + std::to_string(threads), batches, seconds, "maps/s", static_cast<double>(batches * jobs.size()) / seconds);
+	}
+	for (const std::string& filename : generated) std::remove(filename.c_str());
+}
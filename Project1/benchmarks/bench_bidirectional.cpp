@@ -0,0 +1,83 @@
+#include "bench_common.h"
+#include "../c_graph.h"
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	struct Query {
+		Node start;
+		Node goal;
+	};
+
+	std::vector<Query> random_queries(const c_graph& graph, std::size_t count, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> row(0, graph.rows() - 1), col(0, graph.cols() - 1);
+		std::vector<Query> queries;
+		while (queries.size() < count) {
+			const Node start = graph.get_node(row(rng), col(rng));
+			const Node goal = graph.get_node(row(rng), col(rng));
+			if (!start.is_wall && !goal.is_wall) queries.push_back({ start, goal });
+		}
+		return queries;
+	}
+
+	// Checks every query's bidirectional path costs the same as a_star's, then reports expansions and time.
+	template <typename Neighbourhood>
+	void compare(const std::string& label, const c_graph& graph, const std::vector<Query>& queries) {
+		c_search_state state;
+		c_bidirectional_search_state both;
+		std::vector<std::pair<int, int>> path;
+		std::size_t expanded = 0;
+		std::size_t expanded_both = 0;
+		for (const Query& query : queries) {
+			const auto one_way = graph.a_star<Neighbourhood>(query.start, query.goal, state);
+			expanded += state.expansions();
+			const auto two_way = graph.bidirectional_a_star<Neighbourhood>(query.start, query.goal, both);
+			expanded_both += both.expansions();
+			const double cost = one_way.empty() ? -1.0 : checked_path_cost(graph, one_way);
+			const double cost_both = two_way.empty() ? -1.0 : checked_path_cost(graph, two_way);
+			if (std::abs(cost - cost_both) > 1e-9 ||
+				(!two_way.empty() && (two_way.front() != std::make_pair(query.start.x, query.start.y) || two_way.back() != std::make_pair(query.goal.x, query.goal.y)))) {
+				throw std::runtime_error("Bidirectional path differs from A* on " + label);
+			}
+		}
+		std::cout << label << " queries=" << queries.size() << " expanded a_star=" << expanded
+			<< " bidirectional=" << expanded_both << '\n';
+		run_timed("a_star/" + label, [&] {
+			for (const Query& query : queries) {
+				path.clear();
+				graph.a_star<Neighbourhood>(query.start, query.goal, state, path);
+			}
+		});
+		run_timed("bidirectional_a_star/" + label, [&] {
+			for (const Query& query : queries) {
+				path.clear();
+				graph.bidirectional_a_star<Neighbourhood>(query.start, query.goal, both, path);
+			}
+		});
+	}
+
+	void compare_on_map(const std::string& label, const std::vector<std::vector<char>>& map, std::size_t query_count) {
+		const c_graph graph(map);
+		// The map's own start to exit first, then random pairs.
+		std::vector<Query> queries = { { find_node(graph, map, 's'), find_node(graph, map, 'x') } };
+		for (const Query& query : random_queries(graph, query_count - 1, 19)) {
+			queries.push_back(query);
+		}
+		compare<Neighbourhood4>("4way/" + label, graph, queries);
+		compare<Neighbourhood8>("8way/" + label, graph, queries);
+	}
+}
+
+// One-directional against bidirectional A*, 4-way and 8-way, on the shipped maps and large generated ones.
+BENCHMARK(bm_bidirectional) {
+	for (const char* name : { "ValidMap1", "ValidMap2", "ValidMapNoPath1", "ValidMapNoPath2" }) {
+		compare_on_map(name, load_shipped_map(std::string("maps/") + name + ".txt"), 200);
+	}
+	compare_on_map("maze_1024x1024", make_maze_map(1024, 1024, 5, 31), 20);
+	compare_on_map("maze_2048x2048", make_maze_map(2048, 2048, 5, 31), 10);
+	compare_on_map("random_2048x2048", make_random_map(2048, 2048, 25, 31), 10);
+}
@@ -0,0 +1,151 @@
+#include "bench_common.h"
+#include "../c_binary_map.h"
+#include "../c_dungeon_map.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+	// Copies a binary map with every cell overwritten by a character the map format rejects, header and bitset kept.
+	void write_scrambled_copy(const std::string& binary_filename, const std::string& scrambled_filename) {
+		std::vector<char> bytes;
+		{
+			std::ifstream in(binary_filename, std::ios::binary);
+			bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		}
+		const c_binary_map binary(binary_filename);
+		const std::size_t count = static_cast<std::size_t>(binary.rows()) * binary.cols();
+		std::fill_n(bytes.begin() + static_cast<std::ptrdiff_t>(binary.header().cells_offset), count, '?');
+		std::ofstream out(scrambled_filename, std::ios::binary);
+		out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+	}
+
+	// Headers crafted to wrap the offset checks or overflow the int cell indices must be rejected when mapped.
+	void check_rejects_bad_headers(const std::string& binary_filename) {
+		std::vector<char> bytes;
+		{
+			std::ifstream in(binary_filename, std::ios::binary);
+			bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		}
+		binary_map_header good;
+		std::memcpy(&good, bytes.data(), sizeof(good));
+		const auto wrap = [](std::uint64_t offset) { return std::uint64_t(0) - offset; };
+		std::vector<binary_map_header> bad(4, good);
+		bad[0].cells_offset = wrap(64);                 // cells_offset + cell count wraps to a small number.
+		bad[1].bitset_offset = wrap(8);                 // Same for the bitset.
+		bad[2].rows = bad[2].cols = 65536;              // rows * cols overflows an int.
+		bad[3].start_x = good.rows; bad[3].start_y = 0; // Position off the map.
+		const std::string crafted_filename = "bench_crafted.dmap";
+		for (std::size_t k = 0; k < bad.size(); ++k) {
+			std::memcpy(bytes.data(), &bad[k], sizeof(bad[k]));
+			{
+				std::ofstream out(crafted_filename, std::ios::binary);
+				out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+			}
+			bool rejected = false;
+			try {
+				c_binary_map(crafted_filename).to_graph();
+			}
+			catch (const std::runtime_error&) {
+				rejected = true;
+			}
+			if (!rejected) {
+				throw std::runtime_error("Crafted binary header " + std::to_string(k) + " was accepted");
+			}
+		}
+		std::remove(crafted_filename.c_str());
+	}
+
+	// The mapped path must build the graph and load the map from the bitset and header alone: with the cells
+	// scrambled the results still match the text map, where a per-cell scan would find nothing but invalid cells.
+	void check_no_cell_reads(const c_dungeon_map& original, const std::string& binary_filename) {
+		const std::string scrambled_filename = "bench_scrambled.dmap";
+		write_scrambled_copy(binary_filename, scrambled_filename);
+		const c_graph expected = original.to_graph();
+		if (!c_binary_map(scrambled_filename).to_graph().same_layout(expected)) {
+			throw std::runtime_error("Mapped graph read the cells of " + binary_filename);
+		}
+		c_dungeon_map loaded;
+		loaded.load_binary_map(scrambled_filename);
+		if (!loaded.to_graph().same_layout(expected) || loaded.get_start_node() != original.get_start_node() ||
+			loaded.get_end_node() != original.get_end_node() || loaded.reachability().items != original.reachability().items) {
+			throw std::runtime_error("Binary load read the cells of " + binary_filename);
+		}
+		std::remove(scrambled_filename.c_str());
+	}
+
+	// Converts text -> binary -> text and checks the cells, header and bitset survive unchanged.
+	void check_round_trip(const std::string& text_filename) {
+		const std::string binary_filename = "bench_round_trip.dmap";
+		const std::string back_filename = "bench_round_trip.txt";
+		c_dungeon_map original(text_filename);
+		convert_text_to_binary(text_filename, binary_filename);
+		{
+			c_binary_map binary(binary_filename);
+			const std::size_t count = static_cast<std::size_t>(binary.rows()) * binary.cols();
+			if (binary.rows() != original.rows() || binary.cols() != original.cols() ||
+				std::memcmp(binary.cells(), original.data(), count) != 0) {
+				throw std::runtime_error("Binary cells differ from " + text_filename);
+			}
+			const auto start = original.get_start_node();
+			const auto exit = original.get_end_node();
+			if (binary.header().start_x != start.first || binary.header().start_y != start.second ||
+				binary.header().exit_x != exit.first || binary.header().exit_y != exit.second) {
+				throw std::runtime_error("Binary header positions differ for " + text_filename);
+			}
+			for (std::size_t i = 0; i < count; ++i) {
+				const bool walkable = (binary.walkable_bits()[i / 64] >> (i % 64)) & 1;
+				if (walkable != (original.data()[i] != 'w')) {
+					throw std::runtime_error("Binary bitset differs for " + text_filename);
+				}
+			}
+			if (!binary.to_graph().same_layout(original.to_graph())) {
+				throw std::runtime_error("Binary graph differs for " + text_filename);
+			}
+		}
+		check_no_cell_reads(original, binary_filename);
+		check_rejects_bad_headers(binary_filename);
+		{
+			// Without a bitset the cells have to be scanned, and must give the same graph.
+			c_binary_map::save(binary_filename, original.data(), original.rows(), original.cols(), false);
+			if (!c_binary_map(binary_filename).to_graph().same_layout(original.to_graph())) {
+				throw std::runtime_error("Scanned binary graph differs for " + text_filename);
+			}
+			convert_text_to_binary(text_filename, binary_filename);
+		}
+		convert_binary_to_text(binary_filename, back_filename);
+		c_dungeon_map back(back_filename);
+		if (std::memcmp(back.data(), original.data(), static_cast<std::size_t>(back.rows()) * back.cols()) != 0) {
+			throw std::runtime_error("Text round trip differs for " + text_filename);
+		}
+		std::remove(binary_filename.c_str());
+		std::remove(back_filename.c_str());
+	}
+}
+
+BENCHMARK(bm_binary_map) {
+	for (const char* name : { "ValidMap1", "ValidMap2", "ValidMapNoPath1", "ValidMapNoPath2" }) {
+		check_round_trip(std::string("maps/") + name + ".txt");
+	}
+
+	for (int size : { 1024, 4096 }) {
+		const std::string label = std::to_string(size) + "x" + std::to_string(size);
+		const std::string text_filename = "bench_binary_" + label + ".txt";
+		const std::string binary_filename = "bench_binary_" + label + ".dmap";
+		write_map_file(text_filename, make_random_map(size, size, 20, 7));
+		convert_text_to_binary(text_filename, binary_filename);
+
+		c_dungeon_map map;
+		run_timed("load_text/" + label, [&] { map.load_map(text_filename); });
+		run_timed("load_binary_copy/" + label, [&] { map.load_binary_map(binary_filename); });
+		run_timed("map_binary/" + label, [&] { c_binary_map binary(binary_filename); });
+		run_timed("graph_text/" + label, [&] { c_graph graph(map.data(), map.rows(), map.cols()); });
+		run_timed("graph_binary/" + label, [&] { c_graph graph = c_binary_map(binary_filename).to_graph(); });
+		std::remove(text_filename.c_str());
+		std::remove(binary_filename.c_str());
+	}
+}
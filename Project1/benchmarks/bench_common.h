@@ -0,0 +1,133 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : bench_common.h
+// Description : Minimal benchmark harness and synthetic map helpers shared by the benchmark files.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../c_graph.h"
+
+/**
+ * @brief Register a benchmark so bench_main runs it.
+ * @param name - Name printed next to the results, also used for filtering on the command line.
+ * @param fn   - The benchmark body.
+ * @note  Use through the BENCHMARK macro so registration happens at static initialisation.
+ */
+bool register_benchmark(const std::string& name, std::function<void()> fn);
+
+#define BENCHMARK(name) \
+	static void name(); \
+	static const bool name##_registered = register_benchmark(#name, name); \
+	static void name()
+
+/**
+ * @brief Print one result line: name, iterations, mean time per iteration and an optional extra counter.
+ */
+void report(const std::string& name, std::uint64_t iterations, double total_seconds,
+	const std::string& counter_name = "", double counter_value = 0.0);
+
+/**
+ * @brief Largest map side the size sweeps should generate, set with --max-size on the command line.
+ */
+int max_map_size();
+
+/**
+ * @brief Run fn repeatedly until at least min_seconds have passed, then report the mean.
+ * @return The total number of iterations run.
+ */
+template <typename Fn>
+std::uint64_t run_timed(const std::string& name, Fn&& fn, double min_seconds = 0.5) {
+	using clock = std::chrono::steady_clock;
+	std::uint64_t iterations = 0;
+	const auto begin = clock::now();
+	double elapsed = 0.0;
+	do {
+		fn();
+		++iterations;
+		elapsed = std::chrono::duration<double>(clock::now() - begin).count();
+	} while (elapsed < min_seconds);
+	report(name, iterations, elapsed);
+	return iterations;
+}
+
+/**
+ * @brief Generate a map with a wall border, random interior walls, 's' in the top-left, 'x' in the bottom-right
+ *        and the items 'a'-'j' along the second row, so it passes c_dungeon_map::verify_map.
+ * @param rows         - Number of rows.
+ * @param cols         - Number of columns.
+ * @param wall_percent - Chance (0-100) that an interior cell is a wall.
+ * @param seed         - Seed for the generator, the same seed always gives the same map.
+ */
+std::vector<std::vector<char>> make_random_map(int rows, int cols, int wall_percent, std::uint32_t seed);
+
+/**
+ * @brief Generate a maze with one-cell corridors, 's' in the top-left corner, 'x' in the bottom-right corner
+ *        and the items 'a'-'j' along the second row, so it passes c_dungeon_map::verify_map.
+ * @param loop_percent - Chance (0-100) that each remaining wall between two corridors is knocked through,
+ *                       0 gives a perfect maze with exactly one route between any two cells.
+ * @param seed         - Seed for the generator, the same seed always gives the same maze.
+ */
+std::vector<std::vector<char>> make_maze_map(int rows, int cols, int loop_percent, std::uint32_t seed);
+
+/**
+ * @brief Generate a cave: random walls smoothed by a cellular automaton, with 's' at the first and 'x' at the last
+ *        floor cell (in row order) of the largest open region, and the items 'a'-'j' scattered through that region.
+ * @param seed - Seed for the generator, the same seed always gives the same cave.
+ */
+std::vector<std::vector<char>> make_cave_map(int rows, int cols, std::uint32_t seed);
+
+/**
+ * @brief Generate rectangular rooms joined by one-cell corridors, with 's' in the first room, 'x' in the last room
+ *        and the items 'a'-'j' in random rooms. Every room is reachable from every other.
+ * @param seed - Seed for the generator, the same seed always gives the same layout.
+ */
+std::vector<std::vector<char>> make_rooms_map(int rows, int cols, std::uint32_t seed);
+
+enum class MapKind { OPEN, CAVE, MAZE, ROOMS };
+
+/**
+ * @brief Generate a map of the specified kind. OPEN is make_random_map with 10% walls, MAZE is make_maze_map
+ *        with 5% of the walls knocked through.
+ */
+std::vector<std::vector<char>> make_map(MapKind kind, int rows, int cols, std::uint32_t seed);
+
+/**
+ * @brief Get the lower case name of a map kind ("open", "cave", "maze" or "rooms").
+ */
+const char* map_kind_name(MapKind kind);
+
+/**
+ * @brief Get the map kind with the specified name, throws std::invalid_argument if there is none.
+ */
+MapKind parse_map_kind(const std::string& name);
+
+/**
+ * @brief Load one of the shipped maps in maps/ without verifying it.
+ */
+std::vector<std::vector<char>> load_shipped_map(const std::string& filename);
+
+/**
+ * @brief Write a map to a file in the text format read by c_dungeon_map::load_map.
+ */
+void write_map_file(const std::string& filename, const std::vector<std::vector<char>>& map);
+
+/**
+ * @brief Find the first cell holding ch and return its node, throws if there is none.
+ */
+Node find_node(const c_graph& graph, const std::vector<std::vector<char>>& map, char ch);
+
+/**
+ * @brief Cost of a cell-by-cell path: 1 per straight step, sqrt(2) per diagonal step.
+ * @note  Throws if a step is not between adjacent cells, enters a wall or cuts a corner.
+ */
+double checked_path_cost(const c_graph& graph, const std::vector<std::pair<int, int>>& path);
@@ -0,0 +1,188 @@
+#include "bench_common.h"
+#include "../c_components.h"
+#include "../c_graph.h"
+#include "../c_thread_pool.h"
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace {
+	// Regions found by breadth-first floods from each unlabelled floor cell in row-major order, which numbers them
+	// the way label_components does.
+	std::vector<std::uint32_t> flood_labels(const c_graph& graph) {
+		const int rows = graph.rows();
+		const int cols = graph.cols();
+		std::vector<std::uint32_t> labels(static_cast<std::size_t>(rows) * cols, NO_COMPONENT);
+		std::vector<int> queue;
+		std::uint32_t next = 0;
+		for (int seed = 0; seed < rows * cols; ++seed) {
+			if (!graph.is_walkable(seed) || labels[seed] != NO_COMPONENT) continue;
+			queue.assign(1, seed);
+			labels[seed] = next;
+			for (std::size_t head = 0; head < queue.size(); ++head) {
+				const int x = queue[head] / cols;
+				const int y = queue[head] % cols;
+				auto reach = [&](int nx, int ny) {
+					if (nx < 0 || nx >= rows || ny < 0 || ny >= cols) return;
+					const int neighbor = nx * cols + ny;
+					if (!graph.is_walkable(neighbor) || labels[neighbor] != NO_COMPONENT) return;
+					labels[neighbor] = next;
+					queue.push_back(neighbor);
+				};
+				reach(x - 1, y);
+				reach(x + 1, y);
+				reach(x, y - 1);
+				reach(x, y + 1);
+			}
+			++next;
+		}
+		return labels;
+	}
+
+	// The graph's regions must be the flood's, under some one-to-one renaming after edits.
+	void check_regions(const c_graph& graph, const std::string& label) {
+		const std::vector<std::uint32_t> expected = flood_labels(graph);
+		std::unordered_map<std::uint32_t, std::uint32_t> to_expected, from_expected;
+		for (int i = 0; i < graph.rows() * graph.cols(); ++i) {
+			const std::uint32_t got = graph.component_of(i);
+			if ((got == NO_COMPONENT) != (expected[i] == NO_COMPONENT)) {
+				throw std::runtime_error("A wall and a floor cell are mixed up in the regions on " + label);
+			}
+			if (got == NO_COMPONENT) continue;
+			if (to_expected.emplace(got, expected[i]).first->second != expected[i] ||
+				from_expected.emplace(expected[i], got).first->second != got) {
+				throw std::runtime_error("Regions differ from a flood fill on " + label);
+			}
+		}
+		if (graph.component_count() != from_expected.size()) {
+			throw std::runtime_error("Region count is wrong on " + label);
+		}
+	}
+
+	// A cave cut in two by a wall down the middle, with the floor cells on either side.
+	struct SplitMap {
+		c_graph graph;
+		std::vector<int> left;
+		std::vector<int> right;
+	};
+
+	SplitMap make_split_map(int size) {
+		std::vector<std::vector<char>> rows = make_map(MapKind::OPEN, size, size, 9);
+		for (auto& row : rows) row[size / 2] = 'w';
+		SplitMap split{ c_graph(rows), {}, {} };
+		for (int i = 0; i < size * size; ++i) {
+			if (!split.graph.is_walkable(i)) continue;
+			(i % size < size / 2 ? split.left : split.right).push_back(i);
+		}
+		return split;
+	}
+}
+
+// Region labels checked against flood fills for every map kind and thread count and through random edits, then
+// timed: labelling, edits, and searches between regions against what they cost before they gave up at once.
+BENCHMARK(bm_components) {
+	c_thread_pool pools[] = { c_thread_pool(1), c_thread_pool(2), c_thread_pool(4), c_thread_pool(8) };
+	for (MapKind kind : { MapKind::OPEN, MapKind::CAVE, MapKind::MAZE, MapKind::ROOMS }) {
+		for (const auto& [rows, cols] : { std::pair{ 8, 8 }, { 8, 200 }, { 200, 8 }, { 63, 65 }, { 129, 77 }, { 300, 500 } }) {
+			const std::string label = std::string(map_kind_name(kind)) + " " + std::to_string(rows) + "x" + std::to_string(cols);
+			const std::vector<std::vector<char>> map = make_map(kind, rows, cols, 3);
+			const c_graph serial(map);
+			const std::vector<std::uint32_t> expected = flood_labels(serial);
+			std::vector<std::uint64_t> walkable((static_cast<std::size_t>(rows) * cols + 63) / 64);
+			for (int i = 0; i < rows * cols; ++i) {
+				if (serial.is_walkable(i)) walkable[i >> 6] |= std::uint64_t(1) << (i & 63);
+			}
+			for (c_thread_pool& pool : pools) {
+				ComponentLabels components;
+				label_components(walkable, rows, cols, components, &pool);
+				for (int i = 0; i < rows * cols; ++i) {
+					if ((serial.is_walkable(i) ? components.label_of(i) : NO_COMPONENT) != expected[i]) {
+						throw std::runtime_error("Labels differ from a flood fill on " + label + " with " + std::to_string(pool.size()) + " threads");
+					}
+				}
+			}
+			check_regions(serial, label);
+		}
+	}
+
+	// Random cells turned to walls and back, so regions keep being cut apart and joined up. The long run on a small
+	// maze adds labels faster than regions, so the labels get compacted several times.
+	struct EditRun {
+		MapKind kind;
+		int rows, cols, edits;
+	};
+	for (const EditRun& run : { EditRun{ MapKind::CAVE, 96, 96, 3000 }, EditRun{ MapKind::MAZE, 96, 96, 3000 },
+		EditRun{ MapKind::CAVE, 75, 131, 3000 }, EditRun{ MapKind::MAZE, 24, 40, 20000 } }) {
+		const std::string label = std::string(map_kind_name(run.kind)) + " " + std::to_string(run.rows) + "x" + std::to_string(run.cols) + " edits";
+		c_graph graph(make_map(run.kind, run.rows, run.cols, 5));
+		std::mt19937 rng(21);
+		std::uniform_int_distribution<int> cell(0, run.rows * run.cols - 1);
+		for (int edit = 0; edit < run.edits; ++edit) {
+			const int index = cell(rng);
+			graph.set_walkable(index / run.cols, index % run.cols, !graph.is_walkable(index));
+			if (edit % 25 == 0) check_regions(graph, label + " " + std::to_string(edit));
+		}
+		check_regions(graph, label);
+	}
+	const int size = std::min(4096, max_map_size());
+	const std::string label = std::to_string(size) + "x" + std::to_string(size);
+	const c_graph cave(make_map(MapKind::CAVE, size, size, 7));
+	std::vector<std::uint64_t> walkable((static_cast<std::size_t>(size) * size + 63) / 64);
+	for (int i = 0; i < size * size; ++i) {
+		if (cave.is_walkable(i)) walkable[i >> 6] |= std::uint64_t(1) << (i & 63);
+	}
+	ComponentLabels components;
+	run_timed("label_components/" + label + "/serial", [&] { label_components(walkable, size, size, components); });
+	for (c_thread_pool& pool : pools) {
+		run_timed("label_components/" + label + "/threads:" + std::to_string(pool.size()), [&] {
+			label_components(walkable, size, size, components, &pool);
+		});
+	}
+	std::cout << label << " cave regions=" << components.count << '\n';
+
+	// Knocking walls down and putting them back on a maze, where most walls cut a corridor. Then on open maps of
+	// growing size, where an edit's cost should not grow with the map.
+	const int maze_size = std::min(1024, max_map_size());
+	c_graph maze(make_map(MapKind::MAZE, maze_size, maze_size, 13));
+	auto toggle_cells = [](c_graph& graph, int size, const std::string& kind) {
+		std::vector<int> cells;
+		std::mt19937 rng(5);
+		std::uniform_int_distribution<int> pick(0, size * size - 1);
+		while (cells.size() < 256) cells.push_back(pick(rng));
+		run_timed("set_walkable_toggle/" + kind + " " + std::to_string(size), [&] {
+			for (const int index : cells) graph.set_walkable(index / size, index % size, !graph.is_walkable(index));
+		});
+	};
+	toggle_cells(maze, maze_size, "maze");
+	for (int open_size : { 256, 1024, 4096 }) {
+		if (open_size > max_map_size()) break;
+		c_graph open(make_map(MapKind::OPEN, open_size, open_size, 13));
+		toggle_cells(open, open_size, "open");
+	}
+
+	// Searches from one half of a split map to the other give up at once. Before, each one had to exhaust the start's
+	// half, which a breadth-first traversal of it stands in for.
+	const SplitMap split = make_split_map(std::min(1024, max_map_size()));
+	std::mt19937 query_rng(17);
+	std::uniform_int_distribution<std::size_t> left(0, split.left.size() - 1), right(0, split.right.size() - 1);
+	const int split_cols = split.graph.cols();
+	auto node = [&](int index) { return split.graph.get_node(index / split_cols, index % split_cols); };
+	c_search_state state;
+	c_weighted_search_state weighted;
+	c_bidirectional_search_state bidirectional;
+	c_traversal_state traversal;
+	std::vector<std::pair<int, int>> path;
+	std::size_t found = 0;
+	auto query = [&] { return std::pair{ node(split.left[left(query_rng)]), node(split.right[right(query_rng)]) }; };
+	run_timed("unreachable/a_star", [&] { const auto [start, goal] = query(); found += split.graph.a_star(start, goal, state, path); });
+	run_timed("unreachable/a_star8", [&] { const auto [start, goal] = query(); found += split.graph.a_star<Neighbourhood8>(start, goal, state, path); });
+	run_timed("unreachable/jps", [&] { const auto [start, goal] = query(); found += split.graph.jps(start, goal, state, path); });
+	run_timed("unreachable/bidirectional", [&] { const auto [start, goal] = query(); found += split.graph.bidirectional_a_star(start, goal, bidirectional, path); });
+	run_timed("unreachable/weighted", [&] { const auto [start, goal] = query(); found += split.graph.weighted_a_star(start, goal, weighted, path); });
+	run_timed("exhaust_start_half/bfs", [&] { found += split.graph.bfs(query().first, traversal, [](int) { return true; }) == 0; });
+	if (found != 0) {
+		throw std::runtime_error("A search crossed the wall splitting the map");
+	}
+}
@@ -0,0 +1,117 @@
+#include "bench_common.h"
+#include "../c_dstar_lite.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+namespace {
+	using clock_type = std::chrono::steady_clock;
+
+	double seconds_since(clock_type::time_point begin) {
+		return std::chrono::duration<double>(clock_type::now() - begin).count();
+	}
+
+	// An agent walks from 's' to 'x' while cells flip, replanning after every edit. Half the edits land
+	// on the path ahead of the agent, the other half anywhere on the map.
+	void replan_on_map(int size, int edit_count) {
+		const std::string label = std::to_string(size) + "x" + std::to_string(size);
+		c_graph graph(make_random_map(size, size, 10, 41));
+		Node start = graph.get_node(1, 1);
+		const Node goal = graph.get_node(size - 2, size - 2);
+
+		c_dstar_lite planner(graph);
+		c_search_state state;
+		planner.reset(start, goal);
+		const auto initial_begin = clock_type::now();
+		planner.compute_path();
+		report("dstar_initial/" + label, 1, seconds_since(initial_begin), "expanded", static_cast<double>(planner.expansions()));
+
+		std::mt19937 rng(9);
+		std::uniform_int_distribution<int> cell(1, size - 2);
+		double dstar_seconds = 0.0;
+		double a_star_seconds = 0.0;
+		std::size_t dstar_expanded = 0;
+		std::vector<std::pair<int, int>> path = planner.path();
+		for (int edit = 0; edit < edit_count; ++edit) {
+			// Step the agent along its path, then flip a cell.
+			if (path.size() > 2) {
+				start = graph.get_node(path[1].first, path[1].second);
+				planner.move_start(start);
+			}
+			int x = cell(rng);
+			int y = cell(rng);
+			if (edit % 2 == 0 && path.size() > 4) {
+				std::tie(x, y) = path[2 + rng() % (path.size() - 3)];
+			}
+			if ((x == start.x && y == start.y) || (x == goal.x && y == goal.y)) continue;
+			planner.set_walkable(x, y, !graph.is_walkable(graph.cell_index(x, y)));
+
+			const auto dstar_begin = clock_type::now();
+			planner.compute_path();
+			path.clear();
+			planner.path(path);
+			dstar_seconds += seconds_since(dstar_begin);
+			dstar_expanded += planner.expansions();
+
+			const auto a_star_begin = clock_type::now();
+			const auto full = graph.a_star(start, goal, state);
+			a_star_seconds += seconds_since(a_star_begin);
+
+			if (full.empty() != path.empty() || (!path.empty() && checked_path_cost(graph, path) != checked_path_cost(graph, full))) {
+				throw std::runtime_error("D* Lite and A* disagree after edit " + std::to_string(edit) + " on " + label);
+			}
+		}
+		report("dstar_replan/" + label, edit_count, dstar_seconds, "expanded/edit", static_cast<double>(dstar_expanded) / edit_count);
+		report("a_star_rerun/" + label, edit_count, a_star_seconds);
+	}
+
+	// The agent jumps around the map and replans with no edits at all, so every replan runs on queue keys left over
+	// from an earlier start.
+	void replan_after_moves(int size, int move_count) {
+		const std::string label = std::to_string(size) + "x" + std::to_string(size);
+		c_graph graph(make_random_map(size, size, 10, 43));
+		const Node goal = graph.get_node(size - 2, size - 2);
+		c_dstar_lite planner(graph);
+		c_search_state state;
+		planner.reset(graph.get_node(1, 1), goal);
+		planner.compute_path();
+
+		std::mt19937 rng(11);
+		std::uniform_int_distribution<int> cell(1, size - 2);
+		double dstar_seconds = 0.0;
+		std::size_t dstar_expanded = 0;
+		std::vector<std::pair<int, int>> path;
+		for (int move = 0; move < move_count; ++move) {
+			const int x = cell(rng);
+			const int y = cell(rng);
+			if (!graph.is_walkable(graph.cell_index(x, y))) continue;
+			const Node start = graph.get_node(x, y);
+			planner.move_start(start);
+
+			const auto dstar_begin = clock_type::now();
+			planner.compute_path();
+			path.clear();
+			planner.path(path);
+			dstar_seconds += seconds_since(dstar_begin);
+			dstar_expanded += planner.expansions();
+
+			const auto full = graph.a_star(start, goal, state);
+			if (full.empty() != path.empty() || (!path.empty() && checked_path_cost(graph, path) != checked_path_cost(graph, full))) {
+				throw std::runtime_error("D* Lite and A* disagree after move " + std::to_string(move) + " on " + label);
+			}
+		}
+		report("dstar_move_only/" + label, move_count, dstar_seconds, "expanded/move", static_cast<double>(dstar_expanded) / move_count);
+	}
+}
+
+// D* Lite replanning after single-cell edits against re-running A* from scratch, with the agent moving between edits.
+BENCHMARK(bm_dstar_lite) {
+	replan_on_map(256, 400);
+	replan_on_map(1024, 200);
+	replan_on_map(2048, 100);
+	replan_after_moves(256, 200);
+	replan_after_moves(1024, 50);
+}
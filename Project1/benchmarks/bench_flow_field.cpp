@@ -0,0 +1,103 @@
+#include "bench_common.h"
+#include "../c_flow_field.h"
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+	std::vector<Node> scatter_agents(const c_graph& graph, std::size_t count, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> row(1, graph.rows() - 2), col(1, graph.cols() - 2);
+		std::vector<Node> agents;
+		while (agents.size() < count) {
+			const Node agent = graph.get_node(row(rng), col(rng));
+			if (!agent.is_wall) agents.push_back(agent);
+		}
+		return agents;
+	}
+
+	void compare_on_map(int size, std::size_t agent_count) {
+		const std::string label = std::to_string(size) + "x" + std::to_string(size) + "/" + std::to_string(agent_count) + "_agents";
+		c_graph graph(make_random_map(size, size, 10, 71));
+		const Node goal = graph.get_node(size - 2, size - 2);
+		const std::vector<Node> agents = scatter_agents(graph, agent_count, 13);
+		c_search_state state;
+		c_traversal_state traversal;
+		c_flow_field field;
+		std::vector<std::pair<int, int>> path;
+
+		// Every agent's field path must be as short as its A* path.
+		field.build(graph, std::span<const Node>(&goal, 1), traversal);
+		for (const Node& agent : agents) {
+			path.clear();
+			const bool found = field.path(agent, path);
+			const auto expected = graph.a_star(agent, goal, state);
+			if (found == expected.empty() || (found && checked_path_cost(graph, path) != checked_path_cost(graph, expected))) {
+				throw std::runtime_error("Flow field path differs from A* on " + label);
+			}
+		}
+
+		run_timed("a_star_per_agent/" + label, [&] {
+			for (const Node& agent : agents) {
+				path.clear();
+				graph.a_star(agent, goal, state, path);
+			}
+		});
+		run_timed("flow_field_build_and_walk/" + label, [&] {
+			field.build(graph, std::span<const Node>(&goal, 1), traversal);
+			for (const Node& agent : agents) {
+				path.clear();
+				field.path(agent, path);
+			}
+		});
+		volatile int sink = 0; // Keeps the lookups from being optimised away.
+		run_timed("flow_field_next_step/" + label, [&] {
+			for (const Node& agent : agents) {
+				sink = sink + field.next_step(agent.x, agent.y).first;
+			}
+		});
+	}
+}
+
+// One flow field towards the exit against one A* per agent, checking every agent's path length matches.
+BENCHMARK(bm_flow_field) {
+	for (int size : { 256, 1024 }) {
+		for (std::size_t agents : { 10, 100, 500 }) {
+			compare_on_map(size, agents);
+		}
+	}
+	compare_on_map(2048, 100);
+
+	// Cache: repeated goals hit, an edit to the graph empties it.
+	c_graph graph(make_random_map(1024, 1024, 10, 71));
+	c_flow_field_cache cache(graph, 4);
+	const Node goal = graph.get_node(1022, 1022);
+	cache.get(goal);
+	run_timed("flow_field_cache_hit/1024x1024", [&] { cache.get(goal); });
+	graph.set_walkable(500, 500, !graph.is_walkable(graph.cell_index(500, 500)));
+	const std::size_t misses = cache.misses();
+	cache.get(goal);
+	if (cache.misses() != misses + 1) {
+		throw std::runtime_error("Flow field cache was not invalidated by a graph edit");
+	}
+	std::cout << "flow_field_cache hits=" << cache.hits() << " misses=" << cache.misses() << '\n';
+
+	// Hits while another thread keeps missing on new goals. Misses build outside the lock, so a hit never waits out
+	// a build. Both threads share the cache, each with its own BFS scratch.
+	c_flow_field_cache shared(graph, 64);
+	shared.get(goal);
+	std::atomic<bool> stop{ false };
+	std::thread builder([&] {
+		c_traversal_state state;
+		for (int x = 1; x < graph.rows() - 1 && !stop; ++x) {
+			if (graph.is_walkable(graph.cell_index(x, 1))) shared.get(graph.get_node(x, 1), state);
+		}
+	});
+	c_traversal_state state;
+	run_timed("flow_field_cache_hit_during_builds/1024x1024", [&] { shared.get(goal, state); });
+	stop = true;
+	builder.join();
+}
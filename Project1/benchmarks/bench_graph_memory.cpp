@@ -0,0 +1,70 @@
+#include "bench_common.h"
+#include "../c_graph.h"
+#include <iostream>
+#include <memory>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+	// Heap bytes currently allocated, 0 where the allocator cannot report it.
+	std::size_t heap_in_use() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+		return mallinfo2().uordblks;
+#else
+		return 0;
+#endif
+	}
+
+	/**
+	 * @brief The original c_graph storage: a Node per cell in per-row vectors, plus a neighbour vector per floor cell.
+	 */
+	struct legacy_graph_storage {
+		std::vector<std::vector<Node>> nodes;
+		std::unordered_map<Node, std::vector<Node>> adj_list;
+
+		explicit legacy_graph_storage(const std::vector<std::vector<char>>& map) {
+			const int rows = static_cast<int>(map.size());
+			const int cols = static_cast<int>(map[0].size());
+			nodes.resize(rows, std::vector<Node>(cols));
+			for (int i = 0; i < rows; ++i) {
+				for (int j = 0; j < cols; ++j) {
+					const char ch = map[i][j];
+					nodes[i][j] = { i, j, (ch >= 'a' && ch <= 'j'), ch == 'w', ch == 's', ch == 'x' };
+				}
+			}
+			const int directions[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+			for (int i = 0; i < rows; ++i) {
+				for (int j = 0; j < cols; ++j) {
+					if (nodes[i][j].is_wall) continue;
+					std::vector<Node> neighbors;
+					for (const auto& dir : directions) {
+						const int x = i + dir[0];
+						const int y = j + dir[1];
+						if (x >= 0 && x < rows && y >= 0 && y < cols) neighbors.push_back(nodes[x][y]);
+					}
+					adj_list[nodes[i][j]] = std::move(neighbors);
+				}
+			}
+		}
+	};
+
+	template <typename Build>
+	std::size_t measure(Build&& build) {
+		const std::size_t before = heap_in_use();
+		auto graph = build();
+		return heap_in_use() - before;
+	}
+}
+
+// Reports heap bytes per million cells for the old and new graph storage on a 1000x1000 map.
+BENCHMARK(bm_graph_memory) {
+	const auto map = make_random_map(1000, 1000, 20, 42);
+	const double millions = 1000.0 * 1000.0 / 1e6;
+	const std::size_t legacy = measure([&] { return std::make_unique<legacy_graph_storage>(map); });
+	const std::size_t packed = measure([&] { return std::make_unique<c_graph>(map); });
+	c_graph graph(map);
+	std::cout << "graph_memory/legacy_bytes_per_million_cells   " << static_cast<long long>(legacy / millions) << '\n';
+	std::cout << "graph_memory/packed_bytes_per_million_cells   " << static_cast<long long>(packed / millions)
+		<< " (memory_usage() reports " << static_cast<long long>(graph.memory_usage() / millions) << ")\n";
+}
@@ -0,0 +1,89 @@
+#include "bench_common.h"
+#include "../c_graph.h"
+#include "../c_hpa.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+namespace {
+	// Long queries between random open cells in opposite corners of the map.
+	std::vector<std::pair<Node, Node>> make_queries(const c_graph& graph, int count, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> near_x(1, graph.rows() / 8), near_y(1, graph.cols() / 8);
+		std::vector<std::pair<Node, Node>> queries;
+		while (static_cast<int>(queries.size()) < count) {
+			const Node start = graph.get_node(near_x(rng), near_y(rng));
+			const Node goal = graph.get_node(graph.rows() - 1 - near_x(rng), graph.cols() - 1 - near_y(rng));
+			if (!start.is_wall && !goal.is_wall) queries.emplace_back(start, goal);
+		}
+		return queries;
+	}
+
+	void compare_on_map(int size, int wall_percent) {
+		const std::string label = std::to_string(size) + "x" + std::to_string(size);
+		const c_graph graph(make_random_map(size, size, wall_percent, 31));
+
+		const auto build_begin = std::chrono::steady_clock::now();
+		c_hpa_graph hpa(graph);
+		const double build_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - build_begin).count();
+		report("hpa_build/" + label, 1, build_seconds, "entrances", static_cast<double>(hpa.abstract_node_count()));
+		std::cout << "hpa_memory/" << label << " bytes=" << hpa.memory_usage() << " bytes_per_cell="
+			<< std::fixed << std::setprecision(2) << static_cast<double>(hpa.memory_usage()) / (static_cast<double>(size) * size) << std::defaultfloat << '\n';
+
+		// Optimality loss: total HPA* path length over total A* path length, across all queries with a path.
+		const auto queries = make_queries(graph, 20, 7);
+		c_search_state state;
+		double a_star_total = 0.0;
+		double hpa_total = 0.0;
+		for (const auto& [start, goal] : queries) {
+			const auto exact = graph.a_star(start, goal, state);
+			const auto approximate = hpa.find_path(start, goal);
+			if (exact.empty() != approximate.empty()) {
+				throw std::runtime_error("HPA* and A* disagree on whether a path exists on " + label);
+			}
+			if (exact.empty()) continue;
+			a_star_total += checked_path_cost(graph, exact);
+			hpa_total += checked_path_cost(graph, approximate);
+		}
+		std::cout << "hpa/" << label << " path length hpa/a_star=" << std::fixed << std::setprecision(5) << hpa_total / a_star_total
+			<< std::defaultfloat << " over " << queries.size() << " queries\n";
+
+		std::size_t next = 0;
+		run_timed("a_star/" + label, [&] { const auto& q = queries[next++ % queries.size()]; graph.a_star(q.first, q.second, state); });
+		next = 0;
+		run_timed("hpa/" + label, [&] { const auto& q = queries[next++ % queries.size()]; hpa.find_path(q.first, q.second); });
+	}
+}
+
+// HPA* against flat A* on large generated maps: path length lost, time per long query, and per-edit rebuild cost.
+BENCHMARK(bm_hpa) {
+	for (int size : { 1024, 2048, 4096 }) {
+		compare_on_map(size, 10);
+	}
+
+	// Toggle random interior cells and rebuild only the clusters they touch, checking paths stay valid.
+	c_graph graph(make_random_map(2048, 2048, 10, 31));
+	c_hpa_graph hpa(graph);
+	const Node start = graph.get_node(1, 1); // The generator puts 's' here, edits stay clear of it and the goal.
+	const Node goal = graph.get_node(2046, 2046);
+	std::mt19937 rng(5);
+	std::uniform_int_distribution<int> cell(2, 2045);
+	std::size_t clusters_rebuilt = 0;
+	const std::uint64_t edits = run_timed("hpa_edit/2048x2048", [&] {
+		const int x = cell(rng);
+		const int y = cell(rng);
+		graph.set_walkable(x, y, !graph.is_walkable(graph.cell_index(x, y)));
+		clusters_rebuilt += hpa.on_cell_changed(x, y);
+	});
+	std::cout << "hpa_edit/2048x2048 clusters rebuilt per edit: " << static_cast<double>(clusters_rebuilt) / edits << '\n';
+	c_search_state state;
+	const auto exact = graph.a_star(start, goal, state);
+	const auto approximate = hpa.find_path(start, goal);
+	if (exact.empty() != approximate.empty()) {
+		throw std::runtime_error("HPA* and A* disagree on whether a path exists after edits");
+	}
+	if (!approximate.empty()) checked_path_cost(graph, approximate);
+	run_timed("hpa_full_rebuild/2048x2048", [&] { c_hpa_graph rebuilt(graph); });
+}
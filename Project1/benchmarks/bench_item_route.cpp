@@ -0,0 +1,69 @@
+#include "bench_common.h"
+#include "../c_item_route.h"
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	// Start, ten items scattered over the open cells, then the exit, as cell indices.
+	std::vector<int> scatter_points(const c_graph& graph, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> row(1, graph.rows() - 2), col(1, graph.cols() - 2);
+		std::vector<int> points = { graph.cell_index(1, 1) };
+		while (points.size() < 11) {
+			const int cell = graph.cell_index(row(rng), col(rng));
+			if (graph.is_walkable(cell)) points.push_back(cell);
+		}
+		points.push_back(graph.cell_index(graph.rows() - 2, graph.cols() - 2));
+		return points;
+	}
+
+	void matrix_on_map(int size) {
+		const std::string label = std::to_string(size) + "x" + std::to_string(size);
+		const c_graph graph(make_random_map(size, size, 10, 51));
+		const std::vector<int> points = scatter_points(graph, 3);
+		auto node = [&](int cell) { return graph.get_node(cell / graph.cols(), cell % graph.cols()); };
+
+		// The multi-target searches must agree with one A* per pair.
+		c_item_route_planner planner(graph);
+		c_search_state state;
+		planner.build_distances(points);
+		for (std::size_t i = 0; i < points.size(); ++i) {
+			for (std::size_t j = i + 1; j < points.size(); ++j) {
+				const auto path = graph.a_star(node(points[i]), node(points[j]), state);
+				const int expected = path.empty() ? -1 : static_cast<int>(path.size()) - 1;
+				if (planner.distance(i, j) != expected || planner.distance(j, i) != expected) {
+					throw std::runtime_error("Item route distance differs from A* on " + label);
+				}
+			}
+		}
+
+		run_timed("item_matrix_bfs/" + label, [&] { planner.build_distances(points); });
+		run_timed("item_matrix_pairwise_a_star/" + label, [&] {
+			for (std::size_t i = 0; i < points.size(); ++i) {
+				for (std::size_t j = i + 1; j < points.size(); ++j) {
+					graph.a_star(node(points[i]), node(points[j]), state);
+				}
+			}
+		});
+
+		std::vector<Node> items;
+		for (std::size_t i = 1; i + 1 < points.size(); ++i) {
+			items.push_back(node(points[i]));
+		}
+		const ItemRoute route = planner.plan(node(points.front()), node(points.back()), items);
+		if (!route.found || checked_path_cost(graph, route.path) != route.length) {
+			throw std::runtime_error("Item route path does not match its length on " + label);
+		}
+		std::cout << "item_route/" << label << " tour length=" << route.length << '\n';
+		run_timed("item_route_plan/" + label, [&] { planner.plan(node(points.front()), node(points.back()), items); });
+	}
+}
+
+// Distance matrix for the start, ten items and the exit: one multi-target BFS per point against one A* per pair.
+BENCHMARK(bm_item_route) {
+	for (int size : { 256, 1024, 4096 }) {
+		matrix_on_map(size);
+	}
+}
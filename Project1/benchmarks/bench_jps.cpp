@@ -0,0 +1,38 @@
+#include "bench_common.h"
+#include "../c_graph.h"
+#include <iostream>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+	void compare_on_map(const std::string& label, const std::vector<std::vector<char>>& map) {
+		const c_graph graph(map);
+		c_search_state state;
+		const Node start = find_node(graph, map, 's');
+		const Node goal = find_node(graph, map, 'x');
+
+		// JPS moves like the 8-way neighbourhood, so both must find paths of the same cost.
+		const double a_star_cost = checked_path_cost(graph, graph.a_star<Neighbourhood8>(start, goal, state));
+		const std::size_t a_star_expanded = state.expansions();
+		const double jps_cost = checked_path_cost(graph, graph.jps(start, goal, state));
+		const std::size_t jps_expanded = state.expansions();
+		if (std::abs(a_star_cost - jps_cost) > 1e-9) {
+			throw std::runtime_error("JPS path cost differs from 8-way A* on " + label);
+		}
+		std::cout << "jps/" << label << " expanded a_star8=" << a_star_expanded << " jps=" << jps_expanded
+			<< "  path cost=" << jps_cost << '\n';
+		run_timed("a_star8/" + label, [&] { graph.a_star<Neighbourhood8>(start, goal, state); });
+		run_timed("jps/" + label, [&] { graph.jps(start, goal, state); });
+	}
+}
+
+// Expanded nodes and time per query for JPS against 8-way A*, on the shipped maps and large generated maps.
+BENCHMARK(bm_jps) {
+	for (const char* name : { "ValidMap1", "ValidMap2", "ValidMapNoPath1", "ValidMapNoPath2" }) {
+		compare_on_map(name, load_shipped_map(std::string("maps/") + name + ".txt"));
+	}
+	for (int size : { 512, 2048 }) {
+		compare_on_map(std::to_string(size) + "x" + std::to_string(size) + "_open", make_random_map(size, size, 0, 21));
+	}
+	compare_on_map("1024x1024_cluttered", make_random_map(1024, 1024, 10, 21));
+}
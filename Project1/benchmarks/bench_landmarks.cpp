@@ -0,0 +1,117 @@
+#include "bench_common.h"
+#include "../c_landmarks.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	struct Query {
+		Node start;
+		Node goal;
+	};
+
+	std::vector<Query> random_queries(const c_graph& graph, std::size_t count, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> row(1, graph.rows() - 2), col(1, graph.cols() - 2);
+		std::vector<Query> queries;
+		while (queries.size() < count) {
+			const Node start = graph.get_node(row(rng), col(rng));
+			const Node goal = graph.get_node(row(rng), col(rng));
+			if (!start.is_wall && !goal.is_wall) queries.push_back({ start, goal });
+		}
+		return queries;
+	}
+
+	double seconds_since(std::chrono::steady_clock::time_point begin) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	}
+
+	// Plain 4-way A* against A* with 4, 8 and 16 landmarks on one map. Every landmark path must be as
+	// short as the plain one; reports preprocessing time, table size, expansions and time per query.
+	void compare_on_map(const std::string& label, const c_graph& graph) {
+		const std::vector<Query> queries = random_queries(graph, 20, 3);
+		c_search_state state;
+		std::vector<std::pair<int, int>> path;
+
+		std::vector<double> expected_costs;
+		std::size_t plain_expanded = 0;
+		for (const Query& query : queries) {
+			const auto plain = graph.a_star(query.start, query.goal, state);
+			expected_costs.push_back(plain.empty() ? -1.0 : checked_path_cost(graph, plain));
+			plain_expanded += state.expansions();
+		}
+		std::cout << "a_star/" << label << " expanded per query=" << plain_expanded / queries.size() << '\n';
+		run_timed("a_star/" + label, [&] {
+			for (const Query& query : queries) {
+				path.clear();
+				graph.a_star(query.start, query.goal, state, path);
+			}
+		});
+
+		for (int count : { 4, 8, 16 }) {
+			const std::string name = "alt" + std::to_string(count) + "/" + label;
+			const auto begin = std::chrono::steady_clock::now();
+			const c_landmarks landmarks(graph, count);
+			std::cout << name << " preprocess=" << seconds_since(begin) * 1e3 << " ms table="
+				<< landmarks.memory_usage() / (1024 * 1024) << " MiB\n";
+
+			std::size_t expanded = 0;
+			for (std::size_t i = 0; i < queries.size(); ++i) {
+				const auto guided = graph.a_star(queries[i].start, queries[i].goal, landmarks, state);
+				if ((guided.empty() ? -1.0 : checked_path_cost(graph, guided)) != expected_costs[i]) {
+					throw std::runtime_error("Landmark path is not the shortest on " + label);
+				}
+				expanded += state.expansions();
+			}
+			std::cout << name << " expanded per query=" << expanded / queries.size() << '\n';
+			run_timed(name, [&] {
+				for (const Query& query : queries) {
+					path.clear();
+					graph.a_star(query.start, query.goal, landmarks, state, path);
+				}
+			});
+		}
+	}
+}
+
+// Landmark (ALT) preprocessing against the Manhattan heuristic, 20 random queries per map. Mazes are
+// where Manhattan distance underestimates worst; the open map shows the gain is smaller without walls to route around.
+BENCHMARK(bm_landmarks) {
+	compare_on_map("maze_1024x1024", c_graph(make_maze_map(1024, 1024, 5, 17)));
+	compare_on_map("maze_2048x2048", c_graph(make_maze_map(2048, 2048, 5, 17)));
+	compare_on_map("open_1024x1024", c_graph(make_random_map(1024, 1024, 10, 17)));
+
+	// Saving next to the map and loading back must give the same tables, and a stale file must be rebuilt.
+	const std::string map_file = "bench_landmarks_map.txt";
+	const auto maze = make_maze_map(1024, 1024, 5, 23);
+	c_graph graph(maze);
+	std::remove(c_landmarks::file_for_map(map_file).c_str());
+	auto begin = std::chrono::steady_clock::now();
+	const c_landmarks built = c_landmarks::load_or_build(map_file, graph, 8);
+	std::cout << "landmarks_build_and_save/maze_1024x1024 " << seconds_since(begin) * 1e3 << " ms\n";
+	begin = std::chrono::steady_clock::now();
+	const c_landmarks loaded = c_landmarks::load_or_build(map_file, graph, 8);
+	std::cout << "landmarks_load/maze_1024x1024 " << seconds_since(begin) * 1e3 << " ms\n";
+	for (int index = 0; index < graph.rows() * graph.cols(); index += 997) {
+		for (int k = 0; k < built.landmark_count(); ++k) {
+			if (built.distances(index)[k] != loaded.distances(index)[k]) {
+				throw std::runtime_error("Loaded landmark tables differ from the saved ones");
+			}
+		}
+	}
+	graph.set_walkable(1, 1, !graph.is_walkable(graph.cell_index(1, 1)));
+	bool rejected = false;
+	try {
+		c_landmarks::load(c_landmarks::file_for_map(map_file), graph);
+	}
+	catch (const std::runtime_error&) {
+		rejected = true;
+	}
+	std::remove(c_landmarks::file_for_map(map_file).c_str());
+	if (!rejected) {
+		throw std::runtime_error("Landmark file was accepted for an edited map");
+	}
+}
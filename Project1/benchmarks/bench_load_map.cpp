@@ -0,0 +1,14 @@
+#include "bench_common.h"
+#include "../c_dungeon_map.h"
+#include <cstdio>
+
+BENCHMARK(bm_load_map) {
+	for (int size : { 20, 1024, 4096 }) {
+		const std::string filename = "bench_load_map_" + std::to_string(size) + ".txt";
+		write_map_file(filename, make_random_map(size, size, 20, 99));
+		c_dungeon_map map;
+		const std::string label = std::to_string(size) + "x" + std::to_string(size);
+		run_timed("load_map/" + label, [&] { map.load_map(filename); });
+		std::remove(filename.c_str());
+	}
+}
@@ -0,0 +1,434 @@
+#include "bench_common.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <cstdlib>
+#include <algorithm>
+#include <ctime>
+#include <thread>
+
+namespace {
+	std::vector<std::pair<std::string, std::function<void()>>>& registry() {
+		static std::vector<std::pair<std::string, std::function<void()>>> benchmarks;
+		return benchmarks;
+	}
+
+	struct Result { // One report line, kept for the --json/--csv output.
+		std::string name;
+		std::uint64_t iterations;
+		double ns_per_iteration;
+		std::string counter_name;
+		double counter_value;
+	};
+
+	std::vector<Result>& results() {
+		static std::vector<Result> reported;
+		return reported;
+	}
+
+	int max_size = 8192; // See max_map_size.
+
+	std::string json_escape(const std::string& text) {
+		std::string escaped;
+		for (char ch : text) {
+			if (ch == '"' || ch == '\\') escaped += '\\';
+			escaped += ch;
+		}
+		return escaped;
+	}
+
+	// Same layout as Google Benchmark's --benchmark_out JSON, so the same tooling can track it over time.
+	void write_json(const std::string& filename, const std::string& executable) {
+		std::ofstream file(filename);
+		if (!file.is_open()) {
+			throw std::runtime_error("Unable to write " + filename);
+		}
+		const std::time_t now = std::time(nullptr);
+		char date[32];
+		std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+		file << std::setprecision(12);
+		file << "{\n  \"context\": {\n"
+			<< "    \"date\": \"" << date << "\",\n"
+			<< "    \"executable\": \"" << json_escape(executable) << "\",\n"
+			<< "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+			<< "    \"library_build_type\": \"release\",\n"
+#else
+			<< "    \"library_build_type\": \"debug\",\n"
+#endif
+			<< "    \"pathfinding_stats\": " << (SEARCH_STATS_ENABLED ? "true" : "false") << "\n"
+			<< "  },\n  \"benchmarks\": [";
+		for (std::size_t i = 0; i < results().size(); ++i) {
+			const Result& result = results()[i];
+			file << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << json_escape(result.name)
+				<< "\", \"run_name\": \"" << json_escape(result.name) << "\", \"run_type\": \"iteration\""
+				<< ", \"iterations\": " << result.iterations << ", \"real_time\": " << result.ns_per_iteration
+				<< ", \"time_unit\": \"ns\"";
+			if (!result.counter_name.empty()) {
+				file << ", \"" << json_escape(result.counter_name) << "\": " << result.counter_value;
+			}
+			file << '}';
+		}
+		file << "\n  ]\n}\n";
+	}
+
+	void write_csv(const std::string& filename) {
+		std::ofstream file(filename);
+		if (!file.is_open()) {
+			throw std::runtime_error("Unable to write " + filename);
+		}
+		file << std::setprecision(12) << "name,iterations,real_time_ns,counter_name,counter_value\n";
+		for (const Result& result : results()) {
+			file << result.name << ',' << result.iterations << ',' << result.ns_per_iteration << ','
+				<< result.counter_name << ',' << result.counter_value << '\n';
+		}
+	}
+
+	// Put 's' on the first and 'x' on the last floor cell in row order, and the items 'a'-'j' on random floor cells.
+	void place_features(std::vector<std::vector<char>>& map, std::mt19937& rng) {
+		const int rows = static_cast<int>(map.size());
+		const int cols = static_cast<int>(map[0].size());
+		std::pair<int, int> first(-1, -1), last(-1, -1);
+		for (int i = 0; i < rows; ++i) {
+			for (int j = 0; j < cols; ++j) {
+				if (map[i][j] != '.') continue;
+				if (first.first < 0) first = { i, j };
+				last = { i, j };
+			}
+		}
+		map[first.first][first.second] = 's';
+		map[last.first][last.second] = 'x';
+		std::uniform_int_distribution<int> row(1, rows - 2), col(1, cols - 2);
+		for (int k = 0; k < 10;) {
+			const int i = row(rng), j = col(rng);
+			if (map[i][j] != '.') continue;
+			map[i][j] = static_cast<char>('a' + k++);
+		}
+	}
+}
+
+bool register_benchmark(const std::string& name, std::function<void()> fn) {
+	registry().emplace_back(name, std::move(fn));
+	return true;
+}
+
+void report(const std::string& name, std::uint64_t iterations, double total_seconds,
+	const std::string& counter_name, double counter_value) {
+	results().push_back({ name, iterations, total_seconds * 1e9 / iterations, counter_name, counter_value });
+	std::cout << std::left << std::setw(48) << name
+		<< std::right << std::setw(10) << iterations
+		<< std::setw(16) << std::fixed << std::setprecision(1) << (total_seconds * 1e9 / iterations) << " ns";
+	if (!counter_name.empty()) {
+		std::cout << "  " << counter_name << "=" << std::setprecision(2) << counter_value;
+	}
+	std::cout << std::endl; // Flush so long runs show progress.
+}
+
+int max_map_size() {
+	return max_size;
+}
+
+std::vector<std::vector<char>> make_random_map(int rows, int cols, int wall_percent, std::uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> percent(0, 99);
+	std::vector<std::vector<char>> map(rows, std::vector<char>(cols, '.'));
+	for (int i = 0; i < rows; ++i) {
+		for (int j = 0; j < cols; ++j) {
+			if (i == 0 || j == 0 || i == rows - 1 || j == cols - 1 || percent(rng) < wall_percent) {
+				map[i][j] = 'w';
+			}
+		}
+	}
+	map[1][1] = 's';
+	map[rows - 2][cols - 2] = 'x';
+	for (int k = 0; k < 10 && k + 2 < cols - 1; ++k) {
+		map[1][k + 2] = static_cast<char>('a' + k);
+	}
+	return map;
+}
+
+std::vector<std::vector<char>> make_maze_map(int rows, int cols, int loop_percent, std::uint32_t seed) {
+	// Corridor cells sit on odd coordinates, the walls between them are carved by a depth-first walk.
+	std::mt19937 rng(seed);
+	std::vector<std::vector<char>> map(rows, std::vector<char>(cols, 'w'));
+	const int last_x = (rows - 2) % 2 == 1 ? rows - 2 : rows - 3;
+	const int last_y = (cols - 2) % 2 == 1 ? cols - 2 : cols - 3;
+	const int steps[4][2] = { {-2, 0}, {2, 0}, {0, -2}, {0, 2} };
+	std::vector<std::pair<int, int>> stack = { {1, 1} };
+	map[1][1] = '.';
+	while (!stack.empty()) {
+		const auto [x, y] = stack.back();
+		int options[4];
+		int count = 0;
+		for (int d = 0; d < 4; ++d) {
+			const int nx = x + steps[d][0];
+			const int ny = y + steps[d][1];
+			if (nx >= 1 && nx <= last_x && ny >= 1 && ny <= last_y && map[nx][ny] == 'w') options[count++] = d;
+		}
+		if (count == 0) {
+			stack.pop_back();
+			continue;
+		}
+		const int d = options[std::uniform_int_distribution<int>(0, count - 1)(rng)];
+		map[x + steps[d][0] / 2][y + steps[d][1] / 2] = '.';
+		map[x + steps[d][0]][y + steps[d][1]] = '.';
+		stack.emplace_back(x + steps[d][0], y + steps[d][1]);
+	}
+
+	// Knock through some of the walls left between two corridor cells, giving alternative routes.
+	std::uniform_int_distribution<int> percent(0, 99);
+	for (int i = 1; i <= last_x; ++i) {
+		for (int j = 1; j <= last_y; ++j) {
+			if (map[i][j] != 'w' || (i % 2 == 1) == (j % 2 == 1)) continue;
+			if (percent(rng) < loop_percent) map[i][j] = '.';
+		}
+	}
+	map[1][1] = 's';
+	map[last_x][last_y] = 'x';
+	for (int k = 0; k < 10 && k + 2 <= last_y; ++k) {
+		map[1][k + 2] = static_cast<char>('a' + k);
+	}
+	return map;
+}
+
+std::vector<std::vector<char>> make_cave_map(int rows, int cols, std::uint32_t seed) {
+	if (rows < 8 || cols < 8) {
+		throw std::invalid_argument("Cave maps need at least 8 rows and columns");
+	}
+	// 45% random walls, then four rounds of "a cell is a wall if 5 or more of the 3x3 block around it are".
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> percent(0, 99);
+	const std::size_t cells = static_cast<std::size_t>(rows) * cols;
+	std::vector<char> walls(cells), next(cells);
+	auto border = [&](int i, int j) { return i == 0 || j == 0 || i == rows - 1 || j == cols - 1; };
+	for (int i = 0; i < rows; ++i) {
+		for (int j = 0; j < cols; ++j) {
+			walls[static_cast<std::size_t>(i) * cols + j] = border(i, j) || percent(rng) < 45;
+		}
+	}
+	for (int round = 0; round < 4; ++round) {
+		for (int i = 0; i < rows; ++i) {
+			for (int j = 0; j < cols; ++j) {
+				int count = 0;
+				if (!border(i, j)) {
+					for (int di = -1; di <= 1; ++di) {
+						const char* row = &walls[static_cast<std::size_t>(i + di) * cols + j];
+						count += row[-1] + row[0] + row[1];
+					}
+				}
+				next[static_cast<std::size_t>(i) * cols + j] = border(i, j) || count >= 5;
+			}
+		}
+		walls.swap(next);
+	}
+
+	// Keep the largest open region, every other pocket is filled in so the whole cave is connected.
+	std::vector<int> region(cells, -1);
+	std::vector<std::size_t> stack;
+	int largest = -1;
+	std::size_t largest_size = 0;
+	int regions = 0;
+	for (std::size_t cell = 0; cell < cells; ++cell) {
+		if (walls[cell] || region[cell] >= 0) continue;
+		std::size_t size = 0;
+		region[cell] = regions;
+		stack.push_back(cell);
+		while (!stack.empty()) {
+			const std::size_t current = stack.back();
+			stack.pop_back();
+			++size;
+			for (const std::size_t neighbor : { current - cols, current + cols, current - 1, current + 1 }) {
+				if (!walls[neighbor] && region[neighbor] < 0) { // Borders are walls, so neighbours never leave the map.
+					region[neighbor] = regions;
+					stack.push_back(neighbor);
+				}
+			}
+		}
+		if (size > largest_size) {
+			largest = regions;
+			largest_size = size;
+		}
+		++regions;
+	}
+
+	std::vector<std::vector<char>> map(rows, std::vector<char>(cols, 'w'));
+	for (int i = 0; i < rows; ++i) {
+		for (int j = 0; j < cols; ++j) {
+			const std::size_t cell = static_cast<std::size_t>(i) * cols + j;
+			// Too small a cave to hold the start, exit and items: fall back to an empty room.
+			if (largest_size < 12 ? !border(i, j) : region[cell] == largest) map[i][j] = '.';
+		}
+	}
+	place_features(map, rng);
+	return map;
+}
+
+std::vector<std::vector<char>> make_rooms_map(int rows, int cols, std::uint32_t seed) {
+	if (rows < 8 || cols < 8) {
+		throw std::invalid_argument("Room maps need at least 8 rows and columns");
+	}
+	// One room per 16x16 slot, with at least a wall between the slots.
+	const int slot = 16;
+	const int slot_rows = std::max(1, (rows - 2) / slot);
+	const int slot_cols = std::max(1, (cols - 2) / slot);
+	std::mt19937 rng(seed);
+	auto between = [&](int low, int high) { return std::uniform_int_distribution<int>(low, high)(rng); };
+	std::vector<std::vector<char>> map(rows, std::vector<char>(cols, 'w'));
+	std::vector<std::pair<int, int>> centres;
+	for (int r = 0; r < slot_rows; ++r) {
+		for (int c = 0; c < slot_cols; ++c) {
+			const int top = 1 + r * slot;
+			const int left = 1 + c * slot;
+			const int space_rows = std::min(slot - 1, rows - 1 - top);
+			const int space_cols = std::min(slot - 1, cols - 1 - left);
+			const int height = between(std::max(4, space_rows / 2), space_rows);
+			const int width = between(std::max(4, space_cols / 2), space_cols);
+			const int x = top + between(0, space_rows - height);
+			const int y = left + between(0, space_cols - width);
+			for (int i = x; i < x + height; ++i) {
+				std::fill(map[i].begin() + y, map[i].begin() + y + width, '.');
+			}
+			centres.emplace_back(x + height / 2, y + width / 2);
+		}
+	}
+
+	// An L-shaped corridor from one room's centre to another's, across then down.
+	auto corridor = [&](std::pair<int, int> from, std::pair<int, int> to) {
+		for (int j = std::min(from.second, to.second); j <= std::max(from.second, to.second); ++j) map[from.first][j] = '.';
+		for (int i = std::min(from.first, to.first); i <= std::max(from.first, to.first); ++i) map[i][to.second] = '.';
+	};
+	// Every room joins the one to its right and the first column joins downwards, which connects them all.
+	// A quarter of the other rooms also join downwards, giving loops.
+	for (int r = 0; r < slot_rows; ++r) {
+		for (int c = 0; c < slot_cols; ++c) {
+			const std::pair<int, int> centre = centres[static_cast<std::size_t>(r) * slot_cols + c];
+			if (c + 1 < slot_cols) corridor(centre, centres[static_cast<std::size_t>(r) * slot_cols + c + 1]);
+			if (r + 1 < slot_rows && (c == 0 || between(0, 3) == 0)) corridor(centre, centres[static_cast<std::size_t>(r + 1) * slot_cols + c]);
+		}
+	}
+	place_features(map, rng);
+	return map;
+}
+
+std::vector<std::vector<char>> make_map(MapKind kind, int rows, int cols, std::uint32_t seed) {
+	switch (kind) {
+	case MapKind::OPEN: return make_random_map(rows, cols, 10, seed);
+	case MapKind::CAVE: return make_cave_map(rows, cols, seed);
+	case MapKind::MAZE: return make_maze_map(rows, cols, 5, seed);
+	case MapKind::ROOMS: return make_rooms_map(rows, cols, seed);
+	}
+	throw std::invalid_argument("Unknown map kind");
+}
+
+const char* map_kind_name(MapKind kind) {
+	switch (kind) {
+	case MapKind::OPEN: return "open";
+	case MapKind::CAVE: return "cave";
+	case MapKind::MAZE: return "maze";
+	case MapKind::ROOMS: return "rooms";
+	}
+	return "unknown";
+}
+
+MapKind parse_map_kind(const std::string& name) {
+	for (MapKind kind : { MapKind::OPEN, MapKind::CAVE, MapKind::MAZE, MapKind::ROOMS }) {
+		if (name == map_kind_name(kind)) return kind;
+	}
+	throw std::invalid_argument("Unknown map kind: " + name + " (expected open, cave, maze or rooms)");
+}
+
+void write_map_file(const std::string& filename, const std::vector<std::vector<char>>& map) {
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open()) {
+		throw std::runtime_error("Unable to write " + filename);
+	}
+	for (const auto& row : map) {
+		file.write(row.data(), static_cast<std::streamsize>(row.size()));
+		file.put('\n');
+	}
+}
+
+std::vector<std::vector<char>> load_shipped_map(const std::string& filename) {
+	std::ifstream file(filename);
+	if (!file.is_open()) {
+		throw std::runtime_error("Unable to open " + filename);
+	}
+	std::vector<std::vector<char>> map;
+	std::string line;
+	while (std::getline(file, line)) {
+		std::vector<char> row;
+		for (char ch : line) {
+			if (ch != ' ' && ch != '\r') row.push_back(ch);
+		}
+		if (!row.empty()) map.push_back(std::move(row));
+	}
+	return map;
+}
+
+Node find_node(const c_graph& graph, const std::vector<std::vector<char>>& map, char ch) {
+	for (size_t i = 0; i < map.size(); ++i) {
+		for (size_t j = 0; j < map[i].size(); ++j) {
+			if (map[i][j] == ch) return graph.get_node(static_cast<int>(i), static_cast<int>(j));
+		}
+	}
+	throw std::runtime_error(std::string("Cell not found: ") + ch);
+}
+
+double checked_path_cost(const c_graph& graph, const std::vector<std::pair<int, int>>& path) {
+	double cost = 0.0;
+	for (size_t i = 1; i < path.size(); ++i) {
+		const int dx = path[i].first - path[i - 1].first;
+		const int dy = path[i].second - path[i - 1].second;
+		if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0) || graph.get_node(path[i].first, path[i].second).is_wall) {
+			throw std::runtime_error("Path step is not a move between adjacent floor cells");
+		}
+		if (dx != 0 && dy != 0) {
+			if (graph.get_node(path[i - 1].first + dx, path[i - 1].second).is_wall ||
+				graph.get_node(path[i - 1].first, path[i - 1].second + dy).is_wall) {
+				throw std::runtime_error("Path cuts a corner");
+			}
+			cost += Neighbourhood8::diagonal_cost;
+		} else {
+			cost += 1.0;
+		}
+	}
+	return cost;
+}
+
+// Usage: bench [filter] [--json=<file>] [--csv=<file>] [--max-size=<n>]
+//        Runs every registered benchmark whose name contains the filter, optionally also writing the results to files.
+//        bench --generate <open|cave|maze|rooms> <rows> <cols> <seed> <file>
+//        Writes one generated map in the text format instead.
+int main(int argc, char* argv[]) {
+	try {
+		if (argc == 7 && std::string(argv[1]) == "--generate") {
+			write_map_file(argv[6], make_map(parse_map_kind(argv[2]), std::stoi(argv[3]), std::stoi(argv[4]),
+				static_cast<std::uint32_t>(std::stoul(argv[5]))));
+			return 0;
+		}
+		std::string filter, json_file, csv_file;
+		for (int i = 1; i < argc; ++i) {
+			const std::string arg = argv[i];
+			if (arg.rfind("--json=", 0) == 0) json_file = arg.substr(7);
+			else if (arg.rfind("--csv=", 0) == 0) csv_file = arg.substr(6);
+			else if (arg.rfind("--max-size=", 0) == 0) max_size = std::stoi(arg.substr(11));
+			else filter = arg;
+		}
+		for (const auto& benchmark : registry()) {
+			if (benchmark.first.find(filter) != std::string::npos) {
+				benchmark.second();
+			}
+		}
+		if (!json_file.empty()) write_json(json_file, argv[0]);
+		if (!csv_file.empty()) write_csv(csv_file);
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Benchmark failed: " << e.what() << '\n';
+		return 1;
+	}
+	return 0;
+}
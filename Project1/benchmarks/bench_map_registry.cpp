@@ -0,0 +1,123 @@
+#include "bench_common.h"
+#include "../c_map_registry.h"
+#include "../c_path_server.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+	struct Query {
+		Node start;
+		Node goal;
+	};
+
+	std::vector<Query> random_queries(const c_graph& graph, std::size_t count, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> row(0, graph.rows() - 1), col(0, graph.cols() - 1);
+		std::vector<Query> queries;
+		while (queries.size() < count) {
+			const Node start = graph.get_node(row(rng), col(rng));
+			const Node goal = graph.get_node(row(rng), col(rng));
+			if (!start.is_wall && !goal.is_wall) queries.push_back({ start, goal });
+		}
+		return queries;
+	}
+
+	// Readers look the map up and search it while a writer reloads it as fast as it can, alternating two files with
+	// different walls. Every path is checked against the version it was found on, which must stay alive and unchanged.
+	void run_readers(c_map_registry& registry, const std::string& label, const std::vector<Query>& queries,
+		const std::string files[2], bool reload) {
+		const unsigned reader_count = 4;
+		std::vector<std::vector<double>> latencies(reader_count);
+		std::atomic<bool> reading{ true };
+		std::atomic<std::size_t> reloads{ 0 };
+		std::thread writer([&] {
+			for (std::size_t next = 1; reload && reading; ++next) {
+				registry.load("map", files[next % 2]);
+				++reloads;
+			}
+		});
+
+		std::vector<std::thread> readers;
+		std::vector<std::exception_ptr> failures(reader_count);
+		for (unsigned reader = 0; reader < reader_count; ++reader) {
+			readers.emplace_back([&, reader] {
+				try {
+					c_search_state state;
+					std::vector<std::pair<int, int>> path;
+					for (std::size_t i = reader; i < queries.size(); i += reader_count) {
+						const auto begin = std::chrono::steady_clock::now();
+						const c_map_registry::map_ptr map = registry.find("map");
+						path.clear();
+						const bool found = map->graph.a_star(queries[i].start, queries[i].goal, state, path);
+						latencies[reader].push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count());
+						if (found) checked_path_cost(map->graph, path); // Throws on a step into a wall of this version.
+					}
+				}
+				catch (...) {
+					failures[reader] = std::current_exception();
+				}
+			});
+		}
+		for (std::thread& reader : readers) reader.join();
+		reading = false;
+		writer.join();
+		for (const std::exception_ptr& failure : failures) {
+			if (failure) std::rethrow_exception(failure);
+		}
+
+		std::vector<double> all;
+		for (const auto& times : latencies) all.insert(all.end(), times.begin(), times.end());
+		std::sort(all.begin(), all.end());
+		auto percentile = [&](double fraction) { return all[std::min(all.size() - 1, static_cast<std::size_t>(fraction * static_cast<double>(all.size())))]; };
+		std::cout << label << " queries=" << all.size() << " reloads=" << reloads << " p50=" << percentile(0.5)
+			<< "us p99=" << percentile(0.99) << "us p999=" << percentile(0.999) << "us\n";
+	}
+}
+
+// Registry lookups and searches from several threads while a map is hot-reloaded, then the server's request
+// handling on its own.
+BENCHMARK(bm_map_registry) {
+	const std::string files[2] = { "bench_registry_a.txt", "bench_registry_b.txt" };
+	write_map_file(files[0], make_random_map(256, 256, 20, 1));
+	write_map_file(files[1], make_random_map(256, 256, 20, 2));
+
+	c_map_registry registry;
+	registry.load("map", files[0]);
+	const std::vector<Query> queries = random_queries(registry.find("map")->graph, 4000, 3);
+	run_readers(registry, "registry/steady", queries, files, false);
+	run_readers(registry, "registry/reloading", queries, files, true);
+	if (registry.find("map")->version < 2) {
+		throw std::runtime_error("The map was never reloaded");
+	}
+
+	// A reader holding a version keeps it after a reload and an unload.
+	const c_map_registry::map_ptr held = registry.find("map");
+	registry.load("map", files[0]);
+	registry.unload("map");
+	if (registry.find("map") || held->graph.rows() != 256) {
+		throw std::runtime_error("Unloading lost a version still in use");
+	}
+	registry.load("map", files[0]);
+
+	std::size_t sink = 0;
+	run_timed("registry_find", [&] { for (int i = 0; i < 1000; ++i) sink += registry.find("map")->version; });
+	c_path_server server(registry);
+	c_path_server::Session session;
+	const Query& query = queries.front();
+	const std::string request = "path map " + std::to_string(query.start.x) + ' ' + std::to_string(query.start.y) + ' ' +
+		std::to_string(query.goal.x) + ' ' + std::to_string(query.goal.y);
+	if (server.handle(request, session).rfind("error", 0) == 0) {
+		throw std::runtime_error("The server rejected " + request);
+	}
+	run_timed("server_handle_path", [&] { sink += server.handle(request, session).size(); });
+	std::cout << "sink=" << sink % 2 << '\n'; // Keeps the timed loops from being optimised away.
+	std::remove(files[0].c_str());
+	std::remove(files[1].c_str());
+}
@@ -0,0 +1,92 @@
+#include "bench_common.h"
+#include "../c_dungeon_map.h"
+#include "../c_map_scan.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+namespace {
+	bool same_scan(const MapScan& a, const MapScan& b) {
+		return a.walkable == b.walkable && a.specials == b.specials && a.invalid_count == b.invalid_count &&
+			(a.invalid_count == 0 || a.first_invalid == b.first_invalid) && a.has_terrain == b.has_terrain;
+	}
+
+	// Cells drawn from every class, invalid characters and specials included, so every branch of the scan runs.
+	std::vector<char> random_cells(std::size_t count, std::uint32_t seed) {
+		const char alphabet[] = "w.w.w.rm~sxabcdefghijp?Z \x80";
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> pick(0, static_cast<int>(sizeof(alphabet)) - 2), common(0, 9);
+		std::vector<char> cells(count);
+		for (char& cell : cells) cell = common(rng) < 8 ? "w."[common(rng) & 1] : alphabet[pick(rng)];
+		return cells;
+	}
+
+	// What verify_map, get_start_node and get_end_node did before the scan: a chain of comparisons per cell,
+	// an unordered_set of items, then a full search of the cells for the start and another for the exit.
+	std::size_t legacy_verify(const std::vector<char>& map) {
+		int start_count = 0, end_count = 0;
+		std::unordered_set<char> items;
+		for (char cell : map) {
+			if (cell == 's') start_count++;
+			if (cell == 'x') end_count++;
+			if (cell >= 'a' && cell <= 'j') items.insert(cell);
+			if (cell != 'w' && cell != '.' && cell != 's' && cell != 'x' && (cell < 'a' || cell > 'j')) {
+				throw std::runtime_error("Invalid character in map");
+			}
+		}
+		if (start_count != 1 || end_count != 1 || items.size() != 10) throw std::runtime_error("Bad counts");
+		return static_cast<std::size_t>(std::find(map.begin(), map.end(), 's') - map.begin()) +
+			static_cast<std::size_t>(std::find(map.begin(), map.end(), 'x') - map.begin());
+	}
+}
+
+// scan_map checked against its scalar path on awkward buffers, then timed against the scalar path and the
+// old per-character verify_map plus start/exit lookups, and load_map end to end with the cached positions.
+BENCHMARK(bm_map_scan) {
+	std::cout << "scan_map backend=" << scan_map_backend() << '\n';
+	MapScan fast, reference;
+	for (std::size_t count : { 0, 1, 63, 64, 65, 127, 1000, 4097, 100003 }) {
+		const std::vector<char> cells = random_cells(count, static_cast<std::uint32_t>(count) + 1);
+		scan_map(cells.data(), cells.size(), fast);
+		scan_map_scalar(cells.data(), cells.size(), reference);
+		if (!same_scan(fast, reference)) {
+			throw std::runtime_error("scan_map differs from the scalar scan for " + std::to_string(count) + " cells");
+		}
+		// Spot check the reference itself against the cells.
+		for (std::size_t i = 0; i < count; ++i) {
+			if (((reference.walkable[i / 64] >> (i % 64)) & 1) != (cells[i] != 'w' ? 1u : 0u)) {
+				throw std::runtime_error("Scalar scan walkability is wrong");
+			}
+		}
+	}
+
+	for (int size : { 1024, 4096 }) {
+		const std::string label = std::to_string(size) + "x" + std::to_string(size);
+		const std::vector<std::vector<char>> rows = make_random_map(size, size, 20, 7);
+		std::vector<char> map;
+		for (const auto& row : rows) map.insert(map.end(), row.begin(), row.end());
+
+		std::size_t sink = 0;
+		run_timed("legacy_verify/" + label, [&] { sink += legacy_verify(map); });
+		run_timed("scan_map_scalar/" + label, [&] { scan_map_scalar(map.data(), map.size(), reference); });
+		run_timed("scan_map/" + label, [&] { scan_map(map.data(), map.size(), fast); });
+		if (!same_scan(fast, reference) || fast.specials.size() != 12) {
+			throw std::runtime_error("scan_map missed cells on " + label);
+		}
+
+		const std::string filename = "bench_map_scan_" + std::to_string(size) + ".txt";
+		write_map_file(filename, rows);
+		c_dungeon_map dungeon;
+		run_timed("load_map/" + label, [&] { dungeon.load_map(filename); });
+		std::remove(filename.c_str());
+		run_timed("get_start_and_end/" + label, [&] {
+			for (int i = 0; i < 1000; ++i) sink += static_cast<std::size_t>(dungeon.get_start_node().first + dungeon.get_end_node().second);
+		});
+		run_timed("to_graph/" + label, [&] { const c_graph graph = dungeon.to_graph(); sink += graph.rows(); });
+		std::cout << "sink=" << sink % 2 << '\n'; // Keeps the timed loops from being optimised away.
+	}
+}
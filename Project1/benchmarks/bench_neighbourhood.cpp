@@ -0,0 +1,39 @@
+#include "bench_common.h"
+#include "../c_graph.h"
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+	// Runs both neighbourhoods on one map, checks the paths and reports expansions and time per query.
+	void compare_on_map(const std::string& label, const std::vector<std::vector<char>>& map) {
+		const c_graph graph(map);
+		c_search_state state;
+		const Node start = find_node(graph, map, 's');
+		const Node goal = find_node(graph, map, 'x');
+
+		const auto path4 = graph.a_star<Neighbourhood4>(start, goal, state);
+		const std::size_t expanded4 = state.expansions();
+		const auto path8 = graph.a_star<Neighbourhood8>(start, goal, state);
+		const std::size_t expanded8 = state.expansions();
+		if (path4.empty() != path8.empty()) {
+			throw std::runtime_error("Neighbourhoods disagree on whether a path exists on " + label);
+		}
+		const double cost4 = checked_path_cost(graph, path4);
+		const double cost8 = checked_path_cost(graph, path8);
+		if (cost8 > cost4) {
+			throw std::runtime_error("8-way path is longer than the 4-way path on " + label);
+		}
+		std::cout << "neighbourhood/" << label << " expanded 4-way=" << expanded4 << " 8-way=" << expanded8
+			<< "  cost 4-way=" << cost4 << " 8-way=" << cost8 << '\n';
+		run_timed("a_star4/" + label, [&] { graph.a_star<Neighbourhood4>(start, goal, state); });
+		run_timed("a_star8/" + label, [&] { graph.a_star<Neighbourhood8>(start, goal, state); });
+	}
+}
+
+// 4-way Manhattan against 8-way octile A*. The path checks stand in for tests on ValidMap1/ValidMap2.
+BENCHMARK(bm_neighbourhood) {
+	for (const char* name : { "ValidMap1", "ValidMap2", "ValidMapNoPath1", "ValidMapNoPath2" }) {
+		compare_on_map(name, load_shipped_map(std::string("maps/") + name + ".txt"));
+	}
+	compare_on_map("1024x1024", make_random_map(1024, 1024, 20, 8));
+}
@@ -0,0 +1,119 @@
+#include "bench_common.h"
+#include "../c_graph.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	struct Query {
+		Node start;
+		Node goal;
+	};
+
+	std::vector<Query> random_queries(const c_graph& graph, std::size_t count, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> row(1, graph.rows() - 2), col(1, graph.cols() - 2);
+		std::vector<Query> queries;
+		while (queries.size() < count) {
+			const Node start = graph.get_node(row(rng), col(rng));
+			const Node goal = graph.get_node(row(rng), col(rng));
+			if (!start.is_wall && !goal.is_wall) queries.push_back({ start, goal });
+		}
+		return queries;
+	}
+
+	// Runs every query with one back end, checks each path cost against the binary heap's and reports
+	// time per query with the total expansions and stale pops. A path may cost more by tolerance per unit of cost.
+	template <typename Neighbourhood, typename OpenSet>
+	void run_back_end(const std::string& label, const c_graph& graph, const std::vector<Query>& queries,
+		const std::vector<double>& expected_costs, double tolerance) {
+		c_basic_search_state<OpenSet> state;
+		std::vector<std::pair<int, int>> path;
+		std::size_t expansions = 0;
+		std::size_t stale_pops = 0;
+		for (std::size_t i = 0; i < queries.size(); ++i) {
+			path.clear();
+			const bool found = graph.a_star<Neighbourhood>(queries[i].start, queries[i].goal, state, path);
+			const double cost = found ? checked_path_cost(graph, path) : -1.0;
+			const bool same_result = (cost < 0) == (expected_costs[i] < 0);
+			if (!same_result || cost < expected_costs[i] - 1e-9 || cost > expected_costs[i] * (1.0 + tolerance) + 1e-9) {
+				throw std::runtime_error("Open set back end changed a path cost on " + label);
+			}
+			expansions += state.expansions();
+			stale_pops += state.stale_pops();
+		}
+
+		const std::uint64_t iterations = run_timed(label, [&] {
+			for (const Query& query : queries) {
+				path.clear();
+				graph.a_star<Neighbourhood>(query.start, query.goal, state, path);
+			}
+		});
+		std::cout << label << " queries=" << queries.size() << " iterations=" << iterations
+			<< " expanded=" << expansions << " stale_pops=" << stale_pops << '\n';
+	}
+
+	template <typename Neighbourhood>
+	void compare_on_map(int size, const char* neighbourhood_name, double bucket_tolerance) {
+		const std::string label = std::string(neighbourhood_name) + "/" + std::to_string(size) + "x" + std::to_string(size);
+		const c_graph graph(make_random_map(size, size, 10, 29));
+		const std::vector<Query> queries = random_queries(graph, 20, 5);
+
+		// The binary heap is the reference every other back end must match.
+		c_search_state reference;
+		std::vector<double> expected_costs;
+		for (const Query& query : queries) {
+			const auto path = graph.a_star<Neighbourhood>(query.start, query.goal, reference);
+			expected_costs.push_back(path.empty() ? -1.0 : checked_path_cost(graph, path));
+		}
+
+		run_back_end<Neighbourhood, c_binary_heap_open_set>("open_set_binary_heap/" + label, graph, queries, expected_costs, 1e-9);
+		run_back_end<Neighbourhood, c_indexed_heap_open_set>("open_set_indexed_4ary/" + label, graph, queries, expected_costs, 1e-9);
+		run_back_end<Neighbourhood, c_bucket_open_set>("open_set_bucket/" + label, graph, queries, expected_costs, bucket_tolerance);
+	}
+
+	// The bucket queue's 8-way bound over many queries: no path may cost more than the shortest by its step count
+	// over KEY_SCALE. Reports how far over the shortest the worst one was.
+	void check_bucket_bound(int size, std::size_t count) {
+		const std::string label = "8way/" + std::to_string(size) + "x" + std::to_string(size);
+		const c_graph graph(make_random_map(size, size, 10, 31));
+		c_search_state reference;
+		c_bucket_search_state bucket;
+		std::vector<std::pair<int, int>> path;
+		std::size_t longer = 0;
+		double worst = 0.0; // Largest extra cost per step.
+		for (const Query& query : random_queries(graph, count, 41)) {
+			path.clear();
+			if (!graph.a_star<Neighbourhood8>(query.start, query.goal, reference, path)) continue;
+			const double shortest = checked_path_cost(graph, path);
+			path.clear();
+			graph.a_star<Neighbourhood8>(query.start, query.goal, bucket, path);
+			const double cost = checked_path_cost(graph, path);
+			const double steps = static_cast<double>(path.size() - 1);
+			if (cost < shortest - 1e-9 || cost > shortest + steps / c_bucket_open_set::KEY_SCALE + 1e-9) {
+				throw std::runtime_error("Bucket queue path is further from the shortest than its bound on " + label);
+			}
+			if (cost > shortest + 1e-9) {
+				++longer;
+				worst = std::max(worst, (cost - shortest) / std::max(steps, 1.0));
+			}
+		}
+		std::cout << "open_set_bucket_bound/" << label << " queries=" << count << " longer=" << longer
+			<< " worst_extra_per_step=" << std::setprecision(3) << worst * c_bucket_open_set::KEY_SCALE << "/1024 bound=1/1024\n";
+	}
+}
+
+// Binary heap, indexed 4-ary heap with decrease-key and bucket queue as a_star's open set, on 10% wall
+// maps. 4-way costs are integers so every back end must give the same cost; the bucket queue rounds
+// 8-way scores to 1/1024, so its 8-way paths may be longer by up to 1/1024 per step, checked over many queries.
+BENCHMARK(bm_open_set) {
+	for (int size : { 1024, 2048 }) {
+		compare_on_map<Neighbourhood4>(size, "4way", 0.0);
+		compare_on_map<Neighbourhood8>(size, "8way", 1.0 / c_bucket_open_set::KEY_SCALE);
+	}
+	check_bucket_bound(256, 2000);
+}
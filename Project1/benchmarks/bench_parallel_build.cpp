@@ -0,0 +1,84 @@
+#include "bench_common.h"
+#include "../c_graph.h"
+#include "../c_thread_pool.h"
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	std::vector<char> flatten(const std::vector<std::vector<char>>& rows) {
+		std::vector<char> cells;
+		for (const auto& row : rows) cells.insert(cells.end(), row.begin(), row.end());
+		return cells;
+	}
+
+	// Sprinkle road, mud and water over the floor so the cost bytes are built too.
+	void add_terrain(std::vector<char>& cells, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> pick(0, 7);
+		for (char& cell : cells) {
+			if (cell == '.' && pick(rng) < 3) cell = "rm~"[pick(rng) % 3];
+		}
+	}
+
+	// JPS scans columns through the column-major copy and 8-way A* never reads it, so their costs agreeing between
+	// random cells checks the transpose independently of how it was built.
+	void check_columns(const c_graph& graph, const std::string& label) {
+		std::mt19937 rng(11);
+		std::uniform_int_distribution<int> row(0, graph.rows() - 1), col(0, graph.cols() - 1);
+		c_search_state state;
+		for (int query = 0; query < 20; ++query) {
+			const Node start = graph.get_node(row(rng), col(rng));
+			const Node goal = graph.get_node(row(rng), col(rng));
+			if (start.is_wall || goal.is_wall) continue;
+			const std::vector<std::pair<int, int>> a_star_path = graph.a_star<Neighbourhood8>(start, goal, state);
+			const std::vector<std::pair<int, int>> jps_path = graph.jps(start, goal, state);
+			if (a_star_path.empty() != jps_path.empty() || (!a_star_path.empty() &&
+				std::abs(checked_path_cost(graph, a_star_path) - checked_path_cost(graph, jps_path)) > 1e-9)) {
+				throw std::runtime_error("Column-major copy is wrong on " + label);
+			}
+		}
+	}
+}
+
+// The banded build checked against the serial one on awkward sizes for 1 to 8 threads, then timed against the
+// thread count on large maps.
+BENCHMARK(bm_parallel_build) {
+	const unsigned thread_counts[] = { 1, 2, 4, 8 };
+	for (auto [rows, cols] : { std::pair{ 3, 3 }, { 3, 200 }, { 200, 3 }, { 63, 65 }, { 64, 64 }, { 129, 77 }, { 1000, 777 } }) {
+		for (bool terrain : { false, true }) {
+			std::vector<char> cells = flatten(make_random_map(rows, cols, 25, 3));
+			if (terrain) add_terrain(cells, 4);
+			const std::string label = std::to_string(rows) + "x" + std::to_string(cols) + (terrain ? "/terrain" : "");
+			const c_graph serial(cells.data(), rows, cols);
+			check_columns(serial, label);
+			for (unsigned threads : thread_counts) {
+				c_thread_pool pool(threads);
+				if (!c_graph(cells.data(), rows, cols, pool).same_layout(serial)) {
+					throw std::runtime_error("Parallel build differs from the serial one on " + label + " with " + std::to_string(threads) + " threads");
+				}
+			}
+		}
+	}
+
+	std::cout << "hardware threads=" << std::thread::hardware_concurrency() << '\n';
+	for (int size : { 1024, 4096 }) {
+		if (size > max_map_size()) continue;
+		const std::string label = std::to_string(size) + "x" + std::to_string(size);
+		const std::vector<char> cells = flatten(make_map(MapKind::CAVE, size, size, 9));
+		std::size_t sink = 0;
+		run_timed("build_graph/serial/" + label, [&] { sink += c_graph(cells.data(), size, size).rows(); });
+		const c_graph serial(cells.data(), size, size);
+		for (unsigned threads : thread_counts) {
+			c_thread_pool pool(threads);
+			const c_graph parallel(cells.data(), size, size, pool);
+			if (!parallel.same_layout(serial)) {
+				throw std::runtime_error("Parallel build differs from the serial one on " + label);
+			}
+			run_timed("build_graph/threads:" + std::to_string(threads) + "/" + label, [&] { sink += c_graph(cells.data(), size, size, pool).rows(); });
+		}
+		std::cout << "sink=" << sink % 2 << '\n'; // Keeps the timed loops from being optimised away.
+	}
+}
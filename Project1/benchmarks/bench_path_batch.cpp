@@ -0,0 +1,58 @@
+#include "bench_common.h"
+#include "../c_path_batch.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+	// Random start/goal pairs on floor cells of the graph.
+	std::vector<PathQuery> make_queries(const c_graph& graph, std::size_t count, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> row(0, graph.rows() - 1);
+		std::uniform_int_distribution<int> col(0, graph.cols() - 1);
+		auto random_floor = [&] {
+			while (true) {
+				const Node node = graph.get_node(row(rng), col(rng));
+				if (!node.is_wall) return node;
+			}
+		};
+		std::vector<PathQuery> queries(count);
+		for (auto& query : queries) {
+			query = { random_floor(), random_floor() };
+		}
+		return queries;
+	}
+}
+
+// Queries per second for 1 to N worker threads, N being the hardware thread count (at least 4).
+BENCHMARK(bm_path_batch) {
+	const c_graph graph(make_random_map(512, 512, 25, 5));
+	const std::vector<PathQuery> queries = make_queries(graph, 1000, 11);
+
+	// Check the batch answers match single queries before timing anything.
+	c_path_batch_result results;
+	{
+		c_path_batch batch(graph, 2);
+		batch.find_paths(queries, results);
+		c_search_state state;
+		for (std::size_t i = 0; i < queries.size(); i += 97) {
+			const auto expected = graph.a_star(queries[i].start, queries[i].goal, state);
+			if (!std::equal(expected.begin(), expected.end(), results.path(i).begin(), results.path(i).end())) {
+				throw std::runtime_error("Batch path differs from a_star");
+			}
+		}
+	}
+
+	const unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+	for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+		c_path_batch batch(graph, threads);
+		const std::string name = "path_batch/threads:" + std::to_string(threads);
+		const auto begin = std::chrono::steady_clock::now();
+		const std::uint64_t batches = run_timed(name, [&] { batch.find_paths(queries, results); }, 1.0);
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		std::cout << name << " queries_per_second=" << static_cast<long long>(batches * queries.size() / seconds) << '\n';
+	}
+}
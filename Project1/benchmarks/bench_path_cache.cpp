@@ -0,0 +1,99 @@
+#include "bench_common.h"
+#include "../c_path_cache.h"
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	struct Query {
+		Node start;
+		Node goal;
+		PathOptions options;
+	};
+
+	// A hot set of start/goal pairs, half 4-way and half 8-way, with a skewed request stream over them.
+	std::vector<Query> hot_queries(const c_graph& graph, std::size_t count, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> row(1, graph.rows() - 2), col(1, graph.cols() - 2);
+		std::vector<Query> queries;
+		while (queries.size() < count) {
+			const Node start = graph.get_node(row(rng), col(rng));
+			const Node goal = graph.get_node(row(rng), col(rng));
+			if (!start.is_wall && !goal.is_wall) queries.push_back({ start, goal, { queries.size() % 2 == 1 } });
+		}
+		return queries;
+	}
+
+	std::vector<std::size_t> request_stream(std::size_t hot_count, std::size_t length, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<double> unit(0.0, 1.0);
+		std::vector<std::size_t> stream;
+		for (std::size_t i = 0; i < length; ++i) {
+			const double u = unit(rng);
+			stream.push_back(static_cast<std::size_t>(u * u * hot_count)); // Low ids are requested most.
+		}
+		return stream;
+	}
+
+	double fresh_cost(const c_graph& graph, const Query& query, c_search_state& state) {
+		const auto path = query.options.eight_way ? graph.a_star<Neighbourhood8>(query.start, query.goal, state)
+			: graph.a_star<Neighbourhood4>(query.start, query.goal, state);
+		return path.empty() ? -1.0 : checked_path_cost(graph, path);
+	}
+}
+
+// Repeated start/goal queries through c_path_cache against running a_star every time, then random
+// cell edits checking every cached path is still as short as a fresh search and counting entries dropped.
+BENCHMARK(bm_path_cache) {
+	c_graph graph(make_random_map(1024, 1024, 20, 41));
+	const std::vector<Query> queries = hot_queries(graph, 64, 7);
+	const std::vector<std::size_t> stream = request_stream(queries.size(), 500, 9);
+	c_search_state state;
+	std::vector<std::pair<int, int>> path;
+
+	run_timed("a_star_every_request/1024x1024", [&] {
+		for (const std::size_t id : stream) {
+			path.clear();
+			const Query& query = queries[id];
+			if (query.options.eight_way) graph.a_star<Neighbourhood8>(query.start, query.goal, state, path);
+			else graph.a_star<Neighbourhood4>(query.start, query.goal, state, path);
+		}
+	});
+	c_path_cache cache(graph, 256);
+	run_timed("path_cache/1024x1024", [&] {
+		for (const std::size_t id : stream) {
+			path.clear();
+			cache.find_path(queries[id].start, queries[id].goal, queries[id].options, state, path);
+		}
+	});
+	std::size_t vector_bytes = 0;
+	for (const Query& query : queries) {
+		vector_bytes += cache.find_path(query.start, query.goal, query.options, state).size() * sizeof(std::pair<int, int>);
+	}
+	std::cout << "path_cache hits=" << cache.hits() << " misses=" << cache.misses() << " entries=" << cache.size()
+		<< " packed_bytes=" << cache.memory_usage() << " vector_bytes=" << vector_bytes << '\n';
+
+	// Toggle random cells. After each edit every hot query must still get a shortest path.
+	std::mt19937 rng(3);
+	std::uniform_int_distribution<int> row(1, graph.rows() - 2), col(1, graph.cols() - 2);
+	const int edits = 100;
+	std::size_t dropped = 0;
+	for (int edit = 0; edit < edits; ++edit) {
+		const int x = row(rng), y = col(rng);
+		graph.set_walkable(x, y, !graph.is_walkable(graph.cell_index(x, y)));
+		dropped += cache.on_cell_changed(x, y);
+		for (const Query& query : queries) {
+			if (graph.get_node(query.start.x, query.start.y).is_wall || graph.get_node(query.goal.x, query.goal.y).is_wall) continue;
+			path.clear();
+			const bool found = cache.find_path(query.start, query.goal, query.options, state, path);
+			const double cost = found ? checked_path_cost(graph, path) : -1.0;
+			if (std::abs(cost - fresh_cost(graph, query, state)) > 1e-9) {
+				throw std::runtime_error("Path cache returned a stale path after an edit");
+			}
+		}
+	}
+	std::cout << "path_cache_edits entries=" << cache.size() << " dropped per edit="
+		<< static_cast<double>(dropped) / edits << " hits=" << cache.hits() << " misses=" << cache.misses() << '\n';
+}
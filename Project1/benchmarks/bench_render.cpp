@@ -0,0 +1,136 @@
+#include "bench_common.h"
+#include "../c_dungeon_map.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	// What display_map wrote before frames were buffered: a colour code, the cell, its padding and a reset, per cell.
+	void legacy_display(const c_dungeon_map& map, std::ostream& out) {
+		for (int i = 0; i < map.rows(); ++i) {
+			for (int j = 0; j < map.cols(); ++j) {
+				const char cell = map.cell(i, j);
+				switch (cell) {
+				case 's': case 'x': case 'p': out << std::string("\033[32m") << cell << ' ' << std::string("\033[0m"); break;
+				case 'w': out << std::string("\033[90m") << cell << ' ' << std::string("\033[0m"); break;
+				case '.': out << std::string("\033[30m") << cell << ' ' << std::string("\033[0m"); break;
+				case 'r': out << std::string("\033[97m") << cell << ' ' << std::string("\033[0m"); break;
+				case 'm': out << std::string("\033[38;5;94m") << cell << ' ' << std::string("\033[0m"); break;
+				case '~': out << std::string("\033[34m") << cell << ' ' << std::string("\033[0m"); break;
+				default:
+					if (cell >= 'a' && cell <= 'j') out << std::string("\033[33m") << cell << ' ' << std::string("\033[0m");
+					else out << cell << ' ';
+					break;
+				}
+			}
+			out << '\n';
+		}
+	}
+
+	// The visible characters of a frame, each tagged with the colour code in force when it was written.
+	std::vector<std::pair<std::string, char>> as_terminal_sees(const std::string& frame) {
+		std::vector<std::pair<std::string, char>> cells;
+		std::string colour = "\033[0m";
+		for (std::size_t i = 0; i < frame.size(); ++i) {
+			if (frame[i] == '\033') {
+				const std::size_t end = frame.find('m', i);
+				colour = frame.substr(i, end + 1 - i);
+				i = end;
+			} else if (frame[i] != ' ') {
+				cells.emplace_back(frame[i] == '\n' ? "" : colour, frame[i]);
+			}
+		}
+		return cells;
+	}
+
+	// A random map with some terrain, loaded and with the A* path from start to exit marked.
+	void make_marked_map(int size, const std::string& filename, c_dungeon_map& dungeon) {
+		std::vector<std::vector<char>> rows = make_random_map(size, size, 20, 5);
+		const char terrain[] = { 'r', 'm', '~' };
+		for (int i = 1; i < size - 1; i += 7) rows[i][size / 2] = terrain[i % 3];
+		write_map_file(filename, rows);
+		dungeon.load_map(filename);
+		std::remove(filename.c_str());
+		const c_graph graph = dungeon.to_graph();
+		const auto [sx, sy] = dungeon.get_start_node();
+		const auto [ex, ey] = dungeon.get_end_node();
+		c_search_state state;
+		dungeon.mark_path(graph.a_star(graph.get_node(sx, sy), graph.get_node(ex, ey), state));
+	}
+}
+
+// The buffered render_map checked against the old per-cell output for what a terminal shows, then timed against it,
+// with a viewport, a downsampled overview and save_map against writing one character at a time.
+BENCHMARK(bm_render) {
+	for (int size : { 64, 2000 }) {
+		const std::string label = std::to_string(size) + "x" + std::to_string(size);
+		c_dungeon_map dungeon;
+		make_marked_map(size, "bench_render.txt", dungeon);
+
+		std::string frame;
+		dungeon.render_map(frame);
+		std::ostringstream legacy;
+		legacy_display(dungeon, legacy);
+		if (as_terminal_sees(frame) != as_terminal_sees(legacy.str()) || frame.rfind("\033[0m") != frame.size() - 4) {
+			throw std::runtime_error("render_map shows something different from the old display_map on " + label);
+		}
+		std::cout << label << " frame bytes=" << frame.size() << " legacy bytes=" << legacy.str().size() << '\n';
+
+		// A window is the same cells as the matching part of the whole frame.
+		const MapViewport window{ size / 4, size / 3, 10, 12, 1 };
+		std::string part;
+		dungeon.render_map(part, window);
+		auto seen = as_terminal_sees(part);
+		const auto whole = as_terminal_sees(frame);
+		for (int i = 0; i < window.rows; ++i) {
+			for (int j = 0; j < window.cols; ++j) {
+				const std::size_t index = static_cast<std::size_t>(i) * (window.cols + 1) + j;
+				if (seen[index].second != dungeon.cell(window.top + i, window.left + j) ||
+					seen[index] != whole[static_cast<std::size_t>(window.top + i) * (size + 1) + window.left + j]) {
+					throw std::runtime_error("Viewport shows the wrong cells on " + label);
+				}
+			}
+		}
+
+		// The overview fits and keeps the start and exit visible.
+		const MapViewport overview = dungeon.fit_viewport(100, 100);
+		std::string small;
+		dungeon.render_map(small, overview);
+		seen = as_terminal_sees(small);
+		std::size_t lines = 0, starts = 0, exits = 0;
+		for (const auto& [colour, cell] : seen) {
+			lines += cell == '\n';
+			starts += cell == 's';
+			exits += cell == 'x';
+		}
+		if (lines > 100 || starts != 1 || exits != 1) {
+			throw std::runtime_error("Downsampled overview lost the start or exit on " + label);
+		}
+
+		run_timed("legacy_display/" + label, [&] { std::ostringstream out; legacy_display(dungeon, out); });
+		run_timed("render_map/" + label, [&] { dungeon.render_map(frame); });
+		run_timed("render_map_overview/" + label, [&] { dungeon.render_map(small, overview); });
+
+		// save_map writes under maps/, one buffered row at a time.
+		run_timed("legacy_save/" + label, [&] {
+			std::ofstream file("maps/bench_render_legacy.txt");
+			for (int i = 0; i < dungeon.rows(); ++i) {
+				for (int j = 0; j < dungeon.cols(); ++j) file << dungeon.cell(i, j) << ' ';
+				file << '\n';
+			}
+		});
+		run_timed("save_map/" + label, [&] { dungeon.save_map("bench_render_saved.txt"); });
+		std::ifstream legacy_file("maps/bench_render_legacy.txt"), saved_file("maps/bench_render_saved.txt");
+		std::stringstream legacy_text, saved_text;
+		legacy_text << legacy_file.rdbuf();
+		saved_text << saved_file.rdbuf();
+		std::remove("maps/bench_render_legacy.txt");
+		std::remove("maps/bench_render_saved.txt");
+		if (legacy_text.str() != saved_text.str()) {
+			throw std::runtime_error("save_map writes something different from before on " + label);
+		}
+	}
+}
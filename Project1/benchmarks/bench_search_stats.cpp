@@ -0,0 +1,84 @@
+#include "bench_common.h"
+#include "../c_search_stats.h"
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	struct Query {
+		Node start;
+		Node goal;
+	};
+
+	std::vector<Query> random_queries(const c_graph& graph, std::size_t count, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> row(0, graph.rows() - 1), col(0, graph.cols() - 1);
+		std::vector<Query> queries;
+		while (queries.size() < count) {
+			const Node start = graph.get_node(row(rng), col(rng));
+			const Node goal = graph.get_node(row(rng), col(rng));
+			if (!start.is_wall && !goal.is_wall && (start.x != goal.x || start.y != goal.y)) queries.push_back({ start, goal });
+		}
+		return queries;
+	}
+
+	// The stats must agree with the path returned, and in instrumented builds every push is accounted for.
+	void check(const std::string& label, const SearchStats& stats, const std::vector<std::pair<int, int>>& path) {
+		if (stats.found != !path.empty() || stats.path_length != path.size()) {
+			throw std::runtime_error("Search stats disagree with the path on " + label);
+		}
+		if constexpr (SEARCH_STATS_ENABLED) {
+			// Searches that give up or finish before the open set are used push nothing at all.
+			if (stats.pushed < stats.expanded + stats.stale_pops || (stats.pushed != 0 && stats.peak_open == 0) || stats.peak_open > stats.pushed) {
+				throw std::runtime_error("Search stats counters are inconsistent on " + label);
+			}
+		}
+	}
+
+	void run_on_map(const std::string& label, const c_graph& graph, const std::vector<Query>& queries) {
+		c_search_state state;
+		c_bidirectional_search_state both;
+		for (std::size_t i = 0; i < queries.size(); ++i) {
+			const Query& query = queries[i];
+			const auto a_star_path = graph.a_star<Neighbourhood4>(query.start, query.goal, state);
+			check("a_star/" + label, state.stats(), a_star_path);
+			std::cout << "csv,a_star," << label << ',' << to_csv(state.stats()) << '\n';
+			const auto jps_path = graph.jps(query.start, query.goal, state);
+			check("jps/" + label, state.stats(), jps_path);
+			std::cout << "csv,jps," << label << ',' << to_csv(state.stats()) << '\n';
+			const auto both_path = graph.bidirectional_a_star<Neighbourhood4>(query.start, query.goal, both);
+			check("bidirectional_a_star/" + label, both.stats(), both_path);
+			std::cout << "csv,bidirectional_a_star," << label << ',' << to_csv(both.stats()) << '\n';
+		}
+		graph.a_star<Neighbourhood4>(queries.front().start, queries.front().goal, state);
+		std::cout << "json " << to_json(state.stats()) << '\n';
+
+		// Compare these against a build with the other PATHFINDING_STATS setting to see what the counters cost.
+		std::vector<std::pair<int, int>> path;
+		run_timed(std::string(SEARCH_STATS_ENABLED ? "instrumented" : "plain") + "/a_star/" + label, [&] {
+			for (const Query& query : queries) {
+				path.clear();
+				graph.a_star<Neighbourhood4>(query.start, query.goal, state, path);
+			}
+		});
+	}
+}
+
+// Stats from a_star, jps and bidirectional_a_star exported as CSV rows and JSON, checked against the paths found.
+BENCHMARK(bm_search_stats) {
+	std::cout << "csv,algorithm,map," << csv_header() << '\n';
+	for (const char* name : { "ValidMap1", "ValidMapNoPath1" }) {
+		const std::vector<std::vector<char>> map = load_shipped_map(std::string("maps/") + name + ".txt");
+		const c_graph graph(map);
+		// Start to exit, then the start to itself, so the trivial path is checked too.
+		std::vector<Query> queries = { { find_node(graph, map, 's'), find_node(graph, map, 'x') } };
+		queries.push_back({ queries.front().start, queries.front().start });
+		for (const Query& query : random_queries(graph, 4, 23)) {
+			queries.push_back(query);
+		}
+		run_on_map(name, graph, queries);
+	}
+	const c_graph maze(make_maze_map(1024, 1024, 5, 37));
+	run_on_map("maze_1024x1024", maze, random_queries(maze, 5, 23));
+}
@@ -0,0 +1,74 @@
+#include "bench_common.h"
+#include "../c_dungeon_map.h"
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	// Like run_timed, but reports a counter divided by the mean time, e.g. cells/sec.
+	template <typename Fn>
+	void run_rate(const std::string& name, const std::string& counter_name, double per_iteration, Fn&& fn) {
+		using clock = std::chrono::steady_clock;
+		std::uint64_t iterations = 0;
+		const auto begin = clock::now();
+		double elapsed = 0.0;
+		do {
+			fn();
+			++iterations;
+			elapsed = std::chrono::duration<double>(clock::now() - begin).count();
+		} while (elapsed < 0.5);
+		report(name, iterations, elapsed, counter_name, per_iteration * iterations / elapsed);
+	}
+
+	void run_on_map(MapKind kind, int size) {
+		const std::string label = std::string(map_kind_name(kind)) + "/" + std::to_string(size) + "x" + std::to_string(size);
+		const std::string filename = "bench_suite_" + std::string(map_kind_name(kind)) + "_" + std::to_string(size) + ".txt";
+		write_map_file(filename, make_map(kind, size, size, 1));
+		const double cells = static_cast<double>(size) * size;
+
+		c_dungeon_map map;
+		run_rate("load_map/" + label, "cells/sec", cells, [&] { map.load_map(filename); });
+		std::remove(filename.c_str());
+		c_graph graph;
+		run_rate("to_graph/" + label, "cells/sec", cells, [&] { graph = map.to_graph(); });
+
+		const auto start_pos = map.get_start_node();
+		const auto end_pos = map.get_end_node();
+		const Node start = graph.get_node(start_pos.first, start_pos.second);
+		const Node goal = graph.get_node(end_pos.first, end_pos.second);
+		c_search_state state;
+		std::vector<std::pair<int, int>> path;
+		if (!graph.a_star<Neighbourhood4>(start, goal, state, path)) {
+			throw std::runtime_error("Generated map has no path from start to exit: " + label);
+		}
+		checked_path_cost(graph, path);
+		run_rate("a_star/" + label, "expanded/sec", static_cast<double>(state.expansions()), [&] {
+			path.clear();
+			graph.a_star<Neighbourhood4>(start, goal, state, path);
+		});
+
+		c_traversal_state traversal;
+		std::vector<std::pair<int, int>> items;
+		graph.dfs_items(start, traversal, items);
+		if (items.size() != 10) {
+			throw std::runtime_error("Generated map has unreachable items: " + label);
+		}
+		// Whole traversals, so the work grows with the map rather than stopping at the tenth item.
+		auto visit_all = [](int) { return true; };
+		const std::size_t reachable = graph.dfs(start, traversal, visit_all);
+		run_rate("dfs/" + label, "cells/sec", static_cast<double>(reachable), [&] { graph.dfs(start, traversal, visit_all); });
+		run_rate("bfs/" + label, "cells/sec", static_cast<double>(reachable), [&] { graph.bfs(start, traversal, visit_all); });
+	}
+}
+
+// load_map, to_graph, a_star, dfs and bfs on generated open, cave, maze and room maps from 20x20 up to 8192x8192
+// (or --max-size). Pass --json=<file> or --csv=<file> to keep the results.
+BENCHMARK(bm_suite) {
+	for (MapKind kind : { MapKind::OPEN, MapKind::CAVE, MapKind::MAZE, MapKind::ROOMS }) {
+		for (int size : { 20, 128, 512, 2048, 8192 }) {
+			if (size > max_map_size()) break;
+			run_on_map(kind, size);
+		}
+	}
+}
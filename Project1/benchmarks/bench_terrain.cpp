@@ -0,0 +1,162 @@
+#include "bench_common.h"
+#include "../c_dungeon_map.h"
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	struct Query {
+		Node start;
+		Node goal;
+	};
+
+	std::vector<Query> random_queries(const c_graph& graph, std::size_t count, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> row(0, graph.rows() - 1), col(0, graph.cols() - 1);
+		std::vector<Query> queries;
+		while (queries.size() < count) {
+			const Node start = graph.get_node(row(rng), col(rng));
+			const Node goal = graph.get_node(row(rng), col(rng));
+			if (!start.is_wall && !goal.is_wall) queries.push_back({ start, goal });
+		}
+		return queries;
+	}
+
+	// A random map with patches of road, mud and water laid over its floor.
+	std::vector<std::vector<char>> make_terrain_map(int size, std::uint32_t seed) {
+		std::vector<std::vector<char>> map = make_random_map(size, size, 15, seed);
+		std::mt19937 rng(seed + 1);
+		std::uniform_int_distribution<int> cell(1, size - 2), radius(1, 6);
+		const char symbols[] = { 'r', 'm', '~' };
+		for (int patch = 0; patch < size * size / 40; ++patch) {
+			const char symbol = symbols[patch % 3];
+			const int x = cell(rng), y = cell(rng), r = radius(rng);
+			for (int i = std::max(1, x - r); i <= std::min(size - 2, x + r); ++i) {
+				for (int j = std::max(1, y - r); j <= std::min(size - 2, y + r); ++j) {
+					if (map[i][j] == '.') map[i][j] = symbol;
+				}
+			}
+		}
+		return map;
+	}
+
+	// Plain Dijkstra over the same cost model, the reference the weighted A* costs are checked against.
+	template <typename Neighbourhood>
+	std::uint64_t reference_cost(const c_graph& graph, const Node& start, const Node& goal) {
+		const std::size_t cells = static_cast<std::size_t>(graph.rows()) * graph.cols();
+		std::vector<std::uint64_t> best(cells, UINT64_MAX);
+		using entry = std::pair<std::uint64_t, int>;
+		std::priority_queue<entry, std::vector<entry>, std::greater<entry>> open;
+		best[graph.cell_index(start.x, start.y)] = 0;
+		open.push({ 0, graph.cell_index(start.x, start.y) });
+		while (!open.empty()) {
+			const auto [cost, current] = open.top();
+			open.pop();
+			if (cost != best[current]) continue;
+			if (current == graph.cell_index(goal.x, goal.y)) return cost;
+			const int x = current / graph.cols(), y = current % graph.cols();
+			for (int dx = -1; dx <= 1; ++dx) {
+				for (int dy = -1; dy <= 1; ++dy) {
+					const bool diagonal = dx != 0 && dy != 0;
+					if ((dx == 0 && dy == 0) || (diagonal && !Neighbourhood::diagonal)) continue;
+					const int nx = x + dx, ny = y + dy;
+					if (nx < 0 || nx >= graph.rows() || ny < 0 || ny >= graph.cols()) continue;
+					const int neighbor = graph.cell_index(nx, ny);
+					if (!graph.is_walkable(neighbor)) continue;
+					if (diagonal && (!graph.is_walkable(graph.cell_index(nx, y)) || !graph.is_walkable(graph.cell_index(x, ny)))) continue;
+					const std::uint64_t next = cost + static_cast<std::uint64_t>(graph.cost_at(neighbor)) * (diagonal ? DIAGONAL_STEP : STRAIGHT_STEP);
+					if (next < best[neighbor]) {
+						best[neighbor] = next;
+						open.push({ next, neighbor });
+					}
+				}
+			}
+		}
+		return UINT64_MAX;
+	}
+
+	// Cost of a path under the terrain model, from the steps themselves.
+	std::uint64_t path_terrain_cost(const c_graph& graph, const std::vector<std::pair<int, int>>& path) {
+		checked_path_cost(graph, path); // Throws on illegal steps.
+		std::uint64_t cost = 0;
+		for (std::size_t i = 1; i < path.size(); ++i) {
+			const bool diagonal = path[i].first != path[i - 1].first && path[i].second != path[i - 1].second;
+			cost += static_cast<std::uint64_t>(graph.cost_at(graph.cell_index(path[i].first, path[i].second))) * (diagonal ? DIAGONAL_STEP : STRAIGHT_STEP);
+		}
+		return cost;
+	}
+
+	template <typename Neighbourhood>
+	void check_and_time(const std::string& label, const c_graph& graph, const std::vector<Query>& queries) {
+		c_weighted_search_state state;
+		std::vector<std::pair<int, int>> path;
+		std::size_t expanded = 0;
+		for (const Query& query : queries) {
+			path.clear();
+			const bool found = graph.weighted_a_star<Neighbourhood>(query.start, query.goal, state, path);
+			expanded += state.expansions();
+			const std::uint64_t cost = found ? state.g_score(graph.cell_index(query.goal.x, query.goal.y)) : UINT64_MAX;
+			if (cost != reference_cost<Neighbourhood>(graph, query.start, query.goal) || (found && path_terrain_cost(graph, path) != cost)) {
+				throw std::runtime_error("weighted_a_star path is not the cheapest on " + label);
+			}
+		}
+		std::cout << label << " queries=" << queries.size() << " expanded=" << expanded << '\n';
+		run_timed("weighted_a_star/" + label, [&] {
+			for (const Query& query : queries) {
+				path.clear();
+				graph.weighted_a_star<Neighbourhood>(query.start, query.goal, state, path);
+			}
+		});
+	}
+}
+
+// weighted_a_star checked against Dijkstra on maps with road, mud and water, and timed against the floating point
+// a_star on a map without terrain, where both must find paths of the same length.
+BENCHMARK(bm_terrain) {
+	// The map format round trip: terrain classes pass verify_map and reach the graph's cost bytes.
+	const std::string filename = "bench_terrain.txt";
+	write_map_file(filename, make_terrain_map(64, 5));
+	c_dungeon_map dungeon(filename);
+	std::remove(filename.c_str());
+	if (!dungeon.to_graph().has_terrain()) {
+		throw std::runtime_error("Terrain was lost loading the map");
+	}
+
+	for (int size : { 256, 1024 }) {
+		const c_graph graph(make_terrain_map(size, 5));
+		const std::vector<Query> queries = random_queries(graph, size == 256 ? 50 : 10, 13);
+		const std::string label = std::to_string(size) + "x" + std::to_string(size);
+		check_and_time<Neighbourhood4>("4way/terrain_" + label, graph, queries);
+		check_and_time<Neighbourhood8>("8way/terrain_" + label, graph, queries);
+	}
+
+	// Without terrain every step costs FLOOR_COST, so the weighted paths are exactly as long as a_star's.
+	const c_graph plain(make_random_map(1024, 1024, 25, 5));
+	const std::vector<Query> queries = random_queries(plain, 10, 13);
+	c_search_state state;
+	c_weighted_search_state weighted;
+	std::vector<std::pair<int, int>> path;
+	for (const Query& query : queries) {
+		const auto one = plain.a_star<Neighbourhood4>(query.start, query.goal, state);
+		const auto two = plain.weighted_a_star<Neighbourhood4>(query.start, query.goal, weighted);
+		if (one.size() != two.size()) {
+			throw std::runtime_error("weighted_a_star and a_star disagree on a map without terrain");
+		}
+	}
+	run_timed("a_star/plain_1024x1024", [&] {
+		for (const Query& query : queries) {
+			path.clear();
+			plain.a_star<Neighbourhood4>(query.start, query.goal, state, path);
+		}
+	});
+	run_timed("weighted_a_star/plain_1024x1024", [&] {
+		for (const Query& query : queries) {
+			path.clear();
+			plain.weighted_a_star<Neighbourhood4>(query.start, query.goal, weighted, path);
+		}
+	});
+}
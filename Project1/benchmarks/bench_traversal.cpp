@@ -0,0 +1,89 @@
+#include "bench_common.h"
+#include "../c_graph.h"
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	// A map with no walls at all, so the legacy dfs/bfs (which walk through walls) and the visitor
+	// versions (which do not) must reach the items in the same order. Items sit in the far corner,
+	// so a traversal covers the whole map before it finds the tenth.
+	std::vector<std::vector<char>> make_open_map(int size) {
+		std::vector<std::vector<char>> map = make_random_map(size, size, 0, 61);
+		for (auto& row : map) {
+			for (char& cell : row) {
+				if (cell == 'w' || (cell >= 'a' && cell <= 'j')) cell = '.';
+			}
+		}
+		for (int k = 0; k < 10; ++k) {
+			map[size - 1][size - 12 + k] = static_cast<char>('a' + k);
+		}
+		return map;
+	}
+
+	// Run one of the printing legacy traversals with std::cout captured.
+	template <typename Fn>
+	std::string capture_output(Fn&& fn) {
+		std::ostringstream captured;
+		std::streambuf* const original = std::cout.rdbuf(captured.rdbuf());
+		fn();
+		std::cout.rdbuf(original);
+		return captured.str();
+	}
+
+	std::string format_items(const char* name, const std::vector<std::pair<int, int>>& items) {
+		std::ostringstream out;
+		out << name << " collected items in order: ";
+		for (std::size_t i = 0; i < items.size(); ++i) {
+			out << "(" << items[i].first << ", " << items[i].second << ")" << (i + 1 < items.size() ? ", " : "");
+		}
+		out << "\n";
+		return out.str();
+	}
+
+	void compare_on_map(int size, bool run_legacy) {
+		const std::string label = std::to_string(size) + "x" + std::to_string(size);
+		c_graph graph(make_open_map(size));
+		const Node start = graph.get_node(1, 1);
+		c_traversal_state state;
+		std::vector<std::pair<int, int>> items;
+		const double floor_cells = static_cast<double>(size) * size;
+
+		const std::size_t dfs_cells = graph.dfs_items(start, state, items);
+		const std::string dfs_new = format_items("DFS", items);
+		items.clear();
+		const std::size_t bfs_cells = graph.bfs_items(start, state, items);
+		const std::string bfs_new = format_items("BFS", items);
+		if (run_legacy) {
+			if (capture_output([&] { graph.dfs(start); }) != dfs_new || capture_output([&] { graph.bfs(start); }) != bfs_new) {
+				throw std::runtime_error("Visitor traversal reaches the items in a different order on " + label);
+			}
+		}
+
+		auto throughput = [&](const std::string& name, std::size_t cells, auto&& fn) {
+			double seconds = 0.0;
+			const std::uint64_t iterations = run_timed(name, [&] {
+				const auto begin = std::chrono::steady_clock::now();
+				fn();
+				seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+			});
+			std::cout << name << " cells/sec=" << static_cast<double>(cells) * iterations / seconds << '\n';
+		};
+		throughput("dfs_visitor/" + label, dfs_cells, [&] { items.clear(); graph.dfs_items(start, state, items); });
+		throughput("bfs_visitor/" + label, bfs_cells, [&] { items.clear(); graph.bfs_items(start, state, items); });
+		if (run_legacy) {
+			// The legacy functions cover the same cells, they are charged for the floor cells only.
+			throughput("dfs_legacy/" + label, static_cast<std::size_t>(floor_cells), [&] { capture_output([&] { graph.dfs(start); }); });
+			throughput("bfs_legacy/" + label, static_cast<std::size_t>(floor_cells), [&] { capture_output([&] { graph.bfs(start); }); });
+		}
+	}
+}
+
+// Cells/sec of the visitor dfs/bfs against the printing unordered_map versions, checking both find the items in the same order.
+BENCHMARK(bm_traversal) {
+	compare_on_map(256, true);
+	compare_on_map(512, true);   // The legacy versions take tens of seconds from 1024x1024 up, their Node hash collides heavily.
+	compare_on_map(1024, false);
+	compare_on_map(4096, false);
+}
@@ -0,0 +1,161 @@
+#include "c_batch_runner.h"
+#include "c_binary_map.h"
+#include "c_dungeon_map.h"
+#include <chrono>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+	using clock = std::chrono::steady_clock;
+
+	long long microseconds_since(clock::time_point begin) {
+		return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - begin).count();
+	}
+
+	// The items as their letters, in the order they were reached.
+	std::string item_letters(const c_graph& graph, const std::vector<std::pair<int, int>>& items) {
+		std::string letters;
+		for (const auto& [x, y] : items) letters += graph.special_at(graph.cell_index(x, y));
+		return letters.empty() ? "-" : letters;
+	}
+
+	// A path as its first cell followed by one letter per step.
+	void append_path(std::ostream& out, const std::vector<std::pair<int, int>>& path) {
+		out << path.front().first << ',' << path.front().second << ':';
+		for (std::size_t i = 1; i < path.size(); ++i) {
+			const int dx = path[i].first - path[i - 1].first;
+			const int dy = path[i].second - path[i - 1].second;
+			out << (dx < 0 ? 'U' : dx > 0 ? 'D' : dy < 0 ? 'L' : 'R');
+		}
+	}
+}
+
+std::vector<BatchJob> parse_batch_file(const std::string& filename) {
+	std::ifstream file(filename);
+	if (!file.is_open()) {
+		throw std::runtime_error("Could not open batch file " + filename);
+	}
+	std::vector<BatchJob> jobs;
+	std::string line;
+	for (int line_number = 1; std::getline(file, line); ++line_number) {
+		line = line.substr(0, line.find('#'));
+		std::istringstream words(line);
+		std::string command;
+		if (!(words >> command)) continue; // Blank or comment.
+
+		const std::string where = filename + ":" + std::to_string(line_number);
+		if (command == "map") {
+			BatchJob job;
+			if (!(words >> job.map_file)) throw std::runtime_error(where + ": map needs a file");
+			jobs.push_back(std::move(job));
+		} else if (command == "query") {
+			if (jobs.empty()) throw std::runtime_error(where + ": query before any map");
+			int sx, sy, gx, gy;
+			if (!(words >> sx >> sy >> gx >> gy)) throw std::runtime_error(where + ": query needs <sx> <sy> <gx> <gy>");
+			jobs.back().queries.push_back({ { sx, sy }, { gx, gy } });
+		} else {
+			throw std::runtime_error(where + ": unknown entry " + command);
+		}
+		std::string extra;
+		if (words >> extra) throw std::runtime_error(where + ": unexpected " + extra);
+	}
+	return jobs;
+}
+
+c_batch_runner::c_batch_runner(unsigned thread_count, bool timings) : pool_(thread_count), timings_(timings) {
+}
+
+BatchSummary c_batch_runner::run(const std::vector<BatchJob>& jobs, std::ostream& out) {
+	const auto begin = clock::now();
+	std::vector<JobResult> results(jobs.size());
+	pool_.parallel_for(jobs.size(), 1, [&](unsigned, std::size_t first, std::size_t last) {
+		for (std::size_t i = first; i < last; ++i) results[i] = run_job(jobs[i]);
+	});
+
+	// Written in job order once everything is done, so the output doesn't depend on the scheduling.
+	BatchSummary summary;
+	summary.maps = jobs.size();
+	for (const JobResult& result : results) {
+		out << result.text;
+		summary.failed += result.failed ? 1 : 0;
+		summary.queries += result.queries;
+		summary.paths_found += result.paths_found;
+	}
+	summary.seconds = std::chrono::duration<double>(clock::now() - begin).count();
+	out << "summary maps=" << summary.maps << " failed=" << summary.failed << " queries=" << summary.queries
+		<< " found=" << summary.paths_found;
+	if (timings_) out << " seconds=" << summary.seconds;
+	out << '\n';
+	return summary;
+}
+
+c_batch_runner::JobResult c_batch_runner::run_job(const BatchJob& job) const {
+	JobResult result;
+	std::ostringstream out;
+	try {
+		auto phase_begin = clock::now();
+		c_dungeon_map dungeon;
+		if (is_binary_map_file(job.map_file)) dungeon.load_binary_map(job.map_file);
+		else dungeon.load_map(job.map_file);
+		const c_graph graph = dungeon.to_graph();
+		const long long load_us = microseconds_since(phase_begin);
+		const auto [start_x, start_y] = dungeon.get_start_node();
+		const auto [exit_x, exit_y] = dungeon.get_end_node();
+		const Node start = graph.get_node(start_x, start_y);
+
+		out << "map " << job.map_file << ' ' << graph.rows() << ' ' << graph.cols();
+		if (timings_) out << " load_us=" << load_us;
+		out << '\n';
+
+		// DFS and BFS from the start, recording the order the items are reached in.
+		c_traversal_state traversal;
+		std::vector<std::pair<int, int>> items;
+		for (const bool depth_first : { true, false }) {
+			items.clear();
+			phase_begin = clock::now();
+			const std::size_t visited = depth_first ? graph.dfs_items(start, traversal, items) : graph.bfs_items(start, traversal, items);
+			const long long us = microseconds_since(phase_begin);
+			out << (depth_first ? "dfs" : "bfs") << " visited=" << visited << " items=" << item_letters(graph, items);
+			if (timings_) out << " us=" << us;
+			out << '\n';
+		}
+
+		// A* for every query, or from the start to the exit.
+		auto queries = job.queries;
+		if (queries.empty()) queries.push_back({ { start_x, start_y }, { exit_x, exit_y } });
+		c_search_state state;
+		c_weighted_search_state weighted;
+		std::vector<std::pair<int, int>> path;
+		for (const auto& [from, to] : queries) {
+			const Node query_start = graph.get_node(from.first, from.second); // Throws if outside the map.
+			const Node query_goal = graph.get_node(to.first, to.second);
+			path.clear();
+			phase_begin = clock::now();
+			const bool found = graph.has_terrain()
+				? graph.weighted_a_star(query_start, query_goal, weighted, path)
+				: graph.a_star(query_start, query_goal, state, path);
+			const long long us = microseconds_since(phase_begin);
+			++result.queries;
+			out << "astar " << from.first << ' ' << from.second << ' ' << to.first << ' ' << to.second;
+			if (found) {
+				++result.paths_found;
+				out << " steps=" << path.size() - 1 << " path=";
+				append_path(out, path);
+			} else {
+				out << " none";
+			}
+			if (timings_) out << " us=" << us;
+			out << '\n';
+		}
+	}
+	catch (const std::exception& e) {
+		// Whatever was written for this map is replaced by the error, the rest of the batch carries on.
+		out.str("");
+		out << "map " << job.map_file << " error " << e.what() << '\n';
+		result.failed = true;
+	}
+	result.text = out.str();
+	return result;
+}
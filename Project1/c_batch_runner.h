@@ -0,0 +1,78 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_batch_runner.h
+// Description : Non-interactive batch runs of DFS, BFS and A* over a list of maps, spread over a thread pool.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+#include "c_thread_pool.h"
+
+struct BatchJob { // One map and the queries to run on it.
+	std::string map_file;                                                     // Text map, or binary map if it ends in .dmap.
+	std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> queries; // (start, goal) cells, empty for start to exit.
+};
+
+struct BatchSummary {
+	std::size_t maps = 0;        // Maps in the batch.
+	std::size_t failed = 0;      // Maps that could not be loaded or searched.
+	std::size_t queries = 0;     // A* queries run.
+	std::size_t paths_found = 0; // Queries that found a path.
+	double seconds = 0.0;        // Wall time of the whole batch.
+};
+
+/**
+ * @brief Read a batch file.
+ * @param filename - One entry per line, # starts a comment:
+ *                     map <file>                Starts a new job.
+ *                     query <sx> <sy> <gx> <gy> Adds an A* query to the last map.
+ * @note  Throws std::runtime_error naming the line if the file can't be read or a line is malformed.
+ */
+std::vector<BatchJob> parse_batch_file(const std::string& filename);
+
+class c_batch_runner {
+public:
+	/**
+	 * @param thread_count - Number of worker threads, 0 uses the number of hardware threads.
+	 * @param timings      - Whether to write timings, off gives output that only changes when the results do.
+	 */
+	explicit c_batch_runner(unsigned thread_count = 0, bool timings = true);
+
+	/**
+	 * @brief Run every job and write the results in job order.
+	 * @param out - Receives, per job:
+	 *                map <file> <rows> <cols> [load_us=N]
+	 *                dfs visited=N items=<items in the order reached> [us=N]
+	 *                bfs visited=N items=<items in the order reached> [us=N]
+	 *                astar <sx> <sy> <gx> <gy> steps=N path=<sx>,<sy>:<moves> [us=N]   moves are U, D, L and R
+	 *                astar <sx> <sy> <gx> <gy> none [us=N]
+	 *              or map <file> error <message>, followed by one summary line for the whole batch.
+	 * @note  Jobs run in parallel, one per worker at a time, each with its own search states. Nothing is
+	 *        printed or rendered. A* uses the terrain costs if the map has any, like the application.
+	 */
+	BatchSummary run(const std::vector<BatchJob>& jobs, std::ostream& out);
+
+	unsigned thread_count() const { return pool_.size(); }
+
+private:
+	struct JobResult {
+		std::string text;        // The job's output lines.
+		bool failed = false;
+		std::size_t queries = 0;
+		std::size_t paths_found = 0;
+	};
+
+	c_thread_pool pool_;
+	bool timings_;
+
+	JobResult run_job(const BatchJob& job) const;
+};
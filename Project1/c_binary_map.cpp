@@ -0,0 +1,266 @@
+#include "c_binary_map.h"
+#include "c_dungeon_map.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The header is written and mapped as a raw struct, which is only the documented layout on a little-endian host.
+static_assert(std::endian::native == std::endian::little, "The binary map format is little-endian");
+
+namespace {
+	constexpr char BINARY_MAP_MAGIC[4] = { 'D', 'M', 'A', 'P' };
+
+	std::uint64_t align_to_8(std::uint64_t offset) {
+		return (offset + 7) & ~std::uint64_t(7);
+	}
+
+	// Whether count bytes from offset lie inside a file of file_size bytes, without offset + count wrapping around.
+	bool fits_in_file(std::uint64_t offset, std::uint64_t count, std::uint64_t file_size) {
+		return offset <= file_size && count <= file_size - offset;
+	}
+}
+
+c_mapped_file::c_mapped_file(const std::string& filename) {
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error("Unable to open file");
+	}
+	file_handle_ = file;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		release();
+		throw std::runtime_error("Unable to map empty file");
+	}
+	size_ = static_cast<std::size_t>(size.QuadPart);
+	mapping_handle_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping_handle_) {
+		release();
+		throw std::runtime_error("Unable to map file");
+	}
+	data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+	if (!data_) {
+		release();
+		throw std::runtime_error("Unable to map file");
+	}
+#else
+	const int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw std::runtime_error("Unable to open file");
+	}
+	struct stat info {};
+	if (fstat(fd, &info) != 0 || info.st_size == 0) {
+		close(fd);
+		throw std::runtime_error("Unable to map empty file");
+	}
+	size_ = static_cast<std::size_t>(info.st_size);
+	void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // The mapping keeps its own reference to the file.
+	if (mapping == MAP_FAILED) {
+		size_ = 0;
+		throw std::runtime_error("Unable to map file");
+	}
+	data_ = static_cast<const unsigned char*>(mapping);
+#endif
+}
+
+c_mapped_file::~c_mapped_file() {
+	release();
+}
+
+c_mapped_file::c_mapped_file(c_mapped_file&& other) noexcept {
+	*this = std::move(other);
+}
+
+c_mapped_file& c_mapped_file::operator=(c_mapped_file&& other) noexcept {
+	if (this != &other) {
+		release();
+		std::swap(data_, other.data_);
+		std::swap(size_, other.size_);
+#ifdef _WIN32
+		std::swap(file_handle_, other.file_handle_);
+		std::swap(mapping_handle_, other.mapping_handle_);
+#endif
+	}
+	return *this;
+}
+
+void c_mapped_file::release() {
+#ifdef _WIN32
+	if (data_) UnmapViewOfFile(data_);
+	if (mapping_handle_) CloseHandle(mapping_handle_);
+	if (file_handle_) CloseHandle(file_handle_);
+	mapping_handle_ = nullptr;
+	file_handle_ = nullptr;
+#else
+	if (data_) munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+	data_ = nullptr;
+	size_ = 0;
+}
+
+c_binary_map::c_binary_map(const std::string& filename) : file_(filename) {
+	// Validate the header before handing out any pointers into the mapping.
+	if (file_.size() < sizeof(binary_map_header)) {
+		throw std::runtime_error("Binary map is too small");
+	}
+	const binary_map_header& head = header();
+	if (std::memcmp(head.magic, BINARY_MAP_MAGIC, sizeof(BINARY_MAP_MAGIC)) != 0) {
+		throw std::runtime_error("Not a binary map file");
+	}
+	if (head.version != BINARY_MAP_VERSION) {
+		throw std::runtime_error("Unsupported binary map version");
+	}
+	// Cell indices are ints everywhere downstream, so the cell count has to fit in one.
+	if (head.rows <= 0 || head.cols <= 0 ||
+		static_cast<std::uint64_t>(head.rows) * static_cast<std::uint64_t>(head.cols) > std::numeric_limits<int>::max()) {
+		throw std::runtime_error("Binary map dimensions are out of range");
+	}
+	const std::uint64_t cell_count = static_cast<std::uint64_t>(head.rows) * head.cols;
+	if (!fits_in_file(head.cells_offset, cell_count, file_.size())) {
+		throw std::runtime_error("Binary map is truncated");
+	}
+	if ((head.flags & BINARY_MAP_HAS_BITSET) &&
+		(head.bitset_offset % 8 != 0 || !fits_in_file(head.bitset_offset, (cell_count + 63) / 64 * 8, file_.size()))) {
+		throw std::runtime_error("Binary map bitset is truncated");
+	}
+}
+
+const std::uint64_t* c_binary_map::walkable_bits() const {
+	if (!(header().flags & BINARY_MAP_HAS_BITSET)) return nullptr;
+	return reinterpret_cast<const std::uint64_t*>(file_.data() + header().bitset_offset);
+}
+
+void c_binary_map::scan(MapScan& scan) const {
+	const binary_map_header& head = header();
+	const std::size_t cell_count = static_cast<std::size_t>(head.rows) * head.cols;
+	const std::uint64_t* bits = walkable_bits();
+	if (bits == nullptr || !(head.flags & BINARY_MAP_INDEXED)) {
+		scan_map(cells(), cell_count, scan);
+		return;
+	}
+
+	// The bitset is already in MapScan's layout. Clear the bits past the last cell in case the file set them.
+	scan.walkable.assign(bits, bits + (cell_count + 63) / 64);
+	if (cell_count % 64 != 0) scan.walkable.back() &= (std::uint64_t(1) << (cell_count % 64)) - 1;
+
+	// The specials come from the header positions, -1 marks one that is missing.
+	scan.specials.clear();
+	const auto add_special = [&](std::int32_t x, std::int32_t y, char ch) {
+		if (x == -1 && y == -1) return;
+		if (x < 0 || x >= head.rows || y < 0 || y >= head.cols) {
+			throw std::runtime_error("Binary map position is out of range");
+		}
+		const int index = x * head.cols + y;
+		if (!((scan.walkable[index / 64] >> (index % 64)) & 1)) {
+			throw std::runtime_error("Binary map position is a wall");
+		}
+		scan.specials.emplace_back(index, ch);
+	};
+	add_special(head.start_x, head.start_y, 's');
+	add_special(head.exit_x, head.exit_y, 'x');
+	for (int k = 0; k < BINARY_MAP_ITEM_COUNT; ++k) {
+		add_special(head.item_x[k], head.item_y[k], static_cast<char>('a' + k));
+	}
+	std::sort(scan.specials.begin(), scan.specials.end());
+	const auto shared = std::adjacent_find(scan.specials.begin(), scan.specials.end(),
+		[](const auto& a, const auto& b) { return a.first == b.first; });
+	if (shared != scan.specials.end()) {
+		throw std::runtime_error("Binary map positions overlap");
+	}
+	scan.invalid_count = 0;
+	scan.first_invalid = 0;
+	scan.has_terrain = (head.flags & BINARY_MAP_HAS_TERRAIN) != 0;
+}
+
+c_graph c_binary_map::to_graph() const {
+	MapScan map_scan;
+	scan(map_scan);
+	return { cells(), rows(), cols(), map_scan };
+}
+
+void c_binary_map::save(const std::string& filename, const char* cells, int rows, int cols, bool with_bitset) {
+	const std::uint64_t cell_count = static_cast<std::uint64_t>(rows) * cols;
+
+	// Fill in the header, recording the start, exit and item positions.
+	binary_map_header head{};
+	std::memcpy(head.magic, BINARY_MAP_MAGIC, sizeof(BINARY_MAP_MAGIC));
+	head.version = BINARY_MAP_VERSION;
+	head.rows = rows;
+	head.cols = cols;
+	head.start_x = head.start_y = head.exit_x = head.exit_y = -1;
+	for (int k = 0; k < BINARY_MAP_ITEM_COUNT; ++k) {
+		head.item_x[k] = head.item_y[k] = -1;
+	}
+	MapScan scan; // One pass gives the positions, the bitset and the flags.
+	scan_map(cells, static_cast<std::size_t>(cell_count), scan);
+	head.flags = scan.has_terrain ? BINARY_MAP_HAS_TERRAIN : 0;
+	if (with_bitset) head.flags |= BINARY_MAP_HAS_BITSET;
+	for (const auto& [index, ch] : scan.specials) {
+		const int x = index / cols;
+		const int y = index % cols;
+		if (ch == 's') { head.start_x = x; head.start_y = y; }
+		if (ch == 'x') { head.exit_x = x; head.exit_y = y; }
+		if (ch >= 'a' && ch <= 'j') { head.item_x[ch - 'a'] = x; head.item_y[ch - 'a'] = y; }
+	}
+	// The header holds one position per special, so only a map with no repeats and no invalid cells is indexed.
+	const std::size_t recorded = static_cast<std::size_t>(std::count_if(std::begin(head.item_x), std::end(head.item_x),
+		[](std::int32_t x) { return x >= 0; })) + (head.start_x >= 0) + (head.exit_x >= 0);
+	if (scan.invalid_count == 0 && scan.specials.size() == recorded) head.flags |= BINARY_MAP_INDEXED;
+	const std::vector<std::uint64_t>& bits = scan.walkable;
+	head.cells_offset = sizeof(binary_map_header);
+	head.bitset_offset = with_bitset ? align_to_8(head.cells_offset + cell_count) : 0;
+
+	// Write the header, cells, padding and bitset.
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open()) {
+		throw std::runtime_error("Unable to open file for writing");
+	}
+	file.write(reinterpret_cast<const char*>(&head), sizeof(head));
+	file.write(cells, static_cast<std::streamsize>(cell_count));
+	if (with_bitset) {
+		const char padding[8] = {};
+		file.write(padding, static_cast<std::streamsize>(head.bitset_offset - head.cells_offset - cell_count));
+		file.write(reinterpret_cast<const char*>(bits.data()), static_cast<std::streamsize>(bits.size() * sizeof(std::uint64_t)));
+	}
+	if (!file) {
+		throw std::runtime_error("Failed writing binary map");
+	}
+}
+
+void convert_text_to_binary(const std::string& text_filename, const std::string& binary_filename) {
+	c_dungeon_map map(text_filename);
+	map.save_binary_map(binary_filename);
+}
+
+void convert_binary_to_text(const std::string& binary_filename, const std::string& text_filename) {
+	c_binary_map map(binary_filename);
+	std::ofstream file(text_filename, std::ios::binary);
+	if (!file.is_open()) {
+		throw std::runtime_error("Unable to open file for writing");
+	}
+	for (int i = 0; i < map.rows(); ++i) {
+		file.write(map.cells() + static_cast<std::size_t>(i) * map.cols(), map.cols());
+		file.put('\n');
+	}
+}
+
+bool is_binary_map_file(const std::string& filename) {
+	const std::string extension = ".dmap";
+	return filename.size() >= extension.size() &&
+		filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
@@ -0,0 +1,135 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_binary_map.h
+// Description : Versioned binary map format, memory-mapped for zero-copy loading.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "c_graph.h"
+
+constexpr std::uint16_t BINARY_MAP_VERSION = 1;   // Bump when the layout below changes.
+constexpr std::uint16_t BINARY_MAP_HAS_BITSET = 1; // Header flag: a walkability bitset follows the cells.
+constexpr std::uint16_t BINARY_MAP_HAS_TERRAIN = 2; // Header flag: some cell is road, mud or water, see c_terrain.h.
+constexpr std::uint16_t BINARY_MAP_INDEXED = 4;     // Header flag: every cell is valid and the header positions are
+                                                    // all of the special cells, so the bitset and header describe the
+                                                    // map without looking at the cells.
+constexpr int BINARY_MAP_ITEM_COUNT = 10;          // Items 'a' - 'j'.
+
+/**
+ * @brief Fixed-size header at the start of a binary map file, followed by the cells and optional bitset.
+ * @note  Stored little-endian, and only built for little-endian hosts (checked at compile time in c_binary_map.cpp).
+ *        Positions of missing start/exit/items are -1. rows * cols must fit in an int.
+ */
+struct binary_map_header {
+	char magic[4];              // "DMAP".
+	std::uint16_t version;      // BINARY_MAP_VERSION.
+	std::uint16_t flags;        // BINARY_MAP_* flags.
+	std::int32_t rows, cols;    // Map dimensions.
+	std::int32_t start_x, start_y;
+	std::int32_t exit_x, exit_y;
+	std::int32_t item_x[BINARY_MAP_ITEM_COUNT], item_y[BINARY_MAP_ITEM_COUNT];
+	std::uint64_t cells_offset;  // Byte offset of the rows * cols cell chars, row-major.
+	std::uint64_t bitset_offset; // Byte offset of the walkability bitset (bit set = not a wall), 0 if absent.
+};
+
+/**
+ * @brief Read-only memory mapping of a whole file, unmapped on destruction.
+ */
+class c_mapped_file {
+public:
+	c_mapped_file() = default;
+	/**
+	 * @brief Map the specified file read-only.
+	 * @param filename - The file to map, throws if it cannot be opened or mapped.
+	 */
+	explicit c_mapped_file(const std::string& filename);
+	~c_mapped_file();
+	c_mapped_file(const c_mapped_file&) = delete;
+	c_mapped_file& operator=(const c_mapped_file&) = delete;
+	c_mapped_file(c_mapped_file&& other) noexcept;
+	c_mapped_file& operator=(c_mapped_file&& other) noexcept;
+
+	const unsigned char* data() const { return data_; }
+	std::size_t size() const { return size_; }
+
+private:
+	const unsigned char* data_ = nullptr; // Start of the mapping.
+	std::size_t size_ = 0;                // Length of the mapping in bytes.
+#ifdef _WIN32
+	void* file_handle_ = nullptr;
+	void* mapping_handle_ = nullptr;
+#endif
+
+	void release();
+};
+
+/**
+ * @brief A binary map file mapped into memory. The cells are used in place, nothing is parsed or copied.
+ */
+class c_binary_map {
+public:
+	/**
+	 * @brief Map and validate a binary map file.
+	 * @param filename - The binary map file to open.
+	 */
+	explicit c_binary_map(const std::string& filename);
+
+	/**
+	 * @brief Write a map in the binary format.
+	 * @param filename    - The file to write.
+	 * @param cells       - rows * cols map characters, row after row.
+	 * @param rows        - Number of rows in the map.
+	 * @param cols        - Number of columns in the map.
+	 * @param with_bitset - Also store a walkability bitset after the cells.
+	 */
+	static void save(const std::string& filename, const char* cells, int rows, int cols, bool with_bitset = true);
+
+	const binary_map_header& header() const { return *reinterpret_cast<const binary_map_header*>(file_.data()); }
+	int rows() const { return header().rows; }
+	int cols() const { return header().cols; }
+	/**
+	 * @brief Get the mapped row-major cells, rows() * cols() chars.
+	 */
+	const char* cells() const { return reinterpret_cast<const char*>(file_.data() + header().cells_offset); }
+	/**
+	 * @brief Get the mapped walkability bitset, one bit per cell in 64-bit words, or nullptr if it was not saved.
+	 */
+	const std::uint64_t* walkable_bits() const;
+
+	/**
+	 * @brief Fill in what scan_map would find in the cells, without scanning them if the file allows it.
+	 * @param scan - Filled in, its buffers are reused.
+	 * @note  For a file with a bitset saved as BINARY_MAP_INDEXED the bitset is copied a word at a time and the
+	 *        special cells come from the header. Otherwise the mapped cells are scanned.
+	 */
+	void scan(MapScan& scan) const;
+	/**
+	 * @brief Build a graph from the mapped bitset and header, see scan().
+	 * @note  The cells are only read for terrain costs, and only if the file has BINARY_MAP_HAS_TERRAIN.
+	 */
+	c_graph to_graph() const;
+
+private:
+	c_mapped_file file_; // The mapping the accessors point into.
+};
+
+/**
+ * @brief Convert a text map (as read by c_dungeon_map::load_map) to the binary format.
+ */
+void convert_text_to_binary(const std::string& text_filename, const std::string& binary_filename);
+/**
+ * @brief Convert a binary map back to the compact text format, one row per line.
+ */
+void convert_binary_to_text(const std::string& binary_filename, const std::string& text_filename);
+/**
+ * @brief Check whether a filename has the binary map extension, .dmap.
+ */
+bool is_binary_map_file(const std::string& filename);
@@ -0,0 +1,137 @@
+#include "c_components.h"
+#include "c_thread_pool.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+	// The 64 bits of the bitset from any bit on, bits past the end read as walls.
+	std::uint64_t bits_at(const std::vector<std::uint64_t>& words, std::size_t bit) {
+		const std::size_t word = bit >> 6;
+		const unsigned shift = bit & 63;
+		std::uint64_t bits = words[word] >> shift;
+		if (shift != 0 && word + 1 < words.size()) bits |= words[word + 1] << (64 - shift);
+		return bits;
+	}
+
+	std::uint32_t find_root(std::vector<std::uint32_t>& parent, std::uint32_t run) {
+		while (parent[run] != run) {
+			parent[run] = parent[parent[run]]; // Path halving.
+			run = parent[run];
+		}
+		return run;
+	}
+
+	// Merge the trees of two runs, the later root going under the earlier, so a tree's root is always its first run.
+	void join(std::vector<std::uint32_t>& parent, std::uint32_t a, std::uint32_t b) {
+		a = find_root(parent, a);
+		b = find_root(parent, b);
+		if (a < b) parent[b] = a;
+		else if (b < a) parent[a] = b;
+	}
+
+	// Runs starting before a cell, from the run starts and the runs before each word.
+	std::uint32_t runs_before(const std::vector<std::uint64_t>& run_starts, const std::vector<std::uint32_t>& ranks, std::size_t index) {
+		const std::uint64_t below = run_starts[index >> 6] & ((std::uint64_t(1) << (index & 63)) - 1);
+		return ranks[index >> 6] + static_cast<std::uint32_t>(std::popcount(below));
+	}
+
+	// Join the runs of a row to the runs of the row above that share a column with them. The columns where both rows
+	// are floor come in stretches that each lie within one run of each row, or within pieces of one run cut at a block
+	// boundary, which are joined already. So one join per stretch is enough.
+	// Run numbers are counted along both rows 64 columns at a time, rather than looked up from the start per stretch.
+	void join_row(const std::vector<std::uint64_t>& walkable, const std::vector<std::uint64_t>& run_starts, const std::vector<std::uint32_t>& ranks,
+		std::vector<std::uint32_t>& parent, int row, int cols) {
+		const std::size_t row_start = static_cast<std::size_t>(row) * cols;
+		const std::size_t above_start = row_start - cols;
+		std::uint32_t run = runs_before(run_starts, ranks, row_start) - 1;         // Run of the row before the current 64 columns.
+		std::uint32_t above_run = runs_before(run_starts, ranks, above_start) - 1; // The same for the row above.
+		std::uint64_t carry = 0; // Whether the last column of the previous 64 was floor in both rows.
+		for (int pos = 0; pos < cols; pos += 64) {
+			const int length = std::min(64, cols - pos);
+			const std::uint64_t mask = length < 64 ? (std::uint64_t(1) << length) - 1 : ~std::uint64_t(0);
+			const std::uint64_t both = bits_at(walkable, row_start + pos) & bits_at(walkable, above_start + pos) & mask;
+			const std::uint64_t stretches = both & ~((both << 1) | carry);
+			const std::uint64_t starts = bits_at(run_starts, row_start + pos) & mask;
+			const std::uint64_t above_starts = bits_at(run_starts, above_start + pos) & mask;
+			carry = both >> 63;
+			for (std::uint64_t left = stretches; left != 0; left &= left - 1) {
+				const std::uint64_t up_to = left ^ (left - 1); // Columns up to and including the stretch's first.
+				join(parent, above_run + static_cast<std::uint32_t>(std::popcount(above_starts & up_to)),
+					run + static_cast<std::uint32_t>(std::popcount(starts & up_to)));
+			}
+			run += static_cast<std::uint32_t>(std::popcount(starts));
+			above_run += static_cast<std::uint32_t>(std::popcount(above_starts));
+		}
+	}
+}
+
+void label_components(const std::vector<std::uint64_t>& walkable, int rows, int cols, ComponentLabels& components, c_thread_pool* pool) {
+	constexpr std::size_t BLOCK_WORDS = ComponentLabels::BLOCK_WORDS;
+	const std::size_t block_count = (walkable.size() + BLOCK_WORDS - 1) / BLOCK_WORDS;
+	components.count = 0;
+	components.run_count = 0;
+	components.run_starts.resize(walkable.size());
+	components.run_ranks.resize(walkable.size());
+	components.block_labels.resize(block_count);
+	if (rows == 0 || cols == 0) return;
+
+	// A run starts on floor after a wall, or at the start of a row or a block, found 64 cells at a time. Counting
+	// the starts before each word numbers the runs in row-major order.
+	std::uint64_t previous = 0;
+	for (std::size_t word = 0; word < walkable.size(); ++word) {
+		const std::uint64_t carry = word % BLOCK_WORDS == 0 ? 0 : previous >> 63;
+		components.run_starts[word] = walkable[word] & ~((walkable[word] << 1) | carry);
+		previous = walkable[word];
+	}
+	for (int row = 1; row < rows; ++row) {
+		const std::size_t start = static_cast<std::size_t>(row) * cols;
+		components.run_starts[start >> 6] |= walkable[start >> 6] & (std::uint64_t(1) << (start & 63));
+	}
+	std::vector<std::uint32_t> ranks(walkable.size()); // Runs before each word over the whole map.
+	std::uint32_t run_count = 0;
+	for (std::size_t word = 0; word < walkable.size(); ++word) {
+		ranks[word] = run_count;
+		components.run_ranks[word] = static_cast<std::uint16_t>(run_count - ranks[word - word % BLOCK_WORDS]);
+		run_count += static_cast<std::uint32_t>(std::popcount(components.run_starts[word]));
+	}
+	std::vector<std::uint32_t> parent(run_count);
+	std::iota(parent.begin(), parent.end(), 0u);
+
+	// Join the pieces of runs cut where a block starts mid-row. Each pair is within one row, so within one band.
+	const std::size_t cell_count = static_cast<std::size_t>(rows) * cols;
+	for (std::size_t cell = ComponentLabels::BLOCK_CELLS; cell < cell_count; cell += ComponentLabels::BLOCK_CELLS) {
+		if (cell % cols != 0 && (walkable[cell >> 6] & 1) && (walkable[(cell - 1) >> 6] >> 63)) {
+			join(parent, ranks[cell >> 6] - 1, ranks[cell >> 6]);
+		}
+	}
+
+	// Union-find inside each row band, several bands per thread so a slow one doesn't hold the others up. A band's
+	// runs are numbered one after another, so each band only touches its own part of the parent array.
+	const std::size_t band_count = pool != nullptr ? std::min<std::size_t>(rows, static_cast<std::size_t>(pool->size()) * 4) : 1;
+	auto band_row = [&](std::size_t band) { return static_cast<int>(rows * band / band_count); };
+	auto join_band = [&](std::size_t band) {
+		for (int row = band_row(band) + 1; row < band_row(band + 1); ++row) join_row(walkable, components.run_starts, ranks, parent, row, cols);
+	};
+	if (pool == nullptr || band_count <= 1) {
+		join_band(0);
+	} else {
+		pool->parallel_for(band_count, 1, [&](unsigned, std::size_t first, std::size_t last) {
+			for (std::size_t band = first; band < last; ++band) join_band(band);
+		});
+	}
+	// Then stitch each band to the one above along the rows where they meet.
+	for (std::size_t band = 1; band < band_count; ++band) join_row(walkable, components.run_starts, ranks, parent, band_row(band), cols);
+
+	// Number the regions by their first run, in place of the parents. A run's parent always comes before it, so its
+	// label is already known. Then hand each block its runs' labels.
+	for (std::uint32_t run = 0; run < run_count; ++run) {
+		parent[run] = parent[run] == run ? components.count++ : parent[parent[run]];
+	}
+	for (std::size_t block = 0; block < block_count; ++block) {
+		const std::size_t first_word = block * BLOCK_WORDS;
+		const std::uint32_t first = ranks[first_word];
+		const std::uint32_t last = first_word + BLOCK_WORDS < walkable.size() ? ranks[first_word + BLOCK_WORDS] : run_count;
+		components.block_labels[block].assign(parent.begin() + first, parent.begin() + last);
+	}
+	components.run_count = run_count;
+}
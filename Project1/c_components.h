@@ -0,0 +1,118 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_components.h
+// Description : Connected-component labelling of a walkability bitset, with union-find over row bands across a thread pool.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class c_thread_pool;
+
+constexpr std::uint32_t NO_COMPONENT = 0xFFFFFFFFu; // Label of a wall cell, which belongs to no region.
+
+struct ComponentLabels { // The regions label_components finds, kept per run of floor along a row rather than per cell.
+	static constexpr std::size_t BLOCK_WORDS = 64;               // Words of run_starts per block.
+	static constexpr std::size_t BLOCK_CELLS = BLOCK_WORDS * 64; // Cells per block.
+
+	// A run is cut where a block starts, so an edit only renumbers the runs of its own block.
+	std::vector<std::uint64_t> run_starts;                // One bit per cell, set on the first cell of each run. Same layout as the walkability.
+	std::vector<std::uint16_t> run_ranks;                 // Runs starting in the earlier words of the same block, per word of run_starts.
+	std::vector<std::vector<std::uint32_t>> block_labels; // Region of each run starting in each block, in row-major order.
+	std::size_t run_count = 0;                            // Runs over all blocks.
+	std::uint32_t count = 0;                              // Number of regions, labelled 0 to count - 1.
+
+	/**
+	 * @brief Get the number of the run a floor cell is in within its block, O(1): the run starts of the block counted
+	 *        up to and including the cell.
+	 * @param index - Flat cell index, which must be floor.
+	 */
+	std::uint32_t run_of(std::size_t index) const {
+		const std::uint64_t up_to = run_starts[index >> 6] & (~std::uint64_t(0) >> (63 - (index & 63)));
+		return run_ranks[index >> 6] + static_cast<std::uint32_t>(std::popcount(up_to)) - 1;
+	}
+	/**
+	 * @brief Get the region of a floor cell.
+	 * @param index - Flat cell index, which must be floor.
+	 */
+	std::uint32_t label_of(std::size_t index) const { return block_labels[index / BLOCK_CELLS][run_of(index)]; }
+	std::uint32_t& label_of(std::size_t index) { return block_labels[index / BLOCK_CELLS][run_of(index)]; }
+	/**
+	 * @brief Get the memory held, in bytes.
+	 */
+	std::size_t memory_usage() const {
+		std::size_t bytes = run_starts.capacity() * sizeof(std::uint64_t) + run_ranks.capacity() * sizeof(std::uint16_t) +
+			block_labels.capacity() * sizeof(std::vector<std::uint32_t>);
+		for (const auto& labels : block_labels) bytes += labels.capacity() * sizeof(std::uint32_t);
+		return bytes;
+	}
+};
+
+struct ComponentScratch { // Scratch reused by edits that flood out to see whether a region was cut apart.
+	struct Word {             // 64 cells of flood marks, cleared on first use in each generation.
+		std::uint32_t stamp = 0;  // Generation the marks were last cleared in.
+		std::uint64_t reached = 0; // Set on cells a flood has reached.
+		std::uint64_t flood[2] = {}; // The two bits of the number of the flood that reached each cell first.
+	};
+	std::vector<Word> words;              // One per 64 cells, grown on first use.
+	std::uint32_t generation = 0;         // Current flood generation.
+	std::vector<int> reached[4];          // Cells each flood has reached, in order, doubling as its queue.
+	std::vector<std::uint32_t> renumber;  // New number per label when the labels are compacted.
+
+	/**
+	 * @brief Start a new set of floods over a graph with the specified number of cells, O(1) once grown.
+	 */
+	void begin(std::size_t cell_count) {
+		if (words.size() < (cell_count + 63) / 64) words.resize((cell_count + 63) / 64);
+		if (++generation == 0) { // Generation wrapped around, stale stamps could alias so clear them once.
+			std::fill(words.begin(), words.end(), Word{});
+			generation = 1;
+		}
+		for (auto& cells : reached) cells.clear();
+	}
+	/**
+	 * @brief Mark a cell reached by a flood unless one got there first.
+	 * @return -1 if the cell had not been reached yet, otherwise the flood that reached it first.
+	 */
+	int reach(int index, int flood) {
+		Word& word = words[static_cast<std::size_t>(index) >> 6];
+		if (word.stamp != generation) word = Word{ generation };
+		const std::uint64_t bit = std::uint64_t(1) << (index & 63);
+		if (word.reached & bit) return ((word.flood[0] & bit) ? 1 : 0) | ((word.flood[1] & bit) ? 2 : 0);
+		word.reached |= bit;
+		if (flood & 1) word.flood[0] |= bit;
+		if (flood & 2) word.flood[1] |= bit;
+		return -1;
+	}
+	std::size_t memory_usage() const {
+		std::size_t bytes = words.capacity() * sizeof(Word) + renumber.capacity() * sizeof(std::uint32_t);
+		for (const auto& cells : reached) bytes += cells.capacity() * sizeof(int);
+		return bytes;
+	}
+};
+
+/**
+ * @brief Label the regions of floor cells joined by up, down, left and right steps.
+ * @param walkable   - One bit per cell, row-major, set if the cell is not a wall. Same layout as MapScan and c_graph.
+ * @param rows       - Number of rows.
+ * @param cols       - Number of columns.
+ * @param components - Filled in, its buffers are reused. Regions are numbered from 0 in the order their first cells
+ *                     appear row by row.
+ * @param pool       - Pool to run the row bands on, or null to run them one after another on this thread.
+ * @note  These are also the regions of 8-way movement: a diagonal step may not cut a corner, so there is always a
+ *        straight two-step route beside it. Runs of floor along the rows are found 64 cells at a time, each band
+ *        joins the runs that touch the row above with union-find, then the bands are stitched together where they
+ *        meet, so the labels are the same for any thread count. Nothing is kept per cell but the run start bits and
+ *        a count per word, under two bits a cell on top of four bytes a run. Runs are cut at block boundaries too, and
+ *        the pieces joined, so a run never spans two blocks.
+ */
+void label_components(const std::vector<std::uint64_t>& walkable, int rows, int cols, ComponentLabels& components, c_thread_pool* pool = nullptr);
@@ -0,0 +1,237 @@
+#include "c_dstar_lite.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+	constexpr int INFINITE_COST = std::numeric_limits<int>::max() / 4; // Stays finite when a key is added on top.
+	constexpr int DIRECTIONS[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+
+	int add_cost(int a, int b) {
+		return (a >= INFINITE_COST || b >= INFINITE_COST) ? INFINITE_COST : a + b;
+	}
+}
+
+c_dstar_lite::c_dstar_lite(c_graph& graph)
+	: graph_(graph) {
+}
+
+c_dstar_lite::Vertex& c_dstar_lite::vertex(int cell) {
+	Vertex& v = vertices_[cell];
+	if (v.seen_gen != generation_) {
+		v = { INFINITE_COST, INFINITE_COST, 0, 0, false, generation_ };
+	}
+	return v;
+}
+
+int c_dstar_lite::g(int cell) const {
+	return vertices_[cell].seen_gen == generation_ ? vertices_[cell].g : INFINITE_COST;
+}
+
+int c_dstar_lite::rhs(int cell) const {
+	return vertices_[cell].seen_gen == generation_ ? vertices_[cell].rhs : INFINITE_COST;
+}
+
+int c_dstar_lite::heuristic(int cell) const {
+	const int cols = graph_.cols();
+	return std::abs(cell / cols - start_ / cols) + std::abs(cell % cols - start_ % cols);
+}
+
+int c_dstar_lite::edge_cost(int from, int to) const {
+	return graph_.is_walkable(from) && graph_.is_walkable(to) ? 1 : INFINITE_COST;
+}
+
+int c_dstar_lite::lookahead(int cell) const {
+	const int x = cell / graph_.cols();
+	const int y = cell % graph_.cols();
+	int best = INFINITE_COST;
+	for (const auto& dir : DIRECTIONS) {
+		const int nx = x + dir[0];
+		const int ny = y + dir[1];
+		if (nx < 0 || nx >= graph_.rows() || ny < 0 || ny >= graph_.cols()) continue;
+		const int neighbor = graph_.cell_index(nx, ny);
+		best = std::min(best, add_cost(edge_cost(cell, neighbor), g(neighbor)));
+	}
+	return best;
+}
+
+std::pair<int, int> c_dstar_lite::calculate_key(int cell) const {
+	const int shortest = std::min(g(cell), rhs(cell));
+	return { add_cost(add_cost(shortest, heuristic(cell)), key_modifier_), shortest };
+}
+
+void c_dstar_lite::update_vertex(int cell) {
+	Vertex& v = vertex(cell);
+	if (v.g == v.rhs) {
+		v.open = false; // Any queue entry left behind is skipped when popped.
+		return;
+	}
+	const auto [key1, key2] = calculate_key(cell);
+	if (v.open && v.key1 == key1 && v.key2 == key2) return; // Already queued with this key.
+	v.key1 = key1;
+	v.key2 = key2;
+	v.open = true;
+	queue_.push_back({ key1, key2, cell });
+	std::push_heap(queue_.begin(), queue_.end(), QueueEntryComparator());
+}
+
+void c_dstar_lite::reset(const Node& start, const Node& goal) {
+	const std::size_t cell_count = static_cast<std::size_t>(graph_.rows()) * graph_.cols();
+	if (vertices_.size() < cell_count) {
+		vertices_.resize(cell_count, Vertex{ INFINITE_COST, INFINITE_COST, 0, 0, false, 0 });
+	}
+	if (++generation_ == 0) { // Generation wrapped around, stale stamps could alias so clear them once.
+		std::fill(vertices_.begin(), vertices_.end(), Vertex{ INFINITE_COST, INFINITE_COST, 0, 0, false, 0 });
+		generation_ = 1;
+	}
+	queue_.clear();
+	start_ = graph_.cell_index(start.x, start.y);
+	goal_ = graph_.cell_index(goal.x, goal.y);
+	key_modifier_ = 0;
+
+	// The search grows backwards from the goal.
+	vertex(goal_).rhs = 0;
+	update_vertex(goal_);
+}
+
+void c_dstar_lite::move_start(const Node& start) {
+	const int cell = graph_.cell_index(start.x, start.y);
+	// Keys already in the queue were computed from the old start, raise new keys by the distance moved so the
+	// old ones stay lower bounds whether or not an edit comes before the next compute_path.
+	if (goal_ >= 0) key_modifier_ += heuristic(cell);
+	start_ = cell;
+}
+
+void c_dstar_lite::set_walkable(int x, int y, bool walkable) {
+	if (x < 0 || x >= graph_.rows() || y < 0 || y >= graph_.cols()) {
+		throw std::out_of_range("Node position out of range");
+	}
+	const int cell = graph_.cell_index(x, y);
+	if (graph_.is_walkable(cell) == walkable) return;
+	graph_.set_walkable(x, y, walkable);
+	if (goal_ < 0) return; // No search to repair yet.
+
+	// Every edge touching the cell changed cost, so the cell and its neighbours need a new rhs.
+	if (cell != goal_) {
+		vertex(cell).rhs = lookahead(cell);
+		update_vertex(cell);
+	}
+	for (const auto& dir : DIRECTIONS) {
+		const int nx = x + dir[0];
+		const int ny = y + dir[1];
+		if (nx < 0 || nx >= graph_.rows() || ny < 0 || ny >= graph_.cols()) continue;
+		const int neighbor = graph_.cell_index(nx, ny);
+		if (neighbor == goal_) continue;
+		vertex(neighbor).rhs = lookahead(neighbor);
+		update_vertex(neighbor);
+	}
+}
+
+bool c_dstar_lite::compute_path() {
+	expansions_ = 0;
+	while (!queue_.empty()) {
+		const QueueEntry top = queue_.front();
+		const Vertex& current = vertices_[top.cell];
+		if (current.seen_gen != generation_ || !current.open || current.key1 != top.key1 || current.key2 != top.key2) {
+			// Superseded entry.
+			std::pop_heap(queue_.begin(), queue_.end(), QueueEntryComparator());
+			queue_.pop_back();
+			continue;
+		}
+
+		// Stop once nothing in the queue can improve the start and the start is consistent.
+		const auto start_key = calculate_key(start_);
+		const bool below_start = top.key1 != start_key.first ? top.key1 < start_key.first : top.key2 < start_key.second;
+		if (!below_start && rhs(start_) == g(start_)) break;
+
+		std::pop_heap(queue_.begin(), queue_.end(), QueueEntryComparator());
+		queue_.pop_back();
+		const int cell = top.cell;
+		Vertex& v = vertex(cell);
+		v.open = false;
+
+		// The start moved since the key was computed, requeue with the up to date key.
+		const auto [key1, key2] = calculate_key(cell);
+		if (top.key1 < key1 || (top.key1 == key1 && top.key2 < key2)) {
+			update_vertex(cell);
+			continue;
+		}
+
+		++expansions_;
+		const int x = cell / graph_.cols();
+		const int y = cell % graph_.cols();
+		if (v.g > v.rhs) {
+			// Overconsistent: the distance went down, pass the improvement on to the predecessors.
+			v.g = v.rhs;
+			for (const auto& dir : DIRECTIONS) {
+				const int nx = x + dir[0];
+				const int ny = y + dir[1];
+				if (nx < 0 || nx >= graph_.rows() || ny < 0 || ny >= graph_.cols()) continue;
+				const int neighbor = graph_.cell_index(nx, ny);
+				if (neighbor == goal_) continue;
+				Vertex& n = vertex(neighbor);
+				n.rhs = std::min(n.rhs, add_cost(edge_cost(neighbor, cell), v.g));
+				update_vertex(neighbor);
+			}
+		} else {
+			// Underconsistent: the distance went up, predecessors that relied on it recompute their rhs.
+			const int old_g = v.g;
+			v.g = INFINITE_COST;
+			if (cell != goal_) {
+				v.rhs = lookahead(cell);
+			}
+			update_vertex(cell);
+			for (const auto& dir : DIRECTIONS) {
+				const int nx = x + dir[0];
+				const int ny = y + dir[1];
+				if (nx < 0 || nx >= graph_.rows() || ny < 0 || ny >= graph_.cols()) continue;
+				const int neighbor = graph_.cell_index(nx, ny);
+				if (neighbor == goal_ || rhs(neighbor) != add_cost(edge_cost(neighbor, cell), old_g)) continue;
+				vertex(neighbor).rhs = lookahead(neighbor);
+				update_vertex(neighbor);
+			}
+		}
+	}
+	return rhs(start_) < INFINITE_COST;
+}
+
+std::vector<std::pair<int, int>> c_dstar_lite::path() const {
+	std::vector<std::pair<int, int>> result;
+	path(result);
+	return result;
+}
+
+bool c_dstar_lite::path(std::vector<std::pair<int, int>>& path) const {
+	if (start_ < 0 || rhs(start_) >= INFINITE_COST) return false;
+
+	// Walk downhill in g from the start, every step lowers the distance to the goal by one.
+	const std::size_t first = path.size();
+	const int cols = graph_.cols();
+	int current = start_;
+	path.emplace_back(current / cols, current % cols);
+	while (current != goal_) {
+		const int x = current / cols;
+		const int y = current % cols;
+		int best = -1;
+		int best_cost = INFINITE_COST;
+		for (const auto& dir : DIRECTIONS) {
+			const int nx = x + dir[0];
+			const int ny = y + dir[1];
+			if (nx < 0 || nx >= graph_.rows() || ny < 0 || ny >= graph_.cols()) continue;
+			const int neighbor = graph_.cell_index(nx, ny);
+			const int cost = add_cost(edge_cost(current, neighbor), g(neighbor));
+			if (cost < best_cost) {
+				best_cost = cost;
+				best = neighbor;
+			}
+		}
+		if (best < 0 || path.size() - first > vertices_.size()) { // Only reachable if compute_path was skipped.
+			path.resize(first);
+			return false;
+		}
+		current = best;
+		path.emplace_back(current / cols, current % cols);
+	}
+	return true;
+}
@@ -0,0 +1,112 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_dstar_lite.h
+// Description : Incremental replanning (D* Lite) on a c_graph whose cells change at runtime.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "c_graph.h"
+
+/**
+ * @brief D* Lite planner for an agent moving towards a fixed goal while cells open and close.
+ * @note  The search runs backwards from the goal, so when a cell changes only the vertices whose
+ *        distance to the goal actually changed are repaired, and moving the start costs nothing.
+ *        Movement is 4-way with unit costs, the same as the default a_star.
+ */
+class c_dstar_lite {
+public:
+	/**
+	 * @brief Create a planner for the specified graph.
+	 * @param graph - The graph to plan on, must outlive the planner. Edit it through set_walkable
+	 *                so the planner sees the change.
+	 */
+	explicit c_dstar_lite(c_graph& graph);
+
+	/**
+	 * @brief Start a new problem, discarding the previous search.
+	 */
+	void reset(const Node& start, const Node& goal);
+	/**
+	 * @brief Move the agent. The next compute_path plans from the new cell, with or without edits in between.
+	 */
+	void move_start(const Node& start);
+	/**
+	 * @brief Turn a cell into a wall or back into floor, on the graph and in the planner's state.
+	 * @param x        - The x-coordinate (row) of the cell.
+	 * @param y        - The y-coordinate (column) of the cell.
+	 * @param walkable - True for floor, false for a wall.
+	 * @note  Only marks the cell and its neighbours for repair, the work is done by the next compute_path.
+	 */
+	void set_walkable(int x, int y, bool walkable);
+
+	/**
+	 * @brief Bring the search up to date with the moves and edits since the last call.
+	 * @return True if a path from the start to the goal exists.
+	 */
+	bool compute_path();
+	/**
+	 * @brief Get the current path from the start to the goal, call after compute_path.
+	 * @return A vector of pairs representing the path, empty if no path exists.
+	 */
+	std::vector<std::pair<int, int>> path() const;
+	/**
+	 * @brief Get the current path, appending it to a caller-owned buffer.
+	 * @return True if a path exists, the buffer is left unchanged otherwise.
+	 */
+	bool path(std::vector<std::pair<int, int>>& path) const;
+
+	std::size_t expansions() const { return expansions_; } // Vertices expanded by the last compute_path.
+
+private:
+	struct Vertex {
+		int g;                  // Distance to the goal as of the last expansion.
+		int rhs;                // One-step lookahead distance, g + edge cost of the best successor.
+		int key1, key2;         // Queue key while open.
+		bool open;              // In the priority queue with key (key1, key2).
+		std::uint32_t seen_gen; // Generation in which the vertex was written, older ones read as unvisited.
+	};
+
+	struct QueueEntry {
+		int key1, key2;
+		int cell;
+	};
+
+	struct QueueEntryComparator { // Min-heap ordering on (key1, key2).
+		bool operator()(const QueueEntry& a, const QueueEntry& b) const {
+			return a.key1 != b.key1 ? a.key1 > b.key1 : a.key2 > b.key2;
+		}
+	};
+
+	c_graph& graph_;
+	std::vector<Vertex> vertices_; // One per cell, stamped with generation_ like c_search_state.
+	std::vector<QueueEntry> queue_; // Binary heap, superseded entries are skipped when popped.
+	std::uint32_t generation_ = 0;
+	int start_ = -1;
+	int goal_ = -1;
+	int key_modifier_ = 0; // D* Lite's k_m: heuristic distance the start has moved since the search began.
+	std::size_t expansions_ = 0;
+
+	Vertex& vertex(int cell); // Get a vertex for writing, initializing it if it belongs to an older generation.
+	int g(int cell) const;
+	int rhs(int cell) const;
+	int heuristic(int cell) const; // Manhattan distance from the start.
+	int edge_cost(int from, int to) const;
+	/**
+	 * @brief Recompute rhs from the cell's successors.
+	 */
+	int lookahead(int cell) const;
+	/**
+	 * @brief Put the vertex in the queue if it is inconsistent (g != rhs), take it out otherwise.
+	 */
+	void update_vertex(int cell);
+	std::pair<int, int> calculate_key(int cell) const;
+};
@@ -1,32 +1,62 @@
 ﻿#include "c_dungeon_map.h"
 #include "c_graph.h"
+#include "c_binary_map.h"
+#include "c_components.h"
 #include <iostream>
 #include <fstream>
 #include <stdexcept>
-#include <unordered_set>
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <cstdint>
+#include <string_view>
 
-// ANSI escape codes for colors.
-const std::string RESET = "\033[0m";
-const std::string GREY = "\033[90m";
-const std::string GREEN = "\033[32m";
-const std::string YELLOW = "\033[33m";
-const std::string BLACK = "\033[30m";
+namespace {
+	// ANSI escape codes for colors, indexed by colour.
+	enum colour : std::uint8_t { RESET, GREY, GREEN, YELLOW, BLACK, BROWN, BLUE, WHITE };
+	constexpr std::string_view COLOUR_CODES[] = {
+		"\033[0m",       // RESET, also used for cells without a colour.
+		"\033[90m",      // GREY, walls.
+		"\033[32m",      // GREEN, start, exit and path.
+		"\033[33m",      // YELLOW, items.
+		"\033[30m",      // BLACK, floor.
+		"\033[38;5;94m", // BROWN, mud.
+		"\033[34m",      // BLUE, water.
+		"\033[97m",      // WHITE, road.
+	};
 
+	// Colour of every cell character, looked up once per cell instead of a chain of comparisons.
+	constexpr std::array<std::uint8_t, 256> CELL_COLOURS = [] {
+		std::array<std::uint8_t, 256> colours{};
+		colours['s'] = colours['x'] = colours['p'] = GREEN;
+		colours['w'] = GREY;
+		colours['.'] = BLACK;
+		colours['r'] = WHITE;
+		colours['m'] = BROWN;
+		colours['~'] = BLUE;
+		for (char item = 'a'; item <= 'j'; ++item) colours[static_cast<unsigned char>(item)] = YELLOW;
+		return colours;
+	}();
 
-constexpr int MAP_SIZE = 20;
+	// Which cell a downsampled block shows if it holds several special cells, higher wins. 0 for plain cells.
+	constexpr std::array<std::uint8_t, 256> BLOCK_PRIORITY = [] {
+		std::array<std::uint8_t, 256> priority{};
+		for (char item = 'a'; item <= 'j'; ++item) priority[static_cast<unsigned char>(item)] = 1;
+		priority['p'] = 2;
+		priority['x'] = 3;
+		priority['s'] = 4;
+		return priority;
+	}();
+}
 
-c_dungeon_map::c_dungeon_map() {
-	map_.resize(MAP_SIZE, std::vector<char>(MAP_SIZE, '.')); // Initialize with empty cells.
 
-	// Set walls around the outside.
-	for (int i = 0; i < MAP_SIZE; ++i) {
-		map_[0][i] = 'w'; // Top row.
-		map_[MAP_SIZE - 1][i] = 'w'; // Bottom row.
-		map_[i][0] = 'w'; // Left column.
-		map_[i][MAP_SIZE - 1] = 'w'; // Right column.
-	}
+constexpr int EMPTY_MAP_SIZE = 20;          // Size of the empty map shown when no map is loaded.
+constexpr std::size_t READ_CHUNK = 1 << 20; // Bytes read from the map file per chunk.
+
+c_dungeon_map::c_dungeon_map() {
+	reset_to_empty(EMPTY_MAP_SIZE);
 }
 
 c_dungeon_map::c_dungeon_map(const std::string& filename) : original_filename_(filename) {
@@ -34,105 +64,212 @@ c_dungeon_map::c_dungeon_map(const std::string& filename) : original_filename_(f
 	verify_map();
 }
 
+void c_dungeon_map::reset_to_empty(int size) {
+	rows_ = size;
+	cols_ = size;
+	map_.assign(static_cast<std::size_t>(size) * size, '.'); // Initialize with empty cells.
+
+	// Set walls around the outside.
+	for (int i = 0; i < size; ++i) {
+		map_[i] = 'w';                                                      // Top row.
+		map_[static_cast<std::size_t>(size - 1) * size + i] = 'w';          // Bottom row.
+		map_[static_cast<std::size_t>(i) * size] = 'w';                     // Left column.
+		map_[static_cast<std::size_t>(i) * size + size - 1] = 'w';          // Right column.
+	}
+	index_map();
+	reachability_ = MapReachability{};
+}
+
+void c_dungeon_map::index_map() {
+	scan_map(map_.data(), map_.size(), scan_);
+	cache_positions();
+}
+
+void c_dungeon_map::cache_positions() {
+	start_index_ = -1;
+	end_index_ = -1;
+	item_index_.fill(-1);
+	for (const auto& [index, ch] : scan_.specials) { // Sorted by index, so the first of each wins.
+		int& cached = ch == 's' ? start_index_ : ch == 'x' ? end_index_ : item_index_[ch - 'a'];
+		if (cached < 0) cached = index;
+	}
+}
+
+void c_dungeon_map::find_reachability() {
+	reachability_ = MapReachability{};
+	if (start_index_ < 0) return;
+	ComponentLabels components;
+	label_components(scan_.walkable, rows_, cols_, components);
+	auto reachable = [&](int index) { return index >= 0 && components.label_of(index) == components.label_of(start_index_); };
+	reachability_.exit = reachable(end_index_);
+	for (int i = 0; i < 10; ++i) reachability_.items[i] = reachable(item_index_[i]);
+}
+
 void c_dungeon_map::load_map(const std::string& filename) {
     // Strip quotation marks from the filename
     std::string clean_filename = filename;
     clean_filename.erase(remove(clean_filename.begin(), clean_filename.end(), '\"'), clean_filename.end());
 
     // Open the file, throw an exception if it fails.
-    std::ifstream file(clean_filename);
+    std::ifstream file(clean_filename, std::ios::binary);
     if (!file.is_open()) {
         throw std::runtime_error("Unable to open file");
     }
 
-    // Read the map data into 'map_' vector.
-    map_.resize(MAP_SIZE, std::vector<char>(MAP_SIZE));
-    for (int i = 0; i < MAP_SIZE; ++i) {     // Rows.
-        for (int j = 0; j < MAP_SIZE; ++j) { // Columns.
-            file >> map_[i][j];              // Read char into map_.
-        }
-    }
+    // Reserve the whole map up front, the cell count is at most the file size.
+    file.seekg(0, std::ios::end);
+    const std::streamoff file_size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    map_.clear();
+    map_.reserve(file_size > 0 ? static_cast<std::size_t>(file_size) : 0);
 
-    // Verify the map after loading
+    // Read the file in large chunks, appending cells row by row and skipping whitespace.
+    std::vector<char> chunk(READ_CHUNK);
+    std::size_t row_start = 0; // Index in map_ where the current row started.
+    int rows = 0;
+    int cols = 0;
+    auto end_row = [&] {
+        const std::size_t width = map_.size() - row_start;
+        if (width == 0) return; // Blank line.
+        if (rows == 0) {
+            cols = static_cast<int>(width);
+        } else if (width != static_cast<std::size_t>(cols)) {
+            throw std::runtime_error("Map rows must all have the same width");
+        }
+        ++rows;
+        row_start = map_.size();
+    };
     try {
+        while (file) {
+            file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            const char* pos = chunk.data();
+            const char* const end = pos + file.gcount();
+            while (pos < end) {
+                // Take everything up to the next newline (or the end of the chunk) as one span.
+                const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+                const char* span_end = newline ? newline : end;
+                const auto is_space = [](char ch) { return ch == ' ' || ch == '\r' || ch == '\t'; };
+                if (std::none_of(pos, span_end, is_space)) {
+                    map_.insert(map_.end(), pos, span_end); // Compact format, copy the whole span at once.
+                } else {
+                    std::remove_copy_if(pos, span_end, std::back_inserter(map_), is_space);
+                }
+                if (newline) end_row();
+                pos = span_end + 1;
+            }
+        }
+        end_row(); // Last row may not end with a newline.
+        if (rows == 0) {
+            throw std::runtime_error("Map file is empty");
+        }
+        rows_ = rows;
+        cols_ = cols;
+
+        // Scan and verify the map after loading, then see what the start can reach.
+        index_map();
         verify_map();
+        find_reachability();
     }
     catch (const std::exception& e) {
         // Log the exception message
         std::cerr << "Error verifying map: " << e.what() << '\n';
 
-        // If verification fails, reset to an empty map and rethrow the exception
-        map_.clear();
-        map_.resize(MAP_SIZE, std::vector<char>(MAP_SIZE, '.'));
-        // Set walls around the outside.
-        for (int i = 0; i < MAP_SIZE; ++i) {
-            map_[0][i] = 'w'; // Top row.
-            map_[MAP_SIZE - 1][i] = 'w'; // Bottom row.
-            map_[i][0] = 'w'; // Left column.
-            map_[i][MAP_SIZE - 1] = 'w'; // Right column.
-        }
+        // If loading or verification fails, reset to an empty map and rethrow the exception
+        reset_to_empty(EMPTY_MAP_SIZE);
         throw;
     }
 }
 
 void c_dungeon_map::verify_map() const
 {
-	// Start + end point counters, and a set to store items.
+	// Everything needed was recorded by scan_map when the cells were loaded.
+	if (scan_.invalid_count > 0) {
+		throw std::runtime_error("Invalid character in map");
+	}
+
+	// Count start/end points and unique items.
 	int start_count = 0;
 	int end_count = 0;
-	std::unordered_set<char> items;
-
-	for (const auto& row : map_) { // Iterate over rows.
-		for (char cell : row) { // For each cell in the row:
-			// Count start/end points and store items.
-			if (cell == 's') start_count++;
-			if (cell == 'x') end_count++;
-			if (cell >= 'a' && cell <= 'j') items.insert(cell);
-			// Check for invalid characters.
-			if (cell != 'w' && cell != '.' && cell != 's' && cell != 'x' && (cell < 'a' || cell > 'j')) {
-				throw std::runtime_error("Invalid character in map");
-			}
-		}
+	for (const auto& special : scan_.specials) {
+		if (special.second == 's') start_count++;
+		if (special.second == 'x') end_count++;
 	}
+	const int item_count = static_cast<int>(std::count_if(item_index_.begin(), item_index_.end(), [](int index) { return index >= 0; }));
 
 	// Check for invalid counts.
 	if (start_count != 1 || end_count != 1) {
 		throw std::runtime_error("Map must contain exactly one start point and one end point");
 	}
-	if (items.size() != 10) {
+	if (item_count != 10) {
 		throw std::runtime_error("Map must contain exactly 10 unique items (a-j)");
 	}
 }
 
 void c_dungeon_map::display_map() const {
-    // Iterate over each row in the map.
-    for (const auto& row : map_) {
-        // Print cell char + padding for each cell in the row.
-        for (char cell : row) {
-            // Coloring.
-            switch (cell) {
-                case 's':
-                case 'x':
-                case 'p':
-                    std::cout << GREEN << cell << ' ' << RESET;
-                    break;
-                case 'w':
-                    std::cout << GREY << cell << ' ' << RESET;
-                    break;
-                case '.':
-                    std::cout << BLACK << cell << ' ' << RESET;
-                    break;
-                default:
-                    if (cell >= 'a' && cell <= 'j') {
-                        std::cout << YELLOW << cell << ' ' << RESET;
-                    } else {
-                        std::cout << cell << ' ';
-                    }
-                    break;
+    display_map(MapViewport{});
+}
+
+void c_dungeon_map::display_map(const MapViewport& viewport) const {
+    render_map(frame_, viewport);
+    std::cout.write(frame_.data(), static_cast<std::streamsize>(frame_.size()));
+    std::cout.flush();
+}
+
+void c_dungeon_map::render_map(std::string& frame, const MapViewport& viewport) const {
+    frame.clear();
+    const int step = std::max(1, viewport.step);
+    const int top = std::clamp(viewport.top, 0, rows_);
+    const int left = std::clamp(viewport.left, 0, cols_);
+    const int bottom = viewport.rows > 0 ? std::min(rows_, top + viewport.rows) : rows_;
+    const int right = viewport.cols > 0 ? std::min(cols_, left + viewport.cols) : cols_;
+    const std::size_t shown_rows = static_cast<std::size_t>(bottom - top + step - 1) / step;
+    const std::size_t shown_cols = static_cast<std::size_t>(right - left + step - 1) / step;
+    frame.reserve(shown_rows * (shown_cols * 2 + 1) + 64); // Every cell plus its padding, colour codes grow it as needed.
+
+    std::uint8_t current = RESET;
+    for (int i = top; i < bottom; i += step) {
+        for (int j = left; j < right; j += step) {
+            const char cell = step == 1 ? this->cell(i, j) : block_cell(i, j, step);
+            // Coloring, only where it changes.
+            const std::uint8_t wanted = CELL_COLOURS[static_cast<unsigned char>(cell)];
+            if (wanted != current) {
+                frame += COLOUR_CODES[wanted];
+                current = wanted;
             }
+            frame += cell;
+            frame += ' ';
         }
-        std::cout << '\n'; // Newline after each row.
+        frame += '\n'; // Newline after each row.
     }
+    if (current != RESET) frame += COLOUR_CODES[RESET];
+}
+
+MapViewport c_dungeon_map::fit_viewport(int max_rows, int max_cols) const {
+    MapViewport viewport;
+    const int rows_step = (rows_ + std::max(1, max_rows) - 1) / std::max(1, max_rows);
+    const int cols_step = (cols_ + std::max(1, max_cols) - 1) / std::max(1, max_cols);
+    viewport.step = std::max({ 1, rows_step, cols_step });
+    return viewport;
+}
+
+char c_dungeon_map::block_cell(int top, int left, int step) const {
+    const int bottom = std::min(rows_, top + step);
+    const int right = std::min(cols_, left + step);
+    char special = 0;
+    int counts[5] = {}; // Walls, floor, road, mud, water.
+    const char plain[5] = { 'w', '.', 'r', 'm', '~' };
+    for (int i = top; i < bottom; ++i) {
+        for (int j = left; j < right; ++j) {
+            const char cell = this->cell(i, j);
+            if (BLOCK_PRIORITY[static_cast<unsigned char>(cell)] > BLOCK_PRIORITY[static_cast<unsigned char>(special)]) {
+                special = cell;
+            }
+            for (int k = 0; k < 5; ++k) counts[k] += cell == plain[k];
+        }
+    }
+    if (special != 0) return special;
+    const int most = static_cast<int>(std::max_element(counts, counts + 5) - counts);
+    return counts[most] > 0 ? plain[most] : cell(top, left);
 }
 
 void c_dungeon_map::save_map(const std::string& new_filename) const {
@@ -151,54 +288,95 @@ void c_dungeon_map::save_map(const std::string& new_filename) const {
         throw std::runtime_error("Unable to open file for writing");
     }
 
-    // Write the map data to the file.
-    for (const auto& row : map_) {
-        for (char cell : row) {
-            file << cell << ' ';
+    // Write the map data to the file, each row built in one buffer and written in one go.
+    std::string row(static_cast<std::size_t>(cols_) * 2 + 1, ' ');
+    row.back() = '\n';
+    for (int i = 0; i < rows_; ++i) {
+        for (int j = 0; j < cols_; ++j) {
+            row[static_cast<std::size_t>(j) * 2] = cell(i, j); // The padding spaces stay in place.
         }
-        file << '\n';
+        file.write(row.data(), static_cast<std::streamsize>(row.size()));
+    }
+    if (!file) {
+        throw std::runtime_error("Unable to write " + filepath);
     }
 
     // Close the file.
     file.close();
 }
 
+void c_dungeon_map::save_binary_map(const std::string& filename) const {
+    c_binary_map::save(filename, map_.data(), rows_, cols_);
+}
+
+void c_dungeon_map::load_binary_map(const std::string& filename) {
+    // Map the file and copy the cells out of it in one go, for display and mark_path.
+    c_binary_map binary(filename);
+    map_.assign(binary.cells(), binary.cells() + static_cast<std::size_t>(binary.rows()) * binary.cols());
+    rows_ = binary.rows();
+    cols_ = binary.cols();
+    original_filename_ = filename;
+
+    // Take the scan from the file's bitset and header where it has them, then verify, same as load_map.
+    try {
+        binary.scan(scan_);
+        cache_positions();
+        verify_map();
+        find_reachability();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error verifying map: " << e.what() << '\n';
+        reset_to_empty(EMPTY_MAP_SIZE);
+        throw;
+    }
+}
+
 c_graph c_dungeon_map::to_graph() const {
-    return {map_};
+    return { map_.data(), rows_, cols_, scan_ }; // Reuses the scan, so the cells are not classified twice.
 }
 
-std::pair<int, int> c_dungeon_map::get_start_node() const {
-	// Iterate over the map to find the start node.
-	for (int i = 0; i < MAP_SIZE; ++i) {
-		for (int j = 0; j < MAP_SIZE; ++j) {
-			if (map_[i][j] == 's') {
-				return { i, j };
-			}
-		}
+c_graph c_dungeon_map::to_graph(c_thread_pool& pool) const {
+    return { map_.data(), rows_, cols_, scan_, pool };
+}
+
+std::pair<int, int> c_dungeon_map::cached_position(int index, const char* missing) const {
+	if (index < 0) {
+		throw std::runtime_error(missing);
 	}
-	throw std::runtime_error("Start node not found");
+	return { index / cols_, index % cols_ };
+}
+
+std::pair<int, int> c_dungeon_map::get_start_node() const {
+	return cached_position(start_index_, "Start node not found");
 }
 
 std::pair<int, int> c_dungeon_map::get_end_node() const {
-	// Iterate over the map to find the end node.
-	for (int i = 0; i < MAP_SIZE; ++i) {
-		for (int j = 0; j < MAP_SIZE; ++j) {
-			if (map_[i][j] == 'x') {
-				return { i, j };
-			}
-		}
+	return cached_position(end_index_, "End node not found");
+}
+
+std::pair<int, int> c_dungeon_map::get_item_node(char item) const {
+	if (item < 'a' || item > 'j' || item_index_[item - 'a'] < 0) {
+		throw std::out_of_range(std::string("Item not found: ") + item);
 	}
-	throw std::runtime_error("End node not found");
+	return cached_position(item_index_[item - 'a'], "Item not found");
 }
 
 void c_dungeon_map::mark_path(const std::vector<std::pair<int, int>>& path) {
     // Iterate over the path coordinates and update the map.
+    bool items_changed = false;
     for (const auto& coord : path) {
-        int x = coord.first;
-        int y = coord.second;
+        const std::size_t index = static_cast<std::size_t>(coord.first) * cols_ + coord.second;
+        char& cell = map_[index];
         // Update the cells between the start and end points.
-        if (map_[x][y] != 's' && map_[x][y] != 'x') {
-            map_[x][y] = 'p';
+        if (cell == 's' || cell == 'x' || cell == 'p') continue;
+        // Keep the scan in step: 'p' is not a map character, and an item under the path is gone.
+        if (cell >= 'a' && cell <= 'j') {
+            const auto it = std::lower_bound(scan_.specials.begin(), scan_.specials.end(), std::make_pair(static_cast<int>(index), cell));
+            scan_.specials.erase(it);
+            items_changed = true;
         }
+        if (scan_.invalid_count++ == 0 || index < scan_.first_invalid) scan_.first_invalid = index;
+        cell = 'p';
     }
+    if (items_changed) cache_positions();
 }
\ No newline at end of file
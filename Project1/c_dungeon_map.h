@@ -10,9 +10,24 @@
 // Mail : Foster.Rae@mds.ac.nz
 // ************************************************************************/
 #pragma once
+#include <array>
 #include <vector>
 #include <string>
 #include "c_graph.h"
+#include "c_map_scan.h"
+
+struct MapViewport { // The part of the map display_map shows, optionally downsampled.
+	int top = 0;  // First map row shown.
+	int left = 0; // First map column shown.
+	int rows = 0; // Map rows covered, 0 for every row from top down.
+	int cols = 0; // Map columns covered, 0 for every column from left across.
+	int step = 1; // Each cell shown stands for a step x step block of map cells.
+};
+
+struct MapReachability { // Which of the exit and items a search from the start can get to.
+	bool exit = false;            // Whether the exit is in the start's region.
+	std::array<bool, 10> items{}; // The same for items 'a' - 'j'.
+};
 
 class c_dungeon_map
 {
@@ -31,48 +46,146 @@ public:
 	/**
 	 * @brief Load a new map from a file.
 	 * @param filename - The name of the file to load.
-	 * @note  Called by the constructor.
+	 * @note  Called by the constructor. The dimensions are taken from the file: every non-empty line is a row,
+	 *        spaces are ignored, and all rows must have the same width.
 	 */
 	void load_map(const std::string& filename);
 	/**
 	 * @brief Verify the map data.
-	 * @note  Called by the constructor.
+	 * @note  Called by the constructor. Besides walls ('w'), the start, the exit and the items, cells may hold
+	 *        any terrain class from c_terrain.h: road ('r'), floor ('.'), mud ('m') or water ('~').
+	 *        Checks the scan taken when the cells were loaded (see c_map_scan.h), so it does not read the cells again.
 	 */
 	void verify_map() const;
 	/**
 	 * @brief Display the map data.
 	 */
 	void display_map() const;
+	/**
+	 * @brief Display part of the map, or all of it downsampled, see MapViewport.
+	 * @note  The frame is built in a buffer kept between calls and written to std::cout in one go.
+	 */
+	void display_map(const MapViewport& viewport) const;
+	/**
+	 * @brief Build what display_map shows into a buffer, without writing it anywhere.
+	 * @param frame    - Cleared and filled with the rows, colour codes and newlines. Its memory is reused.
+	 * @param viewport - The part of the map to show, clamped to the map.
+	 * @note  A colour code is only written where the colour changes from the previous cell, and the frame ends
+	 *        with the colour reset. In a downsampled block the start, exit, path and items win, in that order,
+	 *        otherwise the most common cell does.
+	 */
+	void render_map(std::string& frame, const MapViewport& viewport = {}) const;
+	/**
+	 * @brief Get the viewport showing the whole map with the smallest step that fits in max_rows x max_cols cells.
+	 */
+	MapViewport fit_viewport(int max_rows, int max_cols) const;
 	/**
 	 * @brief Save the map data to a new file.
 	 * @note  Saved as 'original_filename_' + '-searched.txt'.
 	 */
 	void save_map(const std::string& new_filename) const;
+	/**
+	 * @brief Save the map data in the binary format (see c_binary_map).
+	 * @param filename - The path to write, used as given.
+	 */
+	void save_binary_map(const std::string& filename) const;
+	/**
+	 * @brief Load and verify a map saved in the binary format.
+	 * @param filename - The binary map file to load.
+	 * @note  Copies the cells so the map can be edited, use c_binary_map directly for zero-copy access. The scan is
+	 *        taken from the file's bitset and header where it has them (see c_binary_map::scan), not from the cells.
+	 */
+	void load_binary_map(const std::string& filename);
 
 	/**
 	 * @brief Convert the map to a graph.
 	 * @return A graph representation of the map.
 	 */
 	c_graph to_graph() const;
+	/**
+	 * @brief Convert the map to a graph, building it in row bands across a thread pool.
+	 * @param pool - Pool to run the bands on.
+	 * @return The same graph as to_graph().
+	 */
+	c_graph to_graph(c_thread_pool& pool) const;
 
 	/**
 	 * @brief Get the start node position.
 	 * @return A pair of integers representing the start node position.
+	 * @note  O(1), the position is cached when the map is loaded.
 	 */
 	std::pair<int, int> get_start_node() const;
 
 	/**
 	 * @brief Get the end node position.
 	 * @return A pair of integers representing the end node position.
+	 * @note  O(1), the position is cached when the map is loaded.
 	 */
 	std::pair<int, int> get_end_node() const;
 	/**
+	 * @brief Get the position of an item.
+	 * @param item - 'a' - 'j', throws std::out_of_range otherwise or if the map does not hold it.
+	 * @note  O(1), the position is cached when the map is loaded.
+	 */
+	std::pair<int, int> get_item_node(char item) const;
+	/**
+	 * @brief Get which of the exit and items can be reached from the start.
+	 * @note  Worked out from the regions of floor (see c_components.h) when the map is loaded, so it describes the
+	 *        map as loaded. All false for the empty map.
+	 */
+	const MapReachability& reachability() const { return reachability_; }
+	/**
      * @brief Mark the path on the map with the character 'p'.
      * @param path - A vector of pairs representing the path coordinates.
      */
     void mark_path(const std::vector<std::pair<int, int>>& path);
 
+	int rows() const { return rows_; } // Number of rows in the map.
+	int cols() const { return cols_; } // Number of columns in the map.
+	/**
+	 * @brief Get the cell at the specified coordinates, no bounds checking.
+	 */
+	char cell(int x, int y) const { return map_[static_cast<std::size_t>(x) * cols_ + y]; }
+	/**
+	 * @brief Get the raw row-major cell buffer, rows() * cols() chars.
+	 */
+	const char* data() const { return map_.data(); }
+
 private:
-	std::vector<std::vector<char>> map_; // Map data stored as a 2D vector.
-	std::string original_filename_;      // Need for new save file name.
+	std::vector<char> map_;          // Map data stored row-major in one contiguous buffer.
+	int rows_ = 0;                   // Number of rows in the map.
+	int cols_ = 0;                   // Number of columns in the map.
+	std::string original_filename_;  // Need for new save file name.
+	MapScan scan_;                   // scan_map result for map_, taken again whenever the cells change.
+	int start_index_ = -1;           // Cell index of the first 's', -1 if there is none.
+	int end_index_ = -1;             // Cell index of the first 'x', -1 if there is none.
+	std::array<int, 10> item_index_; // Cell index of the first of each item 'a' - 'j', -1 if missing.
+	MapReachability reachability_;   // See reachability().
+	mutable std::string frame_;      // display_map's frame buffer, kept so redrawing doesn't allocate.
+
+	/**
+	 * @brief Replace the map data with an empty map surrounded by walls.
+	 * @param size - Width and height of the empty map.
+	 */
+	void reset_to_empty(int size);
+	/**
+	 * @brief Scan the cells into scan_ and cache the start, exit and item positions. Does not verify.
+	 */
+	void index_map();
+	/**
+	 * @brief Cache the start, exit and item positions from scan_.
+	 */
+	void cache_positions();
+	/**
+	 * @brief Label the regions of floor in scan_ and record which of the exit and items share the start's.
+	 */
+	void find_reachability();
+	/**
+	 * @brief Get the row and column of a cached cell index, throws std::runtime_error with the message if it is -1.
+	 */
+	std::pair<int, int> cached_position(int index, const char* missing) const;
+	/**
+	 * @brief Get the cell shown for the step x step block at (top, left), see render_map.
+	 */
+	char block_cell(int top, int left, int step) const;
 };
\ No newline at end of file
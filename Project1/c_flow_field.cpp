@@ -0,0 +1,130 @@
+#include "c_flow_field.h"
+#include <algorithm>
+
+c_flow_field::c_flow_field(const c_graph& graph, const Node& goal) {
+	c_traversal_state state;
+	build(graph, std::span<const Node>(&goal, 1), state);
+}
+
+c_flow_field::c_flow_field(const c_graph& graph, std::span<const Node> goals) {
+	c_traversal_state state;
+	build(graph, goals, state);
+}
+
+void c_flow_field::build(const c_graph& graph, std::span<const Node> goals, c_traversal_state& state) {
+	rows_ = graph.rows();
+	cols_ = graph.cols();
+	graph_version_ = graph.version();
+	const std::size_t cell_count = static_cast<std::size_t>(rows_) * cols_;
+	distances_.assign(cell_count, UNREACHABLE);
+	directions_.assign(cell_count, NONE);
+
+	// Every goal starts the BFS at distance 0, so each cell ends up pointing at its nearest goal.
+	state.begin(cell_count);
+	for (const Node& goal : goals) {
+		if (goal.x < 0 || goal.x >= rows_ || goal.y < 0 || goal.y >= cols_) continue;
+		const int index = graph.cell_index(goal.x, goal.y);
+		if (!graph.is_walkable(index) || !state.visit(index)) continue;
+		distances_[index] = 0;
+		directions_[index] = AT_GOAL;
+		state.push_back(index);
+	}
+
+	// The BFS runs outwards from the goals, so a newly reached cell moves back towards the cell it was reached from.
+	while (!state.queue_empty()) {
+		const int current = state.pop_front();
+		const std::uint32_t next_distance = distances_[current] + 1;
+		const int x = current / cols_;
+		const int y = current % cols_;
+		auto reach = [&](int neighbor, Direction towards_current) {
+			if (!graph.is_walkable(neighbor) || !state.visit(neighbor)) return;
+			distances_[neighbor] = next_distance;
+			directions_[neighbor] = towards_current;
+			state.push_back(neighbor);
+		};
+		if (x > 0) reach(current - cols_, DOWN);
+		if (x + 1 < rows_) reach(current + cols_, UP);
+		if (y > 0) reach(current - 1, RIGHT);
+		if (y + 1 < cols_) reach(current + 1, LEFT);
+	}
+}
+
+std::pair<int, int> c_flow_field::next_step(int x, int y) const {
+	switch (direction(x, y)) {
+	case UP:    return { x - 1, y };
+	case DOWN:  return { x + 1, y };
+	case LEFT:  return { x, y - 1 };
+	case RIGHT: return { x, y + 1 };
+	default:    return { x, y };
+	}
+}
+
+bool c_flow_field::path(const Node& start, std::vector<std::pair<int, int>>& path) const {
+	if (start.x < 0 || start.x >= rows_ || start.y < 0 || start.y >= cols_ || distance(start.x, start.y) == UNREACHABLE) {
+		return false;
+	}
+	path.reserve(path.size() + distance(start.x, start.y) + 1);
+	std::pair<int, int> at{ start.x, start.y };
+	path.push_back(at);
+	while (direction(at.first, at.second) != AT_GOAL) {
+		at = next_step(at.first, at.second);
+		path.push_back(at);
+	}
+	return true;
+}
+
+c_flow_field_cache::c_flow_field_cache(const c_graph& graph, std::size_t capacity)
+	: graph_(graph), capacity_(std::max<std::size_t>(capacity, 1)) {
+}
+
+std::shared_ptr<const c_flow_field> c_flow_field_cache::get(const Node& goal, c_traversal_state& state) {
+	const int key = graph_.cell_index(goal.x, goal.y);
+	std::uint64_t version = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (graph_version_ != graph_.version()) { // The map changed, every field is stale.
+			fields_.clear();
+			recency_.clear();
+			graph_version_ = graph_.version();
+		}
+		version = graph_version_;
+		const auto found = fields_.find(key);
+		if (found != fields_.end()) {
+			++hits_;
+			recency_.splice(recency_.begin(), recency_, found->second.recency);
+			return found->second.field;
+		}
+	}
+
+	// Build without holding the lock, so hits and misses on other threads are not held up behind the BFS.
+	++misses_;
+	auto field = std::make_shared<c_flow_field>();
+	field->build(graph_, std::span<const Node>(&goal, 1), state);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (graph_version_ != version || field->graph_version() != version) {
+		return field; // The graph moved on, the field is not kept.
+	}
+	const auto found = fields_.find(key);
+	if (found != fields_.end()) {
+		return found->second.field; // Another thread built it first, share that one.
+	}
+	if (fields_.size() >= capacity_) {
+		fields_.erase(recency_.back());
+		recency_.pop_back();
+	}
+	recency_.push_front(key);
+	fields_.emplace(key, Entry{ field, recency_.begin() });
+	return field;
+}
+
+std::shared_ptr<const c_flow_field> c_flow_field_cache::get(const Node& goal) {
+	c_traversal_state state; // Empty until a miss builds with it.
+	return get(goal, state);
+}
+
+void c_flow_field_cache::invalidate() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	fields_.clear();
+	recency_.clear();
+}
@@ -0,0 +1,119 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_flow_field.h
+// Description : Distance and direction fields towards one or more goals, shared by many agents.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "c_graph.h"
+#include "c_traversal_state.h"
+
+/**
+ * @brief Steps to the nearest goal and the first move towards it, for every cell of a graph.
+ * @note  Built with one multi-source BFS outwards from the goals (4-way, unit costs), after which an
+ *        agent's next step is a single array lookup. Walls and cells that cannot reach a goal have no direction.
+ */
+class c_flow_field {
+public:
+	enum Direction : std::uint8_t { UP, DOWN, LEFT, RIGHT, AT_GOAL, NONE };
+	static constexpr std::uint32_t UNREACHABLE = 0xFFFFFFFFu;
+
+	c_flow_field() = default;
+	/**
+	 * @brief Build the field for a single goal.
+	 */
+	c_flow_field(const c_graph& graph, const Node& goal);
+	/**
+	 * @brief Build the field towards whichever of the goals is nearest.
+	 */
+	c_flow_field(const c_graph& graph, std::span<const Node> goals);
+
+	/**
+	 * @brief Rebuild in place, reusing this field's buffers and the caller's traversal state.
+	 */
+	void build(const c_graph& graph, std::span<const Node> goals, c_traversal_state& state);
+
+	std::uint32_t distance(int x, int y) const { return distances_[static_cast<std::size_t>(x) * cols_ + y]; } // Steps to the nearest goal.
+	Direction direction(int x, int y) const { return static_cast<Direction>(directions_[static_cast<std::size_t>(x) * cols_ + y]); }
+	/**
+	 * @brief Get the cell an agent at (x, y) should move to next.
+	 * @return The next cell, or (x, y) itself at a goal or where no goal can be reached.
+	 */
+	std::pair<int, int> next_step(int x, int y) const;
+	/**
+	 * @brief Follow the directions from the start to the nearest goal, appending every cell to a caller-owned buffer.
+	 * @return True if a goal is reachable, the buffer is left unchanged otherwise.
+	 */
+	bool path(const Node& start, std::vector<std::pair<int, int>>& path) const;
+	std::uint64_t graph_version() const { return graph_version_; } // c_graph::version() the field was built from.
+	std::size_t memory_usage() const { return distances_.capacity() * sizeof(std::uint32_t) + directions_.capacity(); }
+
+private:
+	int rows_ = 0;
+	int cols_ = 0;
+	std::uint64_t graph_version_ = 0;
+	std::vector<std::uint32_t> distances_; // Per cell, UNREACHABLE for walls and cut off cells.
+	std::vector<std::uint8_t> directions_; // Per cell, a Direction.
+};
+
+/**
+ * @brief Bounded cache of single-goal flow fields, safe to share between threads.
+ * @note  Fields are handed out as shared pointers, so one evicted or invalidated while an agent still
+ *        follows it stays alive until released. Any change to the graph's version empties the cache.
+ */
+class c_flow_field_cache {
+public:
+	/**
+	 * @brief Create a cache for the specified graph.
+	 * @param graph    - The graph to build fields on, must outlive the cache.
+	 * @param capacity - Most fields kept at once, the least recently used is evicted first.
+	 */
+	explicit c_flow_field_cache(const c_graph& graph, std::size_t capacity = 16);
+
+	/**
+	 * @brief Get the field towards a goal, building it on a miss.
+	 * @param state - BFS scratch for a miss, owned by the calling thread. The field is built without the cache locked.
+	 */
+	std::shared_ptr<const c_flow_field> get(const Node& goal, c_traversal_state& state);
+	/**
+	 * @brief Get the field towards a goal, building it on a miss with scratch of its own.
+	 */
+	std::shared_ptr<const c_flow_field> get(const Node& goal);
+	/**
+	 * @brief Drop every cached field.
+	 */
+	void invalidate();
+
+	std::size_t hits() const { return hits_.load(); }     // get calls answered from the cache.
+	std::size_t misses() const { return misses_.load(); } // get calls that built a field.
+
+private:
+	struct Entry {
+		std::shared_ptr<const c_flow_field> field;
+		std::list<int>::iterator recency; // Position in recency_.
+	};
+
+	const c_graph& graph_;
+	std::size_t capacity_;
+	std::mutex mutex_;
+	std::uint64_t graph_version_ = 0;        // Version the cached fields were built from.
+	std::unordered_map<int, Entry> fields_;  // Keyed by goal cell index.
+	std::list<int> recency_;                 // Goal cells, most recently used first.
+	std::atomic<std::size_t> hits_{ 0 };
+	std::atomic<std::size_t> misses_{ 0 };
+};
@@ -1,55 +1,225 @@
 ﻿#include "c_graph.h"
+#include "c_landmarks.h"
+#include "c_thread_pool.h"
+#include <atomic>
 #include <iostream>
+#include <numeric>
+#include <stdexcept>
 #include <unordered_set>
 
+namespace {
+	std::uint64_t next_version() { // Shared by every graph, so no two builds or edits get the same stamp.
+		static std::atomic<std::uint64_t> counter{ 0 };
+		return ++counter;
+	}
+
+	// Call fn(band, begin, end) for each of band_count bands covering [0, count), on the pool if there is one.
+	template <typename Fn>
+	void for_each_band(c_thread_pool* pool, std::size_t band_count, std::size_t count, Fn&& fn) {
+		auto run = [&](std::size_t first, std::size_t last) {
+			for (std::size_t band = first; band < last; ++band) {
+				fn(band, count * band / band_count, count * (band + 1) / band_count);
+			}
+		};
+		if (pool == nullptr || band_count <= 1) run(0, band_count);
+		else pool->parallel_for(band_count, 1, [&](unsigned, std::size_t first, std::size_t last) { run(first, last); });
+	}
+}
+
 Node c_graph::get_node(int x, int y) const {
 	// Check if the coordinates are within the bounds of the graph.
-	if (x < 0 || x >= nodes_.size() || y < 0 || y >= nodes_[0].size()) {
+	if (x < 0 || x >= rows_ || y < 0 || y >= cols_) {
+		throw std::out_of_range("Node position out of range");
+	}
+	// Assemble the node from the walkability bit and the special cell table.
+	const int index = cell_index(x, y);
+	const char ch = special_at(index);
+	return { x, y, (ch >= 'a' && ch <= 'j'), !is_walkable(index), ch == 's', ch == 'x' };
+}
+
+void c_graph::set_walkable(int x, int y, bool walkable) {
+	if (x < 0 || x >= rows_ || y < 0 || y >= cols_) {
 		throw std::out_of_range("Node position out of range");
 	}
-	return nodes_[x][y];
+	version_ = next_version();
+	// Keep the row-major and column-major copies of the bit in step.
+	const std::size_t index = static_cast<std::size_t>(x) * cols_ + y;
+	const bool was_walkable = is_walkable(static_cast<int>(index));
+	const std::size_t column_index = static_cast<std::size_t>(y) * rows_ + x;
+	const std::uint64_t bit = std::uint64_t(1) << (index & 63);
+	const std::uint64_t column_bit = std::uint64_t(1) << (column_index & 63);
+	if (walkable) {
+		walkable_[index >> 6] |= bit;
+		walkable_columns_[column_index >> 6] |= column_bit;
+	} else {
+		walkable_[index >> 6] &= ~bit;
+		walkable_columns_[column_index >> 6] &= ~column_bit;
+	}
+	// Then the region labels, see c_graph_components.cpp.
+	if (walkable && !was_walkable) join_components(x, y);
+	else if (!walkable && was_walkable) split_component(x, y);
+}
+
+void c_graph::set_cost(int x, int y, std::uint8_t cost) {
+	if (x < 0 || x >= rows_ || y < 0 || y >= cols_) {
+		throw std::out_of_range("Node position out of range");
+	}
+	if (cost == 0) {
+		throw std::invalid_argument("Terrain cost must be at least 1");
+	}
+	version_ = next_version();
+	if (costs_.empty()) {
+		if (cost == FLOOR_COST) return;
+		costs_.assign(static_cast<std::size_t>(rows_) * cols_, FLOOR_COST);
+	}
+	costs_[static_cast<std::size_t>(x) * cols_ + y] = cost;
+	min_cost_ = std::min(min_cost_, cost);
+}
+
+char c_graph::special_at(int index) const {
+	// Binary search the sorted table, only a handful of cells are special.
+	const auto it = std::lower_bound(special_cells_.begin(), special_cells_.end(), index,
+		[](const std::pair<int, char>& cell, int key) { return cell.first < key; });
+	return (it != special_cells_.end() && it->first == index) ? it->second : 0;
+}
+
+std::size_t c_graph::memory_usage() const {
+	return (walkable_.capacity() + walkable_columns_.capacity()) * sizeof(std::uint64_t) +
+		special_cells_.capacity() * sizeof(std::pair<int, char>) + costs_.capacity() +
+		components_.memory_usage() + component_scratch_.memory_usage() + component_ranks_.capacity() +
+		component_parent_.capacity() * sizeof(std::uint32_t);
 }
 
 c_graph::c_graph(const std::vector<std::vector<char>>& map) {
-	build_graph(map);
+	// Flatten the rows into one row-major buffer.
+	std::vector<char> cells;
+	cells.reserve(map.size() * map[0].size());
+	for (const auto& row : map) {
+		cells.insert(cells.end(), row.begin(), row.end());
+	}
+	build_graph(cells.data(), static_cast<int>(map.size()), static_cast<int>(map[0].size()));
 }
 
-void c_graph::build_graph(const std::vector<std::vector<char>>& map) {
-	// Resize the nodes vector to match the map size.
-	int rows = map.size();
-	int cols = map[0].size();
-	nodes_.resize(rows, std::vector<Node>(cols));
+c_graph::c_graph(const char* cells, int rows, int cols) {
+	build_graph(cells, rows, cols);
+}
 
-	// Iterate over the map and build the nodes.
-	for (int i = 0; i < rows; ++i) {
-		for (int j = 0; j < cols; ++j) {
-			char ch = map[i][j];
-			nodes_[i][j] = { i, j, (ch >= 'a' && ch <= 'j'), ch == 'w', ch == 's', ch == 'x' };
-		}
+c_graph::c_graph(const char* cells, int rows, int cols, const MapScan& scan) {
+	build_graph(cells, rows, cols, scan);
+}
+
+c_graph::c_graph(const char* cells, int rows, int cols, c_thread_pool& pool) {
+	build_graph(cells, rows, cols, &pool);
+}
+
+c_graph::c_graph(const char* cells, int rows, int cols, const MapScan& scan, c_thread_pool& pool) {
+	build_graph(cells, rows, cols, scan, &pool);
+}
+
+bool c_graph::same_layout(const c_graph& other) const {
+	return rows_ == other.rows_ && cols_ == other.cols_ && walkable_ == other.walkable_ &&
+		walkable_columns_ == other.walkable_columns_ && special_cells_ == other.special_cells_ &&
+		costs_ == other.costs_ && min_cost_ == other.min_cost_ &&
+		components_.run_starts == other.components_.run_starts && components_.run_ranks == other.components_.run_ranks &&
+		components_.block_labels == other.components_.block_labels && components_.count == other.components_.count &&
+		component_parent_ == other.component_parent_ && component_count_ == other.component_count_;
+}
+
+void c_graph::build_graph(const char* cells, int rows, int cols, c_thread_pool* pool) {
+	build_seconds_ = 0.0;
+	MapScan scan;
+	{
+		c_phase_timer<> scan_timer(build_seconds_);
+		if (pool != nullptr) scan_map(cells, static_cast<std::size_t>(rows) * cols, scan, *pool);
+		else scan_map(cells, static_cast<std::size_t>(rows) * cols, scan);
 	}
+	build_graph(cells, rows, cols, scan, pool);
+}
 
-	// Iterate over the nodes and build the adjacency list.
-	for (int i = 0; i < rows; ++i) {
-		for (int j = 0; j < cols; ++j) {
-			if (!nodes_[i][j].is_wall) { // Skip walls.
-				adj_list_[nodes_[i][j]] = get_neighbors(nodes_[i][j]);
+void c_graph::build_graph(const char* cells, int rows, int cols, const MapScan& scan, c_thread_pool* pool) {
+	c_phase_timer<> build_timer(build_seconds_);
+	rows_ = rows;
+	cols_ = cols;
+	version_ = next_version();
+	const std::size_t cell_count = static_cast<std::size_t>(rows) * cols;
+	if (scan.walkable.size() != (cell_count + 63) / 64) {
+		throw std::invalid_argument("Map scan does not match the map size");
+	}
+	// The walkability grid and the special cells come straight from the scan.
+	walkable_ = scan.walkable;
+	special_cells_ = scan.specials;
+	costs_.clear(); // Only allocated if the scan saw terrain.
+	min_cost_ = FLOOR_COST;
+
+	// Work is split into row bands, several per thread so a slow band doesn't hold the others up.
+	// Every band writes only its own part of the preallocated arrays, so the result never depends on the thread count.
+	const std::size_t band_count = pool != nullptr ? static_cast<std::size_t>(pool->size()) * 4 : 1;
+	if (scan.has_terrain) {
+		costs_.resize(cell_count);
+		std::vector<std::uint8_t> band_min(band_count, FLOOR_COST);
+		for_each_band(pool, band_count, static_cast<std::size_t>(rows), [&](std::size_t band, std::size_t first_row, std::size_t last_row) {
+			std::uint8_t lowest = FLOOR_COST;
+			for (std::size_t i = first_row * cols; i < last_row * cols; ++i) {
+				costs_[i] = cells[i] == 'w' ? FLOOR_COST : terrain_cost(cells[i]);
+				lowest = std::min(lowest, costs_[i]);
 			}
-		}
+			band_min[band] = lowest;
+		});
+		min_cost_ = *std::min_element(band_min.begin(), band_min.end());
 	}
+
+	// Transpose into the column-major copy used to scan columns, 64 rows at a time: each row's bits are spread into
+	// one word per column, then each column's word lands in the copy with at most two ORs. A column's 64 rows can
+	// share a word with the neighbouring tile's, so those ORs are atomic.
+	walkable_columns_.assign(walkable_.size(), 0);
+	const std::size_t tiles = (static_cast<std::size_t>(rows) + 63) / 64;
+	for_each_band(pool, std::min(band_count, tiles), tiles, [&](std::size_t, std::size_t first_tile, std::size_t last_tile) {
+		std::vector<std::uint64_t> column_words(cols);
+		for (std::size_t tile = first_tile; tile < last_tile; ++tile) {
+			const int first_row = static_cast<int>(tile * 64);
+			const int tile_rows = std::min(64, rows - first_row);
+			std::fill(column_words.begin(), column_words.end(), 0);
+			for (int k = 0; k < tile_rows; ++k) {
+				for (int pos = 0; pos < cols; pos += 64) {
+					const std::uint64_t bits = line_bits(walkable_, rows, cols, first_row + k, pos);
+					const int length = std::min(64, cols - pos);
+					for (int b = 0; b < length; ++b) {
+						column_words[pos + b] |= ((bits >> b) & 1) << k;
+					}
+				}
+			}
+			for (int j = 0; j < cols; ++j) {
+				const std::uint64_t word = column_words[j];
+				if (word == 0) continue;
+				const std::size_t t = static_cast<std::size_t>(j) * rows + first_row;
+				const unsigned shift = t & 63;
+				std::atomic_ref<std::uint64_t>(walkable_columns_[t >> 6]).fetch_or(word << shift, std::memory_order_relaxed);
+				if (shift != 0 && (word >> (64 - shift)) != 0) {
+					std::atomic_ref<std::uint64_t>(walkable_columns_[(t >> 6) + 1]).fetch_or(word >> (64 - shift), std::memory_order_relaxed);
+				}
+			}
+		}
+	});
+
+	// Label the regions of floor once, so a search between two of them can give up without expanding anything.
+	label_components(walkable_, rows, cols, components_, pool);
+	component_parent_.resize(components_.count);
+	std::iota(component_parent_.begin(), component_parent_.end(), 0u);
+	component_ranks_.assign(components_.count, 0);
+	component_count_ = components_.count;
 }
 
-std::vector<Node> c_graph::reconstruct_path(const std::unordered_map<Node, Node>& came_from, Node current) const {
-    std::vector<Node> path;
+template <typename OpenSet>
+void c_graph::reconstruct_path(const c_basic_search_state<OpenSet>& state, int current, std::vector<std::pair<int, int>>& path) const {
+    const std::size_t first = path.size(); // The path is appended after anything already in the buffer.
 
-	// Traverse the came_from map from the goal and move backwards to the start.
-    while (came_from.find(current) != came_from.end()) {
-        path.push_back(current);         // Add the current node to the path.
-        current = came_from.at(current); // Move to the previous node in the path.
+	// Follow the came_from records from the goal and move backwards to the start.
+    while (current != -1) {
+        path.emplace_back(current / cols_, current % cols_); // Add the current cell to the path.
+        current = state.came_from(current);                  // Move to the previous cell in the path.
     }
 
-    path.push_back(current); // Add the start node to the path.
-    std::reverse(path.begin(), path.end()); // Reverse the path to get the correct order.
-    return path;
+    std::reverse(path.begin() + first, path.end()); // Reverse the appended part to get the correct order.
 }
 
 bool c_graph::is_valid_move(const Node& current, const Node& neighbor) const {
@@ -60,7 +230,7 @@ bool c_graph::is_valid_move(const Node& current, const Node& neighbor) const {
 	// Check if the move is valid (not cutting corners)
     if (std::abs(dx) + std::abs(dy) == 2) { // Absolute difference of 2 means we are moving diagonally.
 		// If there is a wall blocking the diagonal move, it is invalid.
-        if (nodes_[current.x + dx][current.y].is_wall || nodes_[current.x][current.y + dy].is_wall) { 
+        if (!is_walkable(cell_index(current.x + dx, current.y)) || !is_walkable(cell_index(current.x, current.y + dy))) {
             return false;
         }
     }
@@ -70,6 +240,7 @@ bool c_graph::is_valid_move(const Node& current, const Node& neighbor) const {
 
 std::vector<Node> c_graph::get_neighbors(const Node& node) const {
 	std::vector<Node> neighbors;
+	neighbors.reserve(4);
 	int directions[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} }; // Up, down, left, right.
 
 	// Iterate over the directions and add valid neighbors.
@@ -78,8 +249,8 @@ std::vector<Node> c_graph::get_neighbors(const Node& node) const {
 		int new_y = node.y + dir[1];
 
 		// Check if the new coordinates are within the bounds of the graph.
-		if (new_x >= 0 && new_x < nodes_.size() && new_y >= 0 && new_y < nodes_[0].size()) {
-			neighbors.push_back(nodes_[new_x][new_y]);
+		if (new_x >= 0 && new_x < rows_ && new_y >= 0 && new_y < cols_) {
+			neighbors.push_back(get_node(new_x, new_y));
 		}
 	}
 
@@ -170,65 +341,179 @@ void c_graph::bfs(const Node& start) {
 	std::cout << "\n";
 }
 
+std::size_t c_graph::dfs_items(const Node& start, c_traversal_state& state, std::vector<std::pair<int, int>>& items) const {
+	std::size_t found = 0;
+	return dfs(start, state, [&](int index) {
+		const char ch = special_at(index);
+		if (ch < 'a' || ch > 'j') return true;
+		items.emplace_back(index / cols_, index % cols_);
+		return ++found < 10;
+	});
+}
+
+std::size_t c_graph::bfs_items(const Node& start, c_traversal_state& state, std::vector<std::pair<int, int>>& items) const {
+	std::size_t found = 0;
+	return bfs(start, state, [&](int index) {
+		const char ch = special_at(index);
+		if (ch < 'a' || ch > 'j') return true;
+		items.emplace_back(index / cols_, index % cols_);
+		return ++found < 10;
+	});
+}
+
 std::vector<std::pair<int, int>> c_graph::a_star(const Node& start, const Node& goal) {
-    std::priority_queue<std::pair<Node, double>, std::vector<std::pair<Node, double>>, NodeComparator> open_set; // Priority queue for nodes to be evaluated, ordered by f_score.
-    std::unordered_map<Node, Node> came_from; // Map to store the most efficient previous step for each node.
-    std::unordered_map<Node, double> g_score; // Map to store the cost of the cheapest path from start to each node.
-    std::unordered_map<Node, double> f_score; // Map to store the estimated total cost from start to goal through each node.
-    std::unordered_set<Node> closed_set;      // Set to store nodes that have already been evaluated.
-
-    // Initialize the start node.
-    open_set.emplace(start, 0.0);
-    g_score[start] = 0.0;
-    f_score[start] = manhattan_distance(start, goal);
-
-    // Continue until the open set is empty.
-    while (!open_set.empty()) {
-        // Get the node with the lowest f_score.
-        Node current = open_set.top().first;
-        open_set.pop();
-
-        // Check if the current node is the goal.
-        if (current == goal) {
-            // If the goal is reached, reconstruct the path and return it.
-            std::vector<Node> path_nodes = reconstruct_path(came_from, current);
-
-            // Convert the nodes to a vector of pairs representing the path coordinates.
-            std::vector<std::pair<int, int>> path;
-            for (const auto& node : path_nodes) {
-                path.emplace_back(node.x, node.y);
-            }
+    std::vector<std::pair<int, int>> path = a_star(start, goal, search_state_);
+    std::cout << (path.empty() ? "No path found!" : "Path found!") << std::endl;
+    return path;
+}
 
-            std::cout << "Path found!" << std::endl;
-            return path;
-        }
+template <typename Neighbourhood, typename OpenSet>
+std::vector<std::pair<int, int>> c_graph::a_star(const Node& start, const Node& goal, c_basic_search_state<OpenSet>& state) const {
+    std::vector<std::pair<int, int>> path;
+    a_star<Neighbourhood>(start, goal, state, path);
+    return path;
+}
+
+template <typename Neighbourhood, typename OpenSet>
+bool c_graph::a_star(const Node& start, const Node& goal, c_basic_search_state<OpenSet>& state, std::vector<std::pair<int, int>>& path) const {
+    return a_star_search<Neighbourhood>(start, goal, state, path, [&goal](int x, int y, int) {
+        return Neighbourhood::heuristic(std::abs(x - goal.x), std::abs(y - goal.y));
+    });
+}
 
-        // If the current node is not the goal, add it to the closed set.
-        closed_set.insert(current);
+template <typename OpenSet>
+std::vector<std::pair<int, int>> c_graph::a_star(const Node& start, const Node& goal, const c_landmarks& landmarks, c_basic_search_state<OpenSet>& state) const {
+    std::vector<std::pair<int, int>> path;
+    a_star(start, goal, landmarks, state, path);
+    return path;
+}
+
+template <typename OpenSet>
+bool c_graph::a_star(const Node& start, const Node& goal, const c_landmarks& landmarks, c_basic_search_state<OpenSet>& state, std::vector<std::pair<int, int>>& path) const {
+    if (landmarks.graph_version() != version_) {
+        throw std::runtime_error("Landmarks are out of date with the graph");
+    }
+    const int goal_index = cell_index(goal.x, goal.y);
+    if (landmarks.disconnected(cell_index(start.x, start.y), goal_index)) {
+        state.begin(static_cast<std::size_t>(rows_) * cols_); // So the stats read as an empty search.
+        return false;
+    }
+
+    // Both bounds are consistent, so their maximum is too and cells are still expanded at most once.
+    const std::uint16_t* goal_distances = landmarks.distances(goal_index);
+    return a_star_search<Neighbourhood4>(start, goal, state, path, [&](int x, int y, int index) {
+        const int manhattan = std::abs(x - goal.x) + std::abs(y - goal.y);
+        return static_cast<double>(std::max(manhattan, landmarks.lower_bound(index, goal_distances)));
+    });
+}
+
+template <typename Neighbourhood, typename OpenSet, typename Heuristic>
+bool c_graph::a_star_search(const Node& start, const Node& goal, c_basic_search_state<OpenSet>& state, std::vector<std::pair<int, int>>& path, Heuristic&& heuristic) const {
+    const int straight[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };  // Same order as get_neighbors.
+    const int diagonal[4][2] = { {-1, -1}, {-1, 1}, {1, -1}, {1, 1} };
+    const int goal_index = cell_index(goal.x, goal.y);
+    if (disconnected(cell_index(start.x, start.y), goal_index)) {
+        state.begin(static_cast<std::size_t>(rows_) * cols_); // So the stats read as an empty search.
+        return false;
+    }
 
-        // Iterate over the neighbors of the current node.
-        for (const auto& neighbor : get_neighbors(current)) {
-            // Skip if the neighbor is in the closed set, is a wall, or the move is invalid.
-            if (closed_set.find(neighbor) != closed_set.end() || neighbor.is_wall || !is_valid_move(current, neighbor)) {
+    // The search and reconstruction are timed separately in instrumented builds, see c_search_stats.h.
+    int reached = -1;
+    {
+        c_phase_timer<> search_timer(state.recorder().search_seconds);
+        // Initialize the start node.
+        constexpr double max_step_cost = Neighbourhood::diagonal ? Neighbourhood8::diagonal_cost : 1.0;
+        state.begin(static_cast<std::size_t>(rows_) * cols_, max_step_cost);
+        const int start_index = cell_index(start.x, start.y);
+        state.set_score(start_index, 0.0, -1);
+        state.push_open(start_index, 0.0);
+
+        // Continue until the open set is empty.
+        while (!state.open_empty()) {
+            // Get the cell with the lowest f_score.
+            const int current = state.pop_open();
+            if (state.is_closed(current)) { // Stale duplicate, already expanded with a better score.
+                state.count_stale_pop();
                 continue;
             }
 
-            // Calculate the tentative g_score.
-            double tentative_g_score = g_score[current] + euclidean_distance(current, neighbor);
-
-            // If the neighbor is not in the g_score map or the tentative g_score is less than the current g_score.
-            if (g_score.find(neighbor) == g_score.end() || tentative_g_score < g_score[neighbor]) {
-                // Update the path and scores.
-                came_from[neighbor] = current;
-                g_score[neighbor] = tentative_g_score;
-                f_score[neighbor] = g_score[neighbor] + manhattan_distance(neighbor, goal);
-                // Add the neighbor to the open set.
-                open_set.emplace(neighbor, f_score[neighbor]);
+            // Check if the current cell is the goal, if so stop and reconstruct the path below.
+            if (current == goal_index) {
+                reached = current;
+                break;
+            }
+
+            // If the current cell is not the goal, add it to the closed set.
+            state.close(current);
+            const int cx = current / cols_;
+            const int cy = current % cols_;
+            const double current_g = state.g_score(current);
+
+            // If the neighbour has no score yet or the tentative g_score is lower, update it and add it to the open set.
+            auto relax = [&](int nx, int ny, int neighbor, double step_cost) {
+                const double tentative_g_score = current_g + step_cost;
+                if (!state.has_score(neighbor) || tentative_g_score < state.g_score(neighbor)) {
+                    state.set_score(neighbor, tentative_g_score, current);
+                    state.push_open(neighbor, tentative_g_score + heuristic(nx, ny, neighbor));
+                }
+            };
+
+            // Iterate over the straight neighbours of the current cell.
+            for (const auto& dir : straight) {
+                const int nx = cx + dir[0];
+                const int ny = cy + dir[1];
+                // Skip if out of bounds, already closed or a wall.
+                if (nx < 0 || nx >= rows_ || ny < 0 || ny >= cols_) continue;
+                const int neighbor = cell_index(nx, ny);
+                if (state.is_closed(neighbor) || !is_walkable(neighbor)) continue;
+                relax(nx, ny, neighbor, 1.0); // Same as euclidean_distance for a straight step.
+            }
+
+            // Diagonal neighbours only exist in the 8-way neighbourhood, decided at compile time.
+            if constexpr (Neighbourhood::diagonal) {
+                for (const auto& dir : diagonal) {
+                    const int nx = cx + dir[0];
+                    const int ny = cy + dir[1];
+                    if (nx < 0 || nx >= rows_ || ny < 0 || ny >= cols_) continue;
+                    const int neighbor = cell_index(nx, ny);
+                    if (state.is_closed(neighbor) || !is_walkable(neighbor)) continue;
+                    // Same rule as is_valid_move: no cutting corners past a wall.
+                    if (!is_walkable(cell_index(nx, cy)) || !is_walkable(cell_index(cx, ny))) continue;
+                    relax(nx, ny, neighbor, Neighbourhood::diagonal_cost);
+                }
             }
         }
     }
+    state.recorder().build_seconds = build_seconds_;
+    if (reached < 0) return false; // No path found, the output buffer is left untouched.
+
+    const std::size_t first = path.size();
+    {
+        c_phase_timer<> reconstruct_timer(state.recorder().reconstruct_seconds);
+        reconstruct_path(state, reached, path);
+    }
+    state.recorder().found = true;
+    state.recorder().path_length = path.size() - first;
+    return true;
+}
 
-    // If no path is found, return an empty vector.
-    std::cout << "No path found!" << std::endl;
-    return {};
-}
\ No newline at end of file
+// The neighbourhoods and open set back ends a_star is compiled for.
+#define INSTANTIATE_A_STAR(NEIGHBOURHOOD, OPEN_SET) \
+	template std::vector<std::pair<int, int>> c_graph::a_star<NEIGHBOURHOOD, OPEN_SET>(const Node&, const Node&, c_basic_search_state<OPEN_SET>&) const; \
+	template bool c_graph::a_star<NEIGHBOURHOOD, OPEN_SET>(const Node&, const Node&, c_basic_search_state<OPEN_SET>&, std::vector<std::pair<int, int>>&) const;
+INSTANTIATE_A_STAR(Neighbourhood4, c_binary_heap_open_set)
+INSTANTIATE_A_STAR(Neighbourhood8, c_binary_heap_open_set)
+INSTANTIATE_A_STAR(Neighbourhood4, c_indexed_heap_open_set)
+INSTANTIATE_A_STAR(Neighbourhood8, c_indexed_heap_open_set)
+INSTANTIATE_A_STAR(Neighbourhood4, c_bucket_open_set)
+INSTANTIATE_A_STAR(Neighbourhood8, c_bucket_open_set)
+#undef INSTANTIATE_A_STAR
+
+// The open set back ends landmark-guided a_star is compiled for.
+#define INSTANTIATE_A_STAR_LANDMARKS(OPEN_SET) \
+	template std::vector<std::pair<int, int>> c_graph::a_star<OPEN_SET>(const Node&, const Node&, const c_landmarks&, c_basic_search_state<OPEN_SET>&) const; \
+	template bool c_graph::a_star<OPEN_SET>(const Node&, const Node&, const c_landmarks&, c_basic_search_state<OPEN_SET>&, std::vector<std::pair<int, int>>&) const;
+INSTANTIATE_A_STAR_LANDMARKS(c_binary_heap_open_set)
+INSTANTIATE_A_STAR_LANDMARKS(c_indexed_heap_open_set)
+INSTANTIATE_A_STAR_LANDMARKS(c_bucket_open_set)
+#undef INSTANTIATE_A_STAR_LANDMARKS
@@ -16,8 +16,14 @@
 #include <queue>
 #include <stack>
 #include <algorithm>
+#include <cstdint>
+#include "c_search_state.h"
+#include "c_traversal_state.h"
+#include "c_terrain.h"
+#include "c_map_scan.h"
+#include "c_components.h"
 
-struct Node { // Struct to represent a node in the graph.
+struct Node { // Struct to represent a node in the graph. Built on demand by c_graph, not stored per cell.
 	int x, y;
 	bool is_item;
 	bool is_wall;
@@ -36,6 +42,22 @@ struct NodeComparator { // Custom comparator for the priority queue in A* algori
     }
 };
 
+/**
+ * @brief Movement policies for c_graph::a_star, chosen at compile time so the inner loop has no neighbourhood branches.
+ * @note  Each heuristic matches its step costs, so it never overestimates and paths stay optimal.
+ *        heuristic() takes the absolute row and column differences to the goal.
+ */
+struct Neighbourhood4 { // Up, down, left, right, each costing 1, with the Manhattan heuristic.
+	static constexpr bool diagonal = false;
+	static double heuristic(int dx, int dy) { return dx + dy; }
+};
+
+struct Neighbourhood8 { // Neighbourhood4 plus diagonals costing sqrt(2) that may not cut corners, with the octile heuristic.
+	static constexpr bool diagonal = true;
+	static constexpr double diagonal_cost = 1.4142135623730951;
+	static double heuristic(int dx, int dy) { return (diagonal_cost - 1.0) * std::min(dx, dy) + std::max(dx, dy); }
+};
+
 // Custom hash function for Node struct, to be able to use it as a key in an unordered_map.
 namespace std {
 	template <>
@@ -46,6 +68,9 @@ namespace std {
 	};
 }
 
+class c_landmarks;
+class c_thread_pool;
+
 class c_graph {
 public:
 	c_graph() = default; // Default constructor.
@@ -54,6 +79,26 @@ public:
 	 * @param map - The map to build the graph from.
 	 */
 	c_graph(const std::vector<std::vector<char>>& map);
+	/**
+	 * @brief Constructor that builds the graph from a row-major cell buffer.
+	 * @param cells - rows * cols map characters, row after row.
+	 * @param rows  - Number of rows in the map.
+	 * @param cols  - Number of columns in the map.
+	 */
+	c_graph(const char* cells, int rows, int cols);
+	/**
+	 * @brief Constructor that builds the graph from a row-major cell buffer already passed through scan_map.
+	 * @param scan - scan_map's result for exactly these cells, its bitset and special cells are used as they are.
+	 * @note  Throws std::invalid_argument if the scan is for a different number of cells.
+	 */
+	c_graph(const char* cells, int rows, int cols, const MapScan& scan);
+	/**
+	 * @brief Constructors that build the graph in row bands across a thread pool.
+	 * @param pool - Pool to run the bands on.
+	 * @note  The graph is exactly the one the serial constructors build, see same_layout.
+	 */
+	c_graph(const char* cells, int rows, int cols, c_thread_pool& pool);
+	c_graph(const char* cells, int rows, int cols, const MapScan& scan, c_thread_pool& pool);
 
 	/**
 	 * @brief Get the node object at the specified coordinates.
@@ -62,6 +107,97 @@ public:
 	 * @return   - The node object at the specified coordinates.
 	 */
 	Node get_node(int x, int y) const;
+	/**
+	 * @brief Get the flat index of the cell at the specified coordinates.
+	 * @param x - The x-coordinate (row) of the cell.
+	 * @param y - The y-coordinate (column) of the cell.
+	 * @return  - The index x * cols + y, used by the search state arrays.
+	 */
+	int cell_index(int x, int y) const { return x * cols_ + y; }
+	/**
+	 * @brief Check whether two graphs hold the same cells: walkability, special cells, terrain costs and region labels.
+	 */
+	bool same_layout(const c_graph& other) const;
+	int rows() const { return rows_; } // Number of rows in the graph.
+	int cols() const { return cols_; } // Number of columns in the graph.
+	/**
+	 * @brief Check whether the cell at the specified index is not a wall, no bounds checking.
+	 * @param index - Flat cell index, see cell_index.
+	 */
+	bool is_walkable(int index) const {
+		return (walkable_[static_cast<std::size_t>(index) >> 6] >> (index & 63)) & 1;
+	}
+	/**
+	 * @brief Turn a cell into a wall or back into floor on the live graph.
+	 * @param x        - The x-coordinate (row) of the cell.
+	 * @param y        - The y-coordinate (column) of the cell.
+	 * @param walkable - True for floor, false for a wall.
+	 * @note  Searches must not run on the graph while it is being edited.
+	 */
+	void set_walkable(int x, int y, bool walkable);
+	/**
+	 * @brief Get the connected region of floor the cell at the specified index belongs to, no bounds checking.
+	 * @return - The region's label, or NO_COMPONENT for a wall. Two floor cells share a label exactly when a search
+	 *           can get from one to the other, in either neighbourhood.
+	 * @note  Labelled when the graph is built (see c_components.h) and kept up to date by set_walkable. A region an
+	 *        edit merged into another keeps a link to it, so a lookup follows a few links at most.
+	 */
+	std::uint32_t component_of(int index) const {
+		if (!is_walkable(index)) return NO_COMPONENT;
+		std::uint32_t label = components_.label_of(index);
+		while (component_parent_[label] != label) label = component_parent_[label];
+		return label;
+	}
+	/**
+	 * @brief Check whether two floor cells are in different regions, so no path joins them.
+	 * @note  False if either cell is a wall, the searches handle those themselves. Every search checks this first
+	 *        and gives up at once if it holds.
+	 */
+	bool disconnected(int a, int b) const {
+		const std::uint32_t from = component_of(a);
+		const std::uint32_t to = component_of(b);
+		return from != to && from != NO_COMPONENT && to != NO_COMPONENT;
+	}
+	std::size_t component_count() const { return component_count_; } // Number of connected regions of floor.
+	/**
+	 * @brief Get the terrain cost byte of the cell at the specified index, see c_terrain.h. No bounds checking.
+	 * @note  Only weighted_a_star reads the costs, every other search treats all floor alike.
+	 */
+	std::uint8_t cost_at(int index) const { return costs_.empty() ? FLOOR_COST : costs_[index]; }
+	/**
+	 * @brief Change the terrain cost byte of a cell on the live graph.
+	 * @param cost - The new cost byte, 1 - 255. Throws std::invalid_argument for 0.
+	 * @note  Searches must not run on the graph while it is being edited.
+	 */
+	void set_cost(int x, int y, std::uint8_t cost);
+	/**
+	 * @brief Get a lower bound on the cost byte of every cell, used to keep the weighted heuristics admissible.
+	 */
+	std::uint8_t min_cost() const { return min_cost_; }
+	bool has_terrain() const { return !costs_.empty(); } // False while every cell costs FLOOR_COST, e.g. maps without terrain.
+	/**
+	 * @brief Get a stamp that changes whenever the graph is built or a cell is edited.
+	 * @note  Stamps are unique across all graphs, so a cache can tell a reassigned graph from the one it was filled from.
+	 */
+	std::uint64_t version() const { return version_; }
+	/**
+	 * @brief Get the stats of the last printing a_star call, see c_search_stats.h.
+	 */
+	SearchStats last_search_stats() const { return search_state_.stats(); }
+	/**
+	 * @brief Get the map character of a start, exit or item cell.
+	 * @param index - Flat cell index, see cell_index.
+	 * @return      - 's', 'x' or 'a' - 'j', or 0 for plain floor and walls.
+	 */
+	char special_at(int index) const;
+	/**
+	 * @brief Get every start, exit and item cell as (cell index, map character), sorted by index.
+	 */
+	const std::vector<std::pair<int, char>>& special_cells() const { return special_cells_; }
+	/**
+	 * @brief Get the number of bytes of heap memory the graph owns, excluding the search state.
+	 */
+	std::size_t memory_usage() const;
 	/**
 	 * @brief Get the neighbors of the specified node.
 	 * @param node - The node to get the neighbors of.
@@ -92,6 +228,37 @@ public:
 	 * @param start - The node to start the search from.
 	 */
 	void bfs(const Node& start);
+	/**
+	 * @brief Depth-first traversal of the floor cells reachable from the start, without allocating or printing.
+	 * @param start - The node to start from, nothing is visited if it is a wall.
+	 * @param state - Visited bitset and frontier to reuse, not shared between threads.
+	 * @param visit - Called as visit(cell_index) once per cell in visiting order, return false to stop.
+	 * @return      - The number of cells visited.
+	 * @note  Neighbours are pushed up, down, left, right, the same order as dfs, but walls are never entered.
+	 */
+	template <typename Visitor>
+	std::size_t dfs(const Node& start, c_traversal_state& state, Visitor&& visit) const;
+	/**
+	 * @brief Breadth-first traversal of the floor cells reachable from the start, without allocating or printing.
+	 * @param start - The node to start from, nothing is visited if it is a wall.
+	 * @param state - Visited bitset and frontier to reuse, not shared between threads.
+	 * @param visit - Called as visit(cell_index) once per cell in visiting order, return false to stop.
+	 * @return      - The number of cells visited.
+	 */
+	template <typename Visitor>
+	std::size_t bfs(const Node& start, c_traversal_state& state, Visitor&& visit) const;
+	/**
+	 * @brief Collect the items in the order a depth-first traversal reaches them, stopping at the tenth.
+	 * @param items - Buffer the item coordinates are appended to.
+	 * @return      - The number of cells visited.
+	 */
+	std::size_t dfs_items(const Node& start, c_traversal_state& state, std::vector<std::pair<int, int>>& items) const;
+	/**
+	 * @brief Collect the items in the order a breadth-first traversal reaches them, stopping at the tenth.
+	 * @param items - Buffer the item coordinates are appended to.
+	 * @return      - The number of cells visited.
+	 */
+	std::size_t bfs_items(const Node& start, c_traversal_state& state, std::vector<std::pair<int, int>>& items) const;
     /**
      * @brief Perform the A* algorithm to find the shortest path from the start node to the goal node.
      * @param start - The start node.
@@ -99,25 +266,172 @@ public:
      * @return A vector of pairs representing the path coordinates.
      */
     std::vector<std::pair<int, int>> a_star(const Node& start, const Node& goal);
+    /**
+     * @brief Perform the A* algorithm using caller-owned scratch state, without printing.
+     * @tparam Neighbourhood - Neighbourhood4 or Neighbourhood8, the movement rules and matching heuristic.
+     * @tparam OpenSet       - Open set back end, deduced from the state (c_search_state, c_indexed_search_state
+     *                         or c_bucket_search_state).
+     * @param start - The start node.
+     * @param goal  - The goal node.
+     * @param state - Search state to reuse, may be shared between graphs but not between threads.
+     * @return A vector of pairs representing the path coordinates, empty if no path exists.
+     */
+    template <typename Neighbourhood = Neighbourhood4, typename OpenSet>
+    std::vector<std::pair<int, int>> a_star(const Node& start, const Node& goal, c_basic_search_state<OpenSet>& state) const;
+    /**
+     * @brief Perform the A* algorithm, appending the path to a caller-owned buffer so no memory is allocated once warm.
+     * @tparam Neighbourhood - Neighbourhood4 or Neighbourhood8, the movement rules and matching heuristic.
+     * @tparam OpenSet       - Open set back end, deduced from the state.
+     * @param start - The start node.
+     * @param goal  - The goal node.
+     * @param state - Search state to reuse, may be shared between graphs but not between threads.
+     * @param path  - Buffer the path coordinates are appended to, left unchanged if no path exists.
+     * @return True if a path was found.
+     */
+    template <typename Neighbourhood = Neighbourhood4, typename OpenSet>
+    bool a_star(const Node& start, const Node& goal, c_basic_search_state<OpenSet>& state, std::vector<std::pair<int, int>>& path) const;
+    /**
+     * @brief Perform 4-way A* guided by landmark distances (ALT) as well as the Manhattan distance.
+     * @param start     - The start node.
+     * @param goal      - The goal node.
+     * @param landmarks - Tables built from this graph, throws if the graph was edited since.
+     * @param state     - Search state to reuse, may be shared between graphs but not between threads.
+     * @return A vector of pairs representing the path coordinates, empty if no path exists.
+     * @note  Finds paths as short as the plain 4-way a_star while expanding far fewer cells on maze-like maps.
+     *        Returns at once when the landmarks show the goal is in another region.
+     */
+    template <typename OpenSet>
+    std::vector<std::pair<int, int>> a_star(const Node& start, const Node& goal, const c_landmarks& landmarks, c_basic_search_state<OpenSet>& state) const;
+    /**
+     * @brief Perform landmark-guided A*, appending the path to a caller-owned buffer.
+     * @param path - Buffer the path coordinates are appended to, left unchanged if no path exists.
+     * @return True if a path was found.
+     */
+    template <typename OpenSet>
+    bool a_star(const Node& start, const Node& goal, const c_landmarks& landmarks, c_basic_search_state<OpenSet>& state, std::vector<std::pair<int, int>>& path) const;
+    /**
+     * @brief Perform Jump Point Search for the shortest 8-connected path from the start node to the goal node.
+     * @param start - The start node.
+     * @param goal  - The goal node.
+     * @param state - Search state to reuse, may be shared between graphs but not between threads.
+     * @return A vector of pairs representing every cell on the path, empty if no path exists.
+     * @note  Straight steps cost 1 and diagonal steps sqrt(2). Diagonals may not cut corners, same rule as
+     *        is_valid_move. Only jump points are expanded, the path is filled back in cell by cell.
+     */
+    std::vector<std::pair<int, int>> jps(const Node& start, const Node& goal, c_search_state& state) const;
+    /**
+     * @brief Perform Jump Point Search, appending the path to a caller-owned buffer.
+     * @param path - Buffer the path coordinates are appended to, left unchanged if no path exists.
+     * @return True if a path was found.
+     */
+    bool jps(const Node& start, const Node& goal, c_search_state& state, std::vector<std::pair<int, int>>& path) const;
+    /**
+     * @brief Perform bidirectional A*: one search from the start and one from the goal, each step expanding
+     *        whichever frontier is smaller.
+     * @tparam Neighbourhood - Neighbourhood4 or Neighbourhood8, the movement rules and matching heuristic.
+     * @param start - The start node.
+     * @param goal  - The goal node.
+     * @param state - Search states for both directions, may be shared between graphs but not between threads.
+     * @return A vector of pairs representing the path coordinates, empty if no path exists.
+     * @note  Stops once the lowest f_score in either frontier is no less than the best path through a cell
+     *        both searches reached, so the path is as short as a_star's.
+     */
+    template <typename Neighbourhood = Neighbourhood4>
+    std::vector<std::pair<int, int>> bidirectional_a_star(const Node& start, const Node& goal, c_bidirectional_search_state& state) const;
+    /**
+     * @brief Perform bidirectional A*, appending the path to a caller-owned buffer.
+     * @param path - Buffer the path coordinates are appended to, left unchanged if no path exists.
+     * @return True if a path was found.
+     */
+    template <typename Neighbourhood = Neighbourhood4>
+    bool bidirectional_a_star(const Node& start, const Node& goal, c_bidirectional_search_state& state, std::vector<std::pair<int, int>>& path) const;
+    /**
+     * @brief Perform A* over the terrain costs, in integer fixed-point arithmetic.
+     * @tparam Neighbourhood - Neighbourhood4 or Neighbourhood8, only its movement rules are used.
+     * @param start - The start node.
+     * @param goal  - The goal node.
+     * @param state - Search state to reuse, may be shared between graphs but not between threads.
+     * @return A vector of pairs representing the path coordinates, empty if no path exists.
+     * @note  A step into a cell costs its cost byte times STRAIGHT_STEP, or DIAGONAL_STEP for a diagonal.
+     *        The heuristic is the Manhattan or octile distance times min_cost(), so paths are the cheapest.
+     *        After a search, state.g_score(cell_index(goal.x, goal.y)) is the path's cost.
+     */
+    template <typename Neighbourhood = Neighbourhood4>
+    std::vector<std::pair<int, int>> weighted_a_star(const Node& start, const Node& goal, c_weighted_search_state& state) const;
+    /**
+     * @brief Perform weighted A*, appending the path to a caller-owned buffer.
+     * @param path - Buffer the path coordinates are appended to, left unchanged if no path exists.
+     * @return True if a path was found.
+     */
+    template <typename Neighbourhood = Neighbourhood4>
+    bool weighted_a_star(const Node& start, const Node& goal, c_weighted_search_state& state, std::vector<std::pair<int, int>>& path) const;
 
 private:
-	std::vector<std::vector<Node>> nodes_;                        // 2D vector of nodes representing the map.
-	std::unordered_map<Node, std::vector<Node>> adj_list_; 	      // Adjacency list representation of the graph.
+	std::vector<std::uint64_t> walkable_;                // One bit per cell, row-major, set if the cell is not a wall.
+	std::vector<std::uint64_t> walkable_columns_;        // The same bits column-major, so columns can be scanned a word at a time.
+	std::vector<std::pair<int, char>> special_cells_;    // Start, exit and item cells as (index, char), sorted by index.
+	std::vector<std::uint8_t> costs_;                    // Terrain cost byte per cell, empty while every cell costs FLOOR_COST.
+	std::uint8_t min_cost_ = FLOOR_COST;                 // See min_cost(), never raised by set_cost so it stays a lower bound.
+	int rows_ = 0;                                       // Number of rows in the graph.
+	int cols_ = 0;                                       // Number of columns in the graph.
+	ComponentLabels components_;                         // Region label per run of floor along a row, see component_of.
+	std::vector<std::uint32_t> component_parent_;        // Label each label was merged into by an edit, itself if none.
+	std::vector<std::uint8_t> component_ranks_;          // Union-by-rank bound on the links below each label.
+	std::size_t component_count_ = 0;                    // Labels with at least one floor cell.
+	ComponentScratch component_scratch_;                 // Flood marks reused by split_component, empty until the first split.
+	std::uint64_t version_ = 0;                          // See version(), 0 for a default constructed graph.
+	double build_seconds_ = 0.0;                         // Time build_graph took, instrumented builds only.
+	c_search_state search_state_;                        // Scratch state reused by consecutive a_star calls.
 
 	/**
 	 * @brief Build the graph from the specified map.
-	 * @param map - The map to build the graph from.
-	 * @note      - This function is called by the constructor.
+	 * @param cells - rows * cols map characters, row after row.
+	 * @param rows  - Number of rows in the map.
+	 * @param cols  - Number of columns in the map.
+	 * @note        - This function is called by the constructors.
+	 */
+	void build_graph(const char* cells, int rows, int cols, c_thread_pool* pool = nullptr);
+	/**
+	 * @brief Build the graph from the specified map and its scan_map result.
+	 * @param pool - Pool to build the row bands on, or null to build them one after another on this thread.
+	 */
+	void build_graph(const char* cells, int rows, int cols, const MapScan& scan, c_thread_pool* pool = nullptr);
+	/**
+	 * @brief Add a label for a region of its own.
+	 */
+	std::uint32_t new_component();
+	/**
+	 * @brief Merge the regions around a cell that has just become floor, and add the cell to the result.
+	 */
+	void join_components(int x, int y);
+	/**
+	 * @brief Take a cell that has just become a wall out of its region, splitting the region if that cut it apart.
+	 * @note  If the floor around the cell still joins up within its 3x3 block nothing else is looked at. Otherwise
+	 *        a flood goes out from each side in turn, one cell at a time, and the sides that run dry before meeting
+	 *        the rest get new labels, so only the smaller parts are walked.
+	 */
+	void split_component(int x, int y);
+	/**
+	 * @brief Relabel every run with its region's root and drop the labels edits left behind, O(runs).
+	 * @note  Called by new_component once there are twice as many labels as runs, so the labels stay bounded by the
+	 *        runs and the relabelling is paid for by the edits that added them.
 	 */
-	void build_graph(const std::vector<std::vector<char>>& map);
+	void compact_components();
 
 	/**
-     * @brief Reconstruct the path from the came_from map.
-     * @param came_from - Map of nodes and their predecessors.
-     * @param current   - The current node.
-     * @return A vector of nodes representing the path.
+     * @brief Reconstruct the path from the came_from records of a finished search.
+     * @param state   - The search state holding the came_from records.
+     * @param current - Index of the goal cell.
+     * @param path    - Buffer the path coordinates are appended to, from start to goal.
      */
-    std::vector<Node> reconstruct_path(const std::unordered_map<Node, Node>& came_from, Node current) const;
+    template <typename OpenSet>
+    void reconstruct_path(const c_basic_search_state<OpenSet>& state, int current, std::vector<std::pair<int, int>>& path) const;
+    /**
+     * @brief The A* loop shared by every a_star overload.
+     * @param heuristic - Called as heuristic(x, y, cell_index) for the lower bound from a cell to the goal.
+     */
+    template <typename Neighbourhood, typename OpenSet, typename Heuristic>
+    bool a_star_search(const Node& start, const Node& goal, c_basic_search_state<OpenSet>& state, std::vector<std::pair<int, int>>& path, Heuristic&& heuristic) const;
 
     /**
      * @brief Check if a move is valid (not cutting corners).
@@ -126,4 +440,80 @@ private:
      * @return True if the move is valid, false otherwise.
      */
     bool is_valid_move(const Node& current, const Node& neighbor) const;
-};
\ No newline at end of file
+
+	/**
+	 * @brief Check whether a cell is inside the graph and not a wall.
+	 */
+	bool is_walkable_at(int x, int y) const {
+		return x >= 0 && x < rows_ && y >= 0 && y < cols_ && is_walkable(cell_index(x, y));
+	}
+	/**
+	 * @brief Get the walkability bits of 64 consecutive cells along a row or column.
+	 * @param bits   - walkable_ (lines are rows) or walkable_columns_ (lines are columns).
+	 * @param lines  - Number of lines in that layout.
+	 * @param length - Cells per line in that layout.
+	 * @param line   - The line, lines outside the graph read as all walls.
+	 * @param pos    - Position of bit 0 along the line, may be negative down to -63. Cells outside the line read as walls.
+	 */
+	static std::uint64_t line_bits(const std::vector<std::uint64_t>& bits, int lines, int length, int line, int pos);
+	/**
+	 * @brief Jump straight along a row (horizontal) or column (vertical), scanning 64 cells at a time.
+	 * @param horizontal - True to move along row x, false to move along column y.
+	 * @param dir        - Direction of travel along the line, +1 or -1.
+	 * @return Position along the line of the next jump point, or -1 if a wall is reached first.
+	 */
+	int jump_straight(bool horizontal, int x, int y, int dir, int goal_x, int goal_y) const;
+	/**
+	 * @brief Jump from (x, y) in direction (dx, dy), straight or diagonal.
+	 * @return Index of the jump point, or -1 if there is none in that direction.
+	 */
+	int jump(int x, int y, int dx, int dy, int goal_x, int goal_y) const;
+};
+
+template <typename Visitor>
+std::size_t c_graph::dfs(const Node& start, c_traversal_state& state, Visitor&& visit) const {
+	state.begin(static_cast<std::size_t>(rows_) * cols_);
+	if (!is_walkable_at(start.x, start.y)) return 0;
+	std::size_t visited = 0;
+	state.push(cell_index(start.x, start.y));
+	while (!state.stack_empty()) {
+		// Cells are marked when popped, like dfs, so the visiting order matches it.
+		const int current = state.pop();
+		if (!state.visit(current)) continue;
+		++visited;
+		if (!visit(current)) break;
+
+		// Push up, down, left, right, skipping walls, edges and visited cells.
+		const int x = current / cols_;
+		const int y = current % cols_;
+		if (x > 0 && is_walkable(current - cols_) && !state.is_visited(current - cols_)) state.push(current - cols_);
+		if (x + 1 < rows_ && is_walkable(current + cols_) && !state.is_visited(current + cols_)) state.push(current + cols_);
+		if (y > 0 && is_walkable(current - 1) && !state.is_visited(current - 1)) state.push(current - 1);
+		if (y + 1 < cols_ && is_walkable(current + 1) && !state.is_visited(current + 1)) state.push(current + 1);
+	}
+	return visited;
+}
+
+template <typename Visitor>
+std::size_t c_graph::bfs(const Node& start, c_traversal_state& state, Visitor&& visit) const {
+	state.begin(static_cast<std::size_t>(rows_) * cols_);
+	if (!is_walkable_at(start.x, start.y)) return 0;
+	std::size_t visited = 0;
+	const int start_index = cell_index(start.x, start.y);
+	state.visit(start_index);
+	state.push_back(start_index);
+	while (!state.queue_empty()) {
+		// Cells are marked when queued, so each is queued once. The visiting order is the same as marking on pop.
+		const int current = state.pop_front();
+		++visited;
+		if (!visit(current)) break;
+
+		const int x = current / cols_;
+		const int y = current % cols_;
+		if (x > 0 && is_walkable(current - cols_) && state.visit(current - cols_)) state.push_back(current - cols_);
+		if (x + 1 < rows_ && is_walkable(current + cols_) && state.visit(current + cols_)) state.push_back(current + cols_);
+		if (y > 0 && is_walkable(current - 1) && state.visit(current - 1)) state.push_back(current - 1);
+		if (y + 1 < cols_ && is_walkable(current + 1) && state.visit(current + 1)) state.push_back(current + 1);
+	}
+	return visited;
+}
@@ -0,0 +1,133 @@
+#include "c_graph.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+template <typename Neighbourhood>
+std::vector<std::pair<int, int>> c_graph::bidirectional_a_star(const Node& start, const Node& goal, c_bidirectional_search_state& state) const {
+	std::vector<std::pair<int, int>> path;
+	bidirectional_a_star<Neighbourhood>(start, goal, state, path);
+	return path;
+}
+
+template <typename Neighbourhood>
+bool c_graph::bidirectional_a_star(const Node& start, const Node& goal, c_bidirectional_search_state& state, std::vector<std::pair<int, int>>& path) const {
+	const int straight[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} }; // Same order as a_star.
+	const int diagonal[4][2] = { {-1, -1}, {-1, 1}, {1, -1}, {1, 1} };
+	const int start_index = cell_index(start.x, start.y);
+	const int goal_index = cell_index(goal.x, goal.y);
+	c_search_state& forward = state.forward();
+	c_search_state& backward = state.backward();
+	// Reset both directions before any early return, so the stats are always this search's.
+	const std::size_t cell_count = static_cast<std::size_t>(rows_) * cols_;
+	forward.begin(cell_count);
+	backward.begin(cell_count);
+	if (start_index == goal_index) {
+		path.emplace_back(start.x, start.y);
+		forward.recorder().found = true;
+		forward.recorder().path_length = 1;
+		return true;
+	}
+	if (!is_walkable(goal_index)) return false; // a_star never enters a wall, so it cannot end on one either.
+	if (disconnected(start_index, goal_index)) return false;
+
+	// Cheapest known path through a cell both searches have scored, and that cell.
+	double best_cost = std::numeric_limits<double>::infinity();
+	int meeting = -1;
+
+	// The search and reconstruction are timed separately in instrumented builds, see c_search_stats.h.
+	{
+		c_phase_timer<> search_timer(forward.recorder().search_seconds);
+		// Balanced potentials: the forward search is keyed on g + p and the backward one on g - p, where
+		// p = (h(cell, goal) - h(cell, start)) / 2. Both stay consistent and the two searches see the same
+		// reduced step costs, which allows the tighter stopping rule below.
+		auto potential = [&](int x, int y) {
+			return (Neighbourhood::heuristic(std::abs(x - goal.x), std::abs(y - goal.y)) -
+				Neighbourhood::heuristic(std::abs(x - start.x), std::abs(y - start.y))) / 2.0;
+		};
+		forward.set_score(start_index, 0.0, -1);
+		forward.push_open(start_index, potential(start.x, start.y));
+		backward.set_score(goal_index, 0.0, -1);
+		backward.push_open(goal_index, -potential(goal.x, goal.y));
+
+		// Expand one cell of one direction. self searches with potential sign * p, other searches the opposite way.
+		auto expand = [&](c_search_state& self, const c_search_state& other, double sign) {
+			const int current = self.pop_open();
+			if (self.is_closed(current)) {
+				self.count_stale_pop();
+				return;
+			}
+			self.close(current);
+			const int cx = current / cols_;
+			const int cy = current % cols_;
+			const double current_g = self.g_score(current);
+
+			auto relax = [&](int nx, int ny, int neighbor, double step_cost) {
+				const double tentative_g_score = current_g + step_cost;
+				if (self.has_score(neighbor) && tentative_g_score >= self.g_score(neighbor)) return;
+				self.set_score(neighbor, tentative_g_score, current);
+				self.push_open(neighbor, tentative_g_score + sign * potential(nx, ny));
+				// The other search has been here, so there is a path through this cell.
+				if (other.has_score(neighbor) && tentative_g_score + other.g_score(neighbor) < best_cost) {
+					best_cost = tentative_g_score + other.g_score(neighbor);
+					meeting = neighbor;
+				}
+			};
+
+			for (const auto& dir : straight) {
+				const int nx = cx + dir[0];
+				const int ny = cy + dir[1];
+				if (nx < 0 || nx >= rows_ || ny < 0 || ny >= cols_) continue;
+				const int neighbor = cell_index(nx, ny);
+				if (self.is_closed(neighbor) || !is_walkable(neighbor)) continue;
+				relax(nx, ny, neighbor, 1.0);
+			}
+			if constexpr (Neighbourhood::diagonal) {
+				for (const auto& dir : diagonal) {
+					const int nx = cx + dir[0];
+					const int ny = cy + dir[1];
+					if (nx < 0 || nx >= rows_ || ny < 0 || ny >= cols_) continue;
+					const int neighbor = cell_index(nx, ny);
+					if (self.is_closed(neighbor) || !is_walkable(neighbor)) continue;
+					if (!is_walkable(cell_index(nx, cy)) || !is_walkable(cell_index(cx, ny))) continue; // No cutting corners.
+					relax(nx, ny, neighbor, Neighbourhood::diagonal_cost);
+				}
+			}
+		};
+
+		// Any path not yet found leaves the forward frontier at one open cell and enters the backward frontier at
+		// another, so it costs at least the sum of the two lowest keys. Once that reaches the best meeting, stop.
+		while (!forward.open_empty() && !backward.open_empty()) {
+			if (forward.open_min_score() + backward.open_min_score() >= best_cost) break;
+			if (forward.open_size() <= backward.open_size()) {
+				expand(forward, backward, 1.0);
+			} else {
+				expand(backward, forward, -1.0);
+			}
+		}
+	}
+	forward.recorder().build_seconds = build_seconds_;
+	if (meeting < 0) return false;
+
+	// Start to the meeting cell from the forward records, then on to the goal from the backward ones.
+	const std::size_t first = path.size();
+	{
+		c_phase_timer<> reconstruct_timer(forward.recorder().reconstruct_seconds);
+		for (int cell = meeting; cell != -1; cell = forward.came_from(cell)) {
+			path.emplace_back(cell / cols_, cell % cols_);
+		}
+		std::reverse(path.begin() + first, path.end());
+		for (int cell = backward.came_from(meeting); cell != -1; cell = backward.came_from(cell)) {
+			path.emplace_back(cell / cols_, cell % cols_);
+		}
+	}
+	forward.recorder().found = true;
+	forward.recorder().path_length = path.size() - first;
+	return true;
+}
+
+// The neighbourhoods bidirectional_a_star is compiled for.
+template std::vector<std::pair<int, int>> c_graph::bidirectional_a_star<Neighbourhood4>(const Node&, const Node&, c_bidirectional_search_state&) const;
+template std::vector<std::pair<int, int>> c_graph::bidirectional_a_star<Neighbourhood8>(const Node&, const Node&, c_bidirectional_search_state&) const;
+template bool c_graph::bidirectional_a_star<Neighbourhood4>(const Node&, const Node&, c_bidirectional_search_state&, std::vector<std::pair<int, int>>&) const;
+template bool c_graph::bidirectional_a_star<Neighbourhood8>(const Node&, const Node&, c_bidirectional_search_state&, std::vector<std::pair<int, int>>&) const;
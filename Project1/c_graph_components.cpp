@@ -0,0 +1,192 @@
+#include "c_graph.h"
+#include <numeric>
+
+namespace {
+	const int STRAIGHT[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+	// The 3x3 block around a cell, clockwise from above. Cells next to each other in it are straight neighbours.
+	const int RING[8][2] = { {-1, 0}, {-1, 1}, {0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1} };
+
+	std::uint64_t bit_of(std::size_t index) { return std::uint64_t(1) << (index & 63); }
+
+	// Start a run at a cell, numbering the runs after it in its block one higher.
+	void insert_run(ComponentLabels& components, std::size_t index, std::uint32_t label) {
+		components.run_starts[index >> 6] |= bit_of(index);
+		std::vector<std::uint32_t>& labels = components.block_labels[index / ComponentLabels::BLOCK_CELLS];
+		labels.insert(labels.begin() + components.run_of(index), label);
+		const std::size_t block_end = std::min(components.run_ranks.size(), (index / ComponentLabels::BLOCK_CELLS + 1) * ComponentLabels::BLOCK_WORDS);
+		for (std::size_t word = (index >> 6) + 1; word < block_end; ++word) ++components.run_ranks[word];
+		++components.run_count;
+	}
+
+	// Remove the run starting at a cell, numbering the runs after it in its block one lower.
+	void erase_run(ComponentLabels& components, std::size_t index) {
+		std::vector<std::uint32_t>& labels = components.block_labels[index / ComponentLabels::BLOCK_CELLS];
+		labels.erase(labels.begin() + components.run_of(index));
+		components.run_starts[index >> 6] &= ~bit_of(index);
+		const std::size_t block_end = std::min(components.run_ranks.size(), (index / ComponentLabels::BLOCK_CELLS + 1) * ComponentLabels::BLOCK_WORDS);
+		for (std::size_t word = (index >> 6) + 1; word < block_end; ++word) --components.run_ranks[word];
+		--components.run_count;
+	}
+
+	// Bring the run start bit of a cell in line with the floor around it. A floor cell starts a run at the start of a
+	// row or a block, or after a wall. A run started here gets the label given.
+	void update_run_start(ComponentLabels& components, const c_graph& graph, std::size_t index, std::uint32_t label) {
+		if (index >= static_cast<std::size_t>(graph.rows()) * graph.cols()) return;
+		const int cell = static_cast<int>(index);
+		const bool starts = graph.is_walkable(cell) &&
+			(cell % graph.cols() == 0 || index % ComponentLabels::BLOCK_CELLS == 0 || !graph.is_walkable(cell - 1));
+		const bool started = (components.run_starts[index >> 6] & bit_of(index)) != 0;
+		if (starts && !started) insert_run(components, index, label);
+		else if (!starts && started) erase_run(components, index);
+	}
+}
+
+std::uint32_t c_graph::new_component() {
+	if (component_parent_.size() >= 2 * components_.run_count + 64) compact_components();
+	const std::uint32_t label = static_cast<std::uint32_t>(component_parent_.size());
+	component_parent_.push_back(label);
+	component_ranks_.push_back(0);
+	++component_count_;
+	return label;
+}
+
+void c_graph::join_components(int x, int y) {
+	// The distinct regions the cell touches.
+	std::uint32_t touching[4];
+	int touching_count = 0;
+	for (const auto& dir : STRAIGHT) {
+		if (!is_walkable_at(x + dir[0], y + dir[1])) continue;
+		const std::uint32_t label = component_of(cell_index(x + dir[0], y + dir[1]));
+		if (std::find(touching, touching + touching_count, label) == touching + touching_count) touching[touching_count++] = label;
+	}
+
+	std::uint32_t joined;
+	if (touching_count == 0) { // A region of its own.
+		joined = new_component();
+	} else {
+		// The others are linked under the one of highest rank, so labels stay a few links deep and no run is relabelled.
+		joined = *std::max_element(touching, touching + touching_count,
+			[&](std::uint32_t a, std::uint32_t b) { return component_ranks_[a] < component_ranks_[b]; });
+		for (int i = 0; i < touching_count; ++i) {
+			if (touching[i] == joined) continue;
+			component_parent_[touching[i]] = joined;
+			if (component_ranks_[touching[i]] == component_ranks_[joined]) ++component_ranks_[joined];
+			--component_count_;
+		}
+	}
+
+	// The cell carries on the run to its left, or starts one, and takes in the one to its right.
+	const std::size_t index = cell_index(x, y);
+	update_run_start(components_, *this, index, joined);
+	update_run_start(components_, *this, index + 1, joined);
+	components_.label_of(index) = joined;
+}
+
+void c_graph::split_component(int x, int y) {
+	// The cell's run still starts where it did, so its label can be read before the run is cut. The cell to its right
+	// starts a run of its own with the same label.
+	const std::size_t index = cell_index(x, y);
+	const std::uint32_t run_label = components_.label_of(index);
+	update_run_start(components_, *this, index + 1, run_label);
+	update_run_start(components_, *this, index, run_label);
+
+	// Floor cells next to each other around the block stay joined through it, so only one straight neighbour per
+	// run of floor around the block can end up cut off from the others.
+	bool open[8];
+	int first_wall = -1;
+	for (int k = 0; k < 8; ++k) {
+		open[k] = is_walkable_at(x + RING[k][0], y + RING[k][1]);
+		if (!open[k] && first_wall < 0) first_wall = k;
+	}
+	if (first_wall < 0) return; // Floor all the way round.
+	int seeds[4];
+	int seed_count = 0;
+	bool run_has_seed = false;
+	for (int step = 1; step <= 8; ++step) {
+		const int k = (first_wall + step) % 8;
+		if (!open[k]) {
+			run_has_seed = false;
+		} else if (k % 2 == 0 && !run_has_seed) { // Even positions are the straight neighbours.
+			seeds[seed_count++] = cell_index(x + RING[k][0], y + RING[k][1]);
+			run_has_seed = true;
+		}
+	}
+	if (seed_count == 0) --component_count_; // The cell was the whole region.
+	if (seed_count <= 1) return;
+
+	// Flood out from every seed in turn, one cell each. Floods that meet are one side. A side whose floods have all
+	// run dry is cut off from the rest and gets a new label. Once one side is left, it keeps the old label.
+	ComponentScratch& scratch = component_scratch_;
+	scratch.begin(static_cast<std::size_t>(rows_) * cols_);
+	std::vector<int>* reached = scratch.reached; // Cells each flood has reached, in order, doubling as its queue.
+	std::size_t next[4] = {};
+	int side[4];                 // Flood each flood has met and joined, itself if none.
+	bool cut_off[4] = {};
+	for (int f = 0; f < seed_count; ++f) {
+		side[f] = f;
+		reached[f].push_back(seeds[f]);
+		scratch.reach(seeds[f], f);
+	}
+	auto side_of = [&](int f) {
+		while (side[f] != f) f = side[f];
+		return f;
+	};
+
+	int sides = seed_count;
+	while (sides > 1) {
+		for (int f = 0; f < seed_count; ++f) {
+			if (next[f] == reached[f].size()) continue;
+			const int current = reached[f][next[f]++];
+			const int cx = current / cols_;
+			const int cy = current % cols_;
+			for (const auto& dir : STRAIGHT) {
+				if (!is_walkable_at(cx + dir[0], cy + dir[1])) continue;
+				const int neighbor = cell_index(cx + dir[0], cy + dir[1]);
+				const int first = scratch.reach(neighbor, f);
+				if (first < 0) {
+					reached[f].push_back(neighbor);
+					continue;
+				}
+				const int a = side_of(first);
+				const int b = side_of(f);
+				if (a != b) {
+					side[std::max(a, b)] = std::min(a, b);
+					--sides;
+				}
+			}
+		}
+
+		for (int s = 0; s < seed_count && sides > 1; ++s) {
+			if (side[s] != s || cut_off[s]) continue;
+			bool dry = true;
+			for (int f = 0; f < seed_count; ++f) {
+				if (side_of(f) == s && next[f] < reached[f].size()) dry = false;
+			}
+			if (!dry) continue;
+			const std::uint32_t part = new_component();
+			for (int f = 0; f < seed_count; ++f) {
+				if (side_of(f) != s) continue;
+				for (const int cell : reached[f]) components_.label_of(static_cast<std::size_t>(cell)) = part;
+			}
+			cut_off[s] = true;
+			--sides;
+		}
+	}
+}
+
+void c_graph::compact_components() {
+	std::vector<std::uint32_t>& renumber = component_scratch_.renumber;
+	renumber.assign(component_parent_.size(), NO_COMPONENT);
+	std::uint32_t next = 0;
+	for (auto& labels : components_.block_labels) {
+		for (std::uint32_t& label : labels) {
+			std::uint32_t root = label;
+			while (component_parent_[root] != root) root = component_parent_[root];
+			if (renumber[root] == NO_COMPONENT) renumber[root] = next++;
+			label = renumber[root];
+		}
+	}
+	component_parent_.resize(next);
+	std::iota(component_parent_.begin(), component_parent_.end(), 0u);
+	component_ranks_.assign(next, 0);
+}
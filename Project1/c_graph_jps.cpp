@@ -0,0 +1,223 @@
+#include "c_graph.h"
+#include <bit>
+#include <cmath>
+
+namespace {
+	// Octile distance: diagonal steps for the shorter axis, straight steps for the rest.
+	double octile_distance(int x1, int y1, int x2, int y2) {
+		return Neighbourhood8::heuristic(std::abs(x1 - x2), std::abs(y1 - y2));
+	}
+
+	int sign(int value) {
+		return (value > 0) - (value < 0);
+	}
+}
+
+std::uint64_t c_graph::line_bits(const std::vector<std::uint64_t>& bits, int lines, int length, int line, int pos) {
+	if (line < 0 || line >= lines || pos >= length) return 0;
+	if (pos < 0) return line_bits(bits, lines, length, line, 0) << -pos; // Cells before the line read as walls.
+
+	// Gather 64 bits starting at the cell's bit offset, which may straddle two words.
+	const std::size_t index = static_cast<std::size_t>(line) * length + pos;
+	const std::size_t word = index >> 6;
+	const unsigned offset = index & 63;
+	std::uint64_t result = bits[word] >> offset;
+	if (offset != 0 && word + 1 < bits.size()) {
+		result |= bits[word + 1] << (64 - offset);
+	}
+
+	// Mask off anything past the end of the line.
+	const int remaining = length - pos;
+	if (remaining < 64) {
+		result &= (std::uint64_t(1) << remaining) - 1;
+	}
+	return result;
+}
+
+int c_graph::jump_straight(bool horizontal, int x, int y, int dir, int goal_x, int goal_y) const {
+	// Rows are scanned in walkable_, columns in walkable_columns_, with the same code.
+	const std::vector<std::uint64_t>& bits = horizontal ? walkable_ : walkable_columns_;
+	const int lines = horizontal ? rows_ : cols_;
+	const int length = horizontal ? cols_ : rows_;
+	const int line = horizontal ? x : y;
+	const int goal_line = horizontal ? goal_x : goal_y;
+	const int goal_pos = horizontal ? goal_y : goal_x;
+	int pos = horizontal ? y : x;
+	if (line < 0 || line >= lines || pos < 0 || pos >= length) return -1;
+
+	// A cell is a jump point if a cell beside it is open while the one beside the cell we came from
+	// was blocked. Those are found for 64 cells at once with shifts and masks.
+	while (true) {
+		const int base = dir > 0 ? pos : pos - 63; // Position of bit 0 in this window.
+		const std::uint64_t here = line_bits(bits, lines, length, line, base);
+		const std::uint64_t side_a = line_bits(bits, lines, length, line - 1, base);
+		const std::uint64_t side_b = line_bits(bits, lines, length, line + 1, base);
+		const std::uint64_t side_a_behind = line_bits(bits, lines, length, line - 1, base - dir); // Bit k is the cell behind base + k.
+		const std::uint64_t side_b_behind = line_bits(bits, lines, length, line + 1, base - dir);
+
+		std::uint64_t stop = ~here | (side_a & ~side_a_behind) | (side_b & ~side_b_behind);
+		if (line == goal_line && goal_pos >= base && goal_pos < base + 64) {
+			stop |= std::uint64_t(1) << (goal_pos - base);
+		}
+		if (stop != 0) {
+			const int bit = dir > 0 ? std::countr_zero(stop) : 63 - std::countl_zero(stop);
+			return ((here >> bit) & 1) ? base + bit : -1; // Walls end the jump with no jump point.
+		}
+		pos += 64 * dir;
+	}
+}
+
+int c_graph::jump(int x, int y, int dx, int dy, int goal_x, int goal_y) const {
+	if (dx == 0) {
+		const int col = jump_straight(true, x, y, dy, goal_x, goal_y);
+		return col < 0 ? -1 : cell_index(x, col);
+	}
+	if (dy == 0) {
+		const int row = jump_straight(false, x, y, dx, goal_x, goal_y);
+		return row < 0 ? -1 : cell_index(row, y);
+	}
+
+	// Diagonal: stop wherever a straight jump along either component would find something.
+	while (true) {
+		if (!is_walkable_at(x, y)) return -1;
+		if (x == goal_x && y == goal_y) return cell_index(x, y);
+		if (jump_straight(false, x + dx, y, dx, goal_x, goal_y) >= 0 || jump_straight(true, x, y + dy, dy, goal_x, goal_y) >= 0) {
+			return cell_index(x, y);
+		}
+		// The next diagonal step is only allowed if it does not cut a corner.
+		if (!is_walkable_at(x + dx, y) || !is_walkable_at(x, y + dy)) return -1;
+		x += dx;
+		y += dy;
+	}
+}
+
+std::vector<std::pair<int, int>> c_graph::jps(const Node& start, const Node& goal, c_search_state& state) const {
+	std::vector<std::pair<int, int>> path;
+	jps(start, goal, state, path);
+	return path;
+}
+
+bool c_graph::jps(const Node& start, const Node& goal, c_search_state& state, std::vector<std::pair<int, int>>& path) const {
+	const int goal_index = cell_index(goal.x, goal.y);
+	const int start_index = cell_index(start.x, start.y);
+	if (disconnected(start_index, goal_index)) {
+		state.begin(static_cast<std::size_t>(rows_) * cols_); // So the stats read as an empty search.
+		return false;
+	}
+
+	// The search and reconstruction are timed separately in instrumented builds, see c_search_stats.h.
+	int reached = -1;
+	{
+		c_phase_timer<> search_timer(state.recorder().search_seconds);
+		// Initialize the start node.
+		state.begin(static_cast<std::size_t>(rows_) * cols_);
+		state.set_score(start_index, 0.0, -1);
+		state.push_open(start_index, 0.0);
+
+		int directions[8][2];
+		while (!state.open_empty()) {
+			// Get the jump point with the lowest f_score.
+			const int current = state.pop_open();
+			if (state.is_closed(current)) {
+				state.count_stale_pop();
+				continue;
+			}
+			if (current == goal_index) {
+				reached = current;
+				break;
+			}
+			state.close(current);
+			const int x = current / cols_;
+			const int y = current % cols_;
+
+			// Work out which directions to jump in, pruning the ones the parent already covers.
+			int count = 0;
+			const int parent = state.came_from(current);
+			if (parent == -1) {
+				for (int dx = -1; dx <= 1; ++dx) {
+					for (int dy = -1; dy <= 1; ++dy) {
+						if (dx == 0 && dy == 0) continue;
+						if (dx != 0 && dy != 0 && (!is_walkable_at(x + dx, y) || !is_walkable_at(x, y + dy))) continue;
+						directions[count][0] = dx;
+						directions[count][1] = dy;
+						++count;
+					}
+				}
+			} else {
+				const int dx = sign(x - parent / cols_);
+				const int dy = sign(y - parent % cols_);
+				auto add = [&](int ddx, int ddy) { directions[count][0] = ddx; directions[count][1] = ddy; ++count; };
+				if (dx != 0 && dy != 0) {
+					const bool next_x = is_walkable_at(x + dx, y);
+					const bool next_y = is_walkable_at(x, y + dy);
+					if (next_x) add(dx, 0);
+					if (next_y) add(0, dy);
+					if (next_x && next_y) add(dx, dy);
+				} else if (dx != 0) {
+					const bool next = is_walkable_at(x + dx, y);
+					const bool left = is_walkable_at(x, y - 1);
+					const bool right = is_walkable_at(x, y + 1);
+					if (next) {
+						add(dx, 0);
+						if (left) add(dx, -1);
+						if (right) add(dx, 1);
+					}
+					if (left) add(0, -1);
+					if (right) add(0, 1);
+				} else {
+					const bool next = is_walkable_at(x, y + dy);
+					const bool up = is_walkable_at(x - 1, y);
+					const bool down = is_walkable_at(x + 1, y);
+					if (next) {
+						add(0, dy);
+						if (up) add(-1, dy);
+						if (down) add(1, dy);
+					}
+					if (up) add(-1, 0);
+					if (down) add(1, 0);
+				}
+			}
+
+			// Jump in each direction and relax the jump points found.
+			const double current_g = state.g_score(current);
+			for (int d = 0; d < count; ++d) {
+				const int dx = directions[d][0];
+				const int dy = directions[d][1];
+				const int jump_point = jump(x + dx, y + dy, dx, dy, goal.x, goal.y);
+				if (jump_point < 0 || state.is_closed(jump_point)) continue;
+				const int jx = jump_point / cols_;
+				const int jy = jump_point % cols_;
+				const double tentative_g_score = current_g + octile_distance(x, y, jx, jy);
+				if (!state.has_score(jump_point) || tentative_g_score < state.g_score(jump_point)) {
+					state.set_score(jump_point, tentative_g_score, current);
+					state.push_open(jump_point, tentative_g_score + octile_distance(jx, jy, goal.x, goal.y));
+				}
+			}
+		}
+	}
+	state.recorder().build_seconds = build_seconds_;
+	if (reached < 0) return false; // No path found, the output buffer is left untouched.
+
+	// Fill in the cells between consecutive jump points, diagonal first then straight.
+	const std::size_t first = path.size();
+	{
+		c_phase_timer<> reconstruct_timer(state.recorder().reconstruct_seconds);
+		int at = reached;
+		path.emplace_back(at / cols_, at % cols_);
+		for (int from = state.came_from(at); from != -1; at = from, from = state.came_from(at)) {
+			int x = at / cols_;
+			int y = at % cols_;
+			const int to_x = from / cols_;
+			const int to_y = from % cols_;
+			while (x != to_x || y != to_y) {
+				x += sign(to_x - x);
+				y += sign(to_y - y);
+				path.emplace_back(x, y);
+			}
+		}
+		std::reverse(path.begin() + first, path.end());
+	}
+	state.recorder().found = true;
+	state.recorder().path_length = path.size() - first;
+	return true;
+}
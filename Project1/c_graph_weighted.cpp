@@ -0,0 +1,109 @@
+#include "c_graph.h"
+#include <algorithm>
+#include <cstdlib>
+
+template <typename Neighbourhood>
+std::vector<std::pair<int, int>> c_graph::weighted_a_star(const Node& start, const Node& goal, c_weighted_search_state& state) const {
+	std::vector<std::pair<int, int>> path;
+	weighted_a_star<Neighbourhood>(start, goal, state, path);
+	return path;
+}
+
+template <typename Neighbourhood>
+bool c_graph::weighted_a_star(const Node& start, const Node& goal, c_weighted_search_state& state, std::vector<std::pair<int, int>>& path) const {
+	const int straight[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} }; // Same order as a_star.
+	const int diagonal[4][2] = { {-1, -1}, {-1, 1}, {1, -1}, {1, 1} };
+	const int goal_index = cell_index(goal.x, goal.y);
+	if (disconnected(cell_index(start.x, start.y), goal_index)) {
+		state.begin(static_cast<std::size_t>(rows_) * cols_); // So the stats read as an empty search.
+		return false;
+	}
+	const std::uint8_t* costs = costs_.empty() ? nullptr : costs_.data(); // Null while every cell costs FLOOR_COST.
+
+	// No cell costs less than min_cost_, so neither does any step: scaling the distance by it keeps the heuristic admissible.
+	const std::uint64_t straight_bound = STRAIGHT_STEP_COSTS[min_cost_];
+	const std::uint64_t diagonal_bound = DIAGONAL_STEP_COSTS[min_cost_];
+	auto heuristic = [&](int x, int y) -> std::uint64_t {
+		const std::uint64_t dx = static_cast<std::uint64_t>(std::abs(x - goal.x));
+		const std::uint64_t dy = static_cast<std::uint64_t>(std::abs(y - goal.y));
+		if constexpr (Neighbourhood::diagonal) {
+			return diagonal_bound * std::min(dx, dy) + straight_bound * (std::max(dx, dy) - std::min(dx, dy));
+		} else {
+			return straight_bound * (dx + dy);
+		}
+	};
+
+	// The search and reconstruction are timed separately in instrumented builds, see c_search_stats.h.
+	int reached = -1;
+	{
+		c_phase_timer<> search_timer(state.recorder().search_seconds);
+		state.begin(static_cast<std::size_t>(rows_) * cols_);
+		const int start_index = cell_index(start.x, start.y);
+		state.set_score(start_index, 0, -1);
+		state.push_open(start_index, 0);
+
+		while (!state.open_empty()) {
+			const int current = state.pop_open();
+			if (state.is_closed(current)) { // Stale duplicate, already expanded with a better score.
+				state.count_stale_pop();
+				continue;
+			}
+			if (current == goal_index) {
+				reached = current;
+				break;
+			}
+			state.close(current);
+			const int cx = current / cols_;
+			const int cy = current % cols_;
+			const std::uint64_t current_g = state.g_score(current);
+
+			auto relax = [&](int nx, int ny, int neighbor, const std::array<std::uint32_t, 256>& step_costs) {
+				const std::uint64_t tentative_g_score = current_g + step_costs[costs ? costs[neighbor] : FLOOR_COST];
+				if (!state.has_score(neighbor) || tentative_g_score < state.g_score(neighbor)) {
+					state.set_score(neighbor, tentative_g_score, current);
+					state.push_open(neighbor, tentative_g_score + heuristic(nx, ny));
+				}
+			};
+
+			for (const auto& dir : straight) {
+				const int nx = cx + dir[0];
+				const int ny = cy + dir[1];
+				if (nx < 0 || nx >= rows_ || ny < 0 || ny >= cols_) continue;
+				const int neighbor = cell_index(nx, ny);
+				if (state.is_closed(neighbor) || !is_walkable(neighbor)) continue;
+				relax(nx, ny, neighbor, STRAIGHT_STEP_COSTS);
+			}
+			if constexpr (Neighbourhood::diagonal) {
+				for (const auto& dir : diagonal) {
+					const int nx = cx + dir[0];
+					const int ny = cy + dir[1];
+					if (nx < 0 || nx >= rows_ || ny < 0 || ny >= cols_) continue;
+					const int neighbor = cell_index(nx, ny);
+					if (state.is_closed(neighbor) || !is_walkable(neighbor)) continue;
+					if (!is_walkable(cell_index(nx, cy)) || !is_walkable(cell_index(cx, ny))) continue; // No cutting corners.
+					relax(nx, ny, neighbor, DIAGONAL_STEP_COSTS);
+				}
+			}
+		}
+	}
+	state.recorder().build_seconds = build_seconds_;
+	if (reached < 0) return false; // No path found, the output buffer is left untouched.
+
+	const std::size_t first = path.size();
+	{
+		c_phase_timer<> reconstruct_timer(state.recorder().reconstruct_seconds);
+		for (int cell = reached; cell != -1; cell = state.came_from(cell)) {
+			path.emplace_back(cell / cols_, cell % cols_);
+		}
+		std::reverse(path.begin() + first, path.end());
+	}
+	state.recorder().found = true;
+	state.recorder().path_length = path.size() - first;
+	return true;
+}
+
+// The neighbourhoods weighted_a_star is compiled for.
+template std::vector<std::pair<int, int>> c_graph::weighted_a_star<Neighbourhood4>(const Node&, const Node&, c_weighted_search_state&) const;
+template std::vector<std::pair<int, int>> c_graph::weighted_a_star<Neighbourhood8>(const Node&, const Node&, c_weighted_search_state&) const;
+template bool c_graph::weighted_a_star<Neighbourhood4>(const Node&, const Node&, c_weighted_search_state&, std::vector<std::pair<int, int>>&) const;
+template bool c_graph::weighted_a_star<Neighbourhood8>(const Node&, const Node&, c_weighted_search_state&, std::vector<std::pair<int, int>>&) const;
@@ -0,0 +1,334 @@
+#include "c_hpa.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+	constexpr int MAX_SINGLE_ENTRANCE_WIDTH = 6; // Narrower border openings get one entrance in the middle, wider ones one at each end.
+}
+
+c_hpa_graph::c_hpa_graph(const c_graph& graph, int cluster_size)
+	: graph_(graph), cluster_size_(cluster_size) {
+	if (cluster_size < 2) {
+		throw std::invalid_argument("Cluster size must be at least 2");
+	}
+	cluster_rows_ = (graph.rows() + cluster_size - 1) / cluster_size;
+	cluster_cols_ = (graph.cols() + cluster_size - 1) / cluster_size;
+
+	// Lay out the clusters, the last row and column may be smaller.
+	clusters_.resize(static_cast<std::size_t>(cluster_rows_) * cluster_cols_);
+	for (int r = 0; r < cluster_rows_; ++r) {
+		for (int c = 0; c < cluster_cols_; ++c) {
+			Cluster& cluster = clusters_[static_cast<std::size_t>(r) * cluster_cols_ + c];
+			cluster.x0 = r * cluster_size;
+			cluster.y0 = c * cluster_size;
+			cluster.x1 = std::min(cluster.x0 + cluster_size, graph.rows());
+			cluster.y1 = std::min(cluster.y0 + cluster_size, graph.cols());
+		}
+	}
+
+	for (int i = 0; i < static_cast<int>(clusters_.size()); ++i) {
+		rebuild_cluster(i);
+	}
+	flatten_nodes();
+}
+
+int c_hpa_graph::local_index(const Cluster& cluster, int cell) const {
+	const int x = cell / graph_.cols();
+	const int y = cell % graph_.cols();
+	return (x - cluster.x0 + 1) * (cluster.y1 - cluster.y0 + 2) + (y - cluster.y0 + 1);
+}
+
+int c_hpa_graph::global_index(const Cluster& cluster, int local) const {
+	const int stride = cluster.y1 - cluster.y0 + 2;
+	return graph_.cell_index(cluster.x0 + local / stride - 1, cluster.y0 + local % stride - 1);
+}
+
+void c_hpa_graph::load_cluster_grid(const Cluster& cluster) {
+	// One ring of walls around the cluster, so the BFS never needs a bounds check.
+	const int stride = cluster.y1 - cluster.y0 + 2;
+	cluster_grid_.assign(static_cast<std::size_t>(cluster.x1 - cluster.x0 + 2) * stride, 0);
+	for (int x = cluster.x0; x < cluster.x1; ++x) {
+		for (int y = cluster.y0; y < cluster.y1; ++y) {
+			cluster_grid_[(x - cluster.x0 + 1) * stride + (y - cluster.y0 + 1)] = graph_.is_walkable(graph_.cell_index(x, y));
+		}
+	}
+}
+
+void c_hpa_graph::add_border_entrances(std::vector<std::pair<int, int>>& entrances, bool vertical, int own_line, int other_line, int from, int to) const {
+	// Cell index of position `along` on a line, for either border orientation.
+	auto cell = [&](int line, int along) {
+		return vertical ? graph_.cell_index(along, line) : graph_.cell_index(line, along);
+	};
+	auto add = [&](int along) { entrances.emplace_back(cell(own_line, along), cell(other_line, along)); };
+
+	// Walk the border finding runs where both sides are open.
+	int run_start = -1;
+	for (int along = from; along <= to; ++along) {
+		const bool open = along < to && graph_.is_walkable(cell(own_line, along)) && graph_.is_walkable(cell(other_line, along));
+		if (open && run_start < 0) {
+			run_start = along;
+		} else if (!open && run_start >= 0) {
+			const int run_end = along - 1;
+			if (run_end - run_start + 1 < MAX_SINGLE_ENTRANCE_WIDTH) {
+				add((run_start + run_end) / 2);
+			} else {
+				add(run_start);
+				add(run_end);
+			}
+			run_start = -1;
+		}
+	}
+}
+
+void c_hpa_graph::rebuild_cluster(int index) {
+	Cluster& cluster = clusters_[index];
+	const int r = index / cluster_cols_;
+	const int c = index % cluster_cols_;
+
+	// Collect (own cell, partner cell) pairs from each border that has a neighbour on the other side.
+	std::vector<std::pair<int, int>> pairs;
+	if (r > 0) add_border_entrances(pairs, false, cluster.x0, cluster.x0 - 1, cluster.y0, cluster.y1);
+	if (r + 1 < cluster_rows_) add_border_entrances(pairs, false, cluster.x1 - 1, cluster.x1, cluster.y0, cluster.y1);
+	if (c > 0) add_border_entrances(pairs, true, cluster.y0, cluster.y0 - 1, cluster.x0, cluster.x1);
+	if (c + 1 < cluster_cols_) add_border_entrances(pairs, true, cluster.y1 - 1, cluster.y1, cluster.x0, cluster.x1);
+
+	// Merge pairs on the same cell (corner cells can sit on two borders) into one entrance.
+	std::sort(pairs.begin(), pairs.end());
+	cluster.entrances.clear();
+	for (const auto& pair : pairs) {
+		if (cluster.entrances.empty() || cluster.entrances.back().cell != pair.first) {
+			cluster.entrances.push_back({ pair.first, { -1, -1, -1, -1 } });
+		}
+		for (int& partner : cluster.entrances.back().partners) {
+			if (partner == -1 || partner == pair.second) {
+				partner = pair.second;
+				break;
+			}
+		}
+	}
+
+	// Shortest distances between every pair of entrances, staying inside the cluster. The paths themselves are
+	// found again when a query needs them, see find_path.
+	const std::size_t count = cluster.entrances.size();
+	cluster.distances.assign(count * count, -1);
+	load_cluster_grid(cluster);
+	for (std::size_t a = 0; a < count; ++a) {
+		cluster_bfs(cluster, cluster.entrances[a].cell, segment_distance_, segment_parent_);
+		for (std::size_t b = 0; b < count; ++b) {
+			cluster.distances[a * count + b] = segment_distance_[local_index(cluster, cluster.entrances[b].cell)];
+		}
+	}
+}
+
+void c_hpa_graph::flatten_nodes() {
+	// Only a prefix sum over clusters, so an edit does not touch every entrance.
+	node_offset_.resize(clusters_.size() + 1);
+	int offset = 0;
+	for (std::size_t c = 0; c < clusters_.size(); ++c) {
+		node_offset_[c] = offset;
+		offset += static_cast<int>(clusters_[c].entrances.size());
+	}
+	node_offset_[clusters_.size()] = offset;
+}
+
+std::size_t c_hpa_graph::memory_usage() const {
+	std::size_t bytes = clusters_.capacity() * sizeof(Cluster) + node_offset_.capacity() * sizeof(int);
+	for (const Cluster& cluster : clusters_) {
+		bytes += cluster.entrances.capacity() * sizeof(Entrance) + cluster.distances.capacity() * sizeof(int);
+	}
+	return bytes;
+}
+
+int c_hpa_graph::node_cluster(int node) const {
+	return static_cast<int>(std::upper_bound(node_offset_.begin(), node_offset_.end(), node) - node_offset_.begin()) - 1;
+}
+
+int c_hpa_graph::node_cell(int node) const {
+	const int cluster = node_cluster(node);
+	return clusters_[cluster].entrances[node - node_offset_[cluster]].cell;
+}
+
+int c_hpa_graph::node_id(int cell) const {
+	const int cluster = cluster_of(cell / graph_.cols(), cell % graph_.cols());
+	const auto& entrances = clusters_[cluster].entrances;
+	const auto it = std::lower_bound(entrances.begin(), entrances.end(), cell,
+		[](const Entrance& entrance, int key) { return entrance.cell < key; });
+	if (it == entrances.end() || it->cell != cell) return -1;
+	return node_offset_[cluster] + static_cast<int>(it - entrances.begin());
+}
+
+void c_hpa_graph::cluster_bfs(const Cluster& cluster, int source, std::vector<int>& distance, std::vector<int>& parent, int target) {
+	const int stride = cluster.y1 - cluster.y0 + 2;
+	const int steps[4] = { -stride, stride, -1, 1 };
+	distance.assign(cluster_grid_.size(), -1);
+	parent.assign(cluster_grid_.size(), -1);
+	bfs_queue_.clear();
+
+	const int source_local = local_index(cluster, source);
+	const int target_local = target >= 0 ? local_index(cluster, target) : -1;
+	distance[source_local] = 0;
+	bfs_queue_.push_back(source_local);
+	for (std::size_t head = 0; head < bfs_queue_.size(); ++head) {
+		const int current = bfs_queue_[head];
+		if (current == target_local) return;
+		const int next_distance = distance[current] + 1;
+		for (int step : steps) {
+			const int local = current + step;
+			if (!cluster_grid_[local] || distance[local] >= 0) continue;
+			distance[local] = next_distance;
+			parent[local] = current;
+			bfs_queue_.push_back(local);
+		}
+	}
+}
+
+int c_hpa_graph::on_cell_changed(int x, int y) {
+	// The cell's own cluster always changes. A cell on a shared border also changes the entrances
+	// of the cluster on the other side.
+	const int cluster = cluster_of(x, y);
+	const Cluster& bounds = clusters_[cluster];
+	int rebuilt = 1;
+	rebuild_cluster(cluster);
+	if (x == bounds.x0 && x > 0) { rebuild_cluster(cluster - cluster_cols_); ++rebuilt; }
+	if (x == bounds.x1 - 1 && bounds.x1 < graph_.rows()) { rebuild_cluster(cluster + cluster_cols_); ++rebuilt; }
+	if (y == bounds.y0 && y > 0) { rebuild_cluster(cluster - 1); ++rebuilt; }
+	if (y == bounds.y1 - 1 && bounds.y1 < graph_.cols()) { rebuild_cluster(cluster + 1); ++rebuilt; }
+	flatten_nodes();
+	return rebuilt;
+}
+
+std::vector<std::pair<int, int>> c_hpa_graph::find_path(const Node& start, const Node& goal) {
+	std::vector<std::pair<int, int>> path;
+	find_path(start, goal, path);
+	return path;
+}
+
+bool c_hpa_graph::find_path(const Node& start, const Node& goal, std::vector<std::pair<int, int>>& path) {
+	const int cols = graph_.cols();
+	const int start_cell = graph_.cell_index(start.x, start.y);
+	const int goal_cell = graph_.cell_index(goal.x, goal.y);
+	if (!graph_.is_walkable(start_cell) || !graph_.is_walkable(goal_cell)) return false;
+	if (graph_.disconnected(start_cell, goal_cell)) return false;
+
+	// Link the start and goal to the entrances of their own clusters.
+	const Cluster& start_cluster = clusters_[cluster_of(start.x, start.y)];
+	const Cluster& goal_cluster = clusters_[cluster_of(goal.x, goal.y)];
+	load_cluster_grid(start_cluster);
+	cluster_bfs(start_cluster, start_cell, start_distance_, start_parent_);
+	load_cluster_grid(goal_cluster);
+	cluster_bfs(goal_cluster, goal_cell, goal_distance_, goal_parent_);
+	const int start_base = node_offset_[cluster_of(start.x, start.y)];
+
+	// Abstract A*: entrance ids, plus the start and goal as two extra nodes on the end.
+	const int node_count = node_offset_.back();
+	const int start_node = node_count;
+	const int goal_node = node_count + 1;
+	auto heuristic = [&](int cell) {
+		return std::abs(cell / cols - goal.x) + std::abs(cell % cols - goal.y);
+	};
+	c_search_state& state = abstract_state_;
+	state.begin(static_cast<std::size_t>(node_count) + 2);
+	state.set_score(start_node, 0.0, -1);
+	state.push_open(start_node, 0.0);
+
+	bool found = false;
+	while (!state.open_empty()) {
+		const int current = state.pop_open();
+		if (state.is_closed(current)) {
+			state.count_stale_pop();
+			continue;
+		}
+		if (current == goal_node) {
+			found = true;
+			break;
+		}
+		state.close(current);
+		const double current_g = state.g_score(current);
+		auto relax = [&](int neighbor, double cost, int neighbor_cell) {
+			if (state.is_closed(neighbor)) return;
+			const double tentative_g_score = current_g + cost;
+			if (!state.has_score(neighbor) || tentative_g_score < state.g_score(neighbor)) {
+				state.set_score(neighbor, tentative_g_score, current);
+				state.push_open(neighbor, tentative_g_score + heuristic(neighbor_cell));
+			}
+		};
+
+		if (current == start_node) {
+			// Out of the start cluster's entrances, or straight to the goal if it shares the cluster.
+			for (std::size_t k = 0; k < start_cluster.entrances.size(); ++k) {
+				const int d = start_distance_[local_index(start_cluster, start_cluster.entrances[k].cell)];
+				if (d >= 0) relax(start_base + static_cast<int>(k), d, start_cluster.entrances[k].cell);
+			}
+			if (&start_cluster == &goal_cluster && start_distance_[local_index(start_cluster, goal_cell)] >= 0) {
+				relax(goal_node, start_distance_[local_index(start_cluster, goal_cell)], goal_cell);
+			}
+			continue;
+		}
+
+		// Intra-cluster edges to the other entrances, inter-cluster edges across the border.
+		const int cluster_index = node_cluster(current);
+		const Cluster& cluster = clusters_[cluster_index];
+		const std::size_t count = cluster.entrances.size();
+		const int local = current - node_offset_[cluster_index];
+		for (std::size_t k = 0; k < count; ++k) {
+			const int d = cluster.distances[local * count + k];
+			if (d > 0) relax(node_offset_[cluster_index] + static_cast<int>(k), d, cluster.entrances[k].cell);
+		}
+		for (int partner : cluster.entrances[local].partners) {
+			if (partner < 0) break;
+			const int partner_node = node_id(partner);
+			if (partner_node >= 0) relax(partner_node, 1.0, partner);
+		}
+		if (&cluster == &goal_cluster) {
+			const int d = goal_distance_[local_index(goal_cluster, cluster.entrances[local].cell)];
+			if (d >= 0) relax(goal_node, d, goal_cell);
+		}
+	}
+	if (!found) return false;
+
+	// Walk the abstract path back from the goal.
+	abstract_path_.clear();
+	for (int node = goal_node; node != -1; node = state.came_from(node)) {
+		abstract_path_.push_back(node);
+	}
+	std::reverse(abstract_path_.begin(), abstract_path_.end());
+
+	// Refine each abstract edge into cells. Each segment is appended without its first cell,
+	// which the previous segment already added.
+	path.emplace_back(start.x, start.y);
+	auto append_cell = [&](int cell) { path.emplace_back(cell / cols, cell % cols); };
+	for (std::size_t i = 1; i < abstract_path_.size(); ++i) {
+		const int from = abstract_path_[i - 1];
+		const int to = abstract_path_[i];
+		if (from == start_node) {
+			// Start to an entrance (or the goal): follow the start BFS parents back, then reverse.
+			const int target = to == goal_node ? goal_cell : node_cell(to);
+			const std::size_t segment = path.size();
+			for (int at = local_index(start_cluster, target); start_parent_[at] != -1; at = start_parent_[at]) {
+				append_cell(global_index(start_cluster, at));
+			}
+			std::reverse(path.begin() + segment, path.end());
+		} else if (to == goal_node) {
+			// Entrance to the goal: the goal BFS parents already point towards the goal.
+			for (int at = goal_parent_[local_index(goal_cluster, node_cell(from))]; at != -1; at = goal_parent_[at]) {
+				append_cell(global_index(goal_cluster, at));
+			}
+		} else if (node_cluster(from) != node_cluster(to)) {
+			append_cell(node_cell(to)); // Single step across the border.
+		} else {
+			// Through the cluster: search it again from one entrance until the other is reached, the same search
+			// the distance came from, so the path is as long. Parents point back to the first, so walk and reverse.
+			const Cluster& cluster = clusters_[node_cluster(from)];
+			const int target = node_cell(to);
+			load_cluster_grid(cluster);
+			cluster_bfs(cluster, node_cell(from), segment_distance_, segment_parent_, target);
+			const std::size_t segment = path.size();
+			for (int at = local_index(cluster, target); segment_parent_[at] != -1; at = segment_parent_[at]) {
+				append_cell(global_index(cluster, at));
+			}
+			std::reverse(path.begin() + segment, path.end());
+		}
+	}
+	return true;
+}
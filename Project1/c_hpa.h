@@ -0,0 +1,132 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_hpa.h
+// Description : Hierarchical pathfinding (HPA*) over clusters of a c_graph.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "c_graph.h"
+#include "c_search_state.h"
+
+/**
+ * @brief Abstract graph over a c_graph, for fast near-optimal 4-way paths on very large maps.
+ * @note  The grid is cut into square clusters. Where two clusters share open border cells,
+ *        entrances are placed on both sides, and the distances between the entrances of each cluster
+ *        are precomputed. A query links the start and goal to their clusters' entrances, searches the
+ *        small abstract graph, then refines each step through a cluster back into cells with a
+ *        breadth-first search kept inside that cluster. Only the distances are stored, so memory
+ *        grows with the entrances and not with the length of the paths between them.
+ */
+class c_hpa_graph {
+public:
+	/**
+	 * @brief Build the abstract graph.
+	 * @param graph        - The graph to abstract, must outlive this object.
+	 * @param cluster_size - Width and height of a cluster in cells.
+	 */
+	explicit c_hpa_graph(const c_graph& graph, int cluster_size = 16);
+
+	/**
+	 * @brief Find a path from the start node to the goal node through the abstract graph.
+	 * @return A vector of pairs representing every cell on the path, empty if no path exists.
+	 */
+	std::vector<std::pair<int, int>> find_path(const Node& start, const Node& goal);
+	/**
+	 * @brief Find a path, appending it to a caller-owned buffer.
+	 * @return True if a path was found, the buffer is left unchanged otherwise.
+	 */
+	bool find_path(const Node& start, const Node& goal, std::vector<std::pair<int, int>>& path);
+
+	/**
+	 * @brief Update the abstraction after a cell of the graph changed (see c_graph::set_walkable).
+	 * @param x - The x-coordinate (row) of the changed cell.
+	 * @param y - The y-coordinate (column) of the changed cell.
+	 * @return  - The number of clusters rebuilt: the cell's own, plus any neighbour sharing a border with the cell.
+	 */
+	int on_cell_changed(int x, int y);
+
+	std::size_t abstract_node_count() const { return node_offset_.back(); } // Number of entrances.
+	std::size_t expansions() const { return abstract_state_.expansions(); } // Abstract nodes expanded by the last query.
+	/**
+	 * @brief Get the memory held by the abstraction, in bytes, leaving out the query scratch.
+	 */
+	std::size_t memory_usage() const;
+
+private:
+	struct Entrance {
+		int cell;           // Cell index of the entrance, inside its cluster.
+		int partners[4];    // Cells across the cluster border this entrance connects to, -1 if unused.
+	};
+
+	struct Cluster {
+		int x0, y0, x1, y1;                   // Cell bounds, [x0, x1) by [y0, y1).
+		std::vector<Entrance> entrances;      // Sorted by cell.
+		std::vector<int> distances;           // entrances * entrances, -1 where unreachable inside the cluster.
+	};
+
+	const c_graph& graph_;
+	int cluster_size_;
+	int cluster_rows_;
+	int cluster_cols_;
+	std::vector<Cluster> clusters_;
+
+	// Flattened abstract node ids: entrance k of cluster c has id node_offset_[c] + k.
+	std::vector<int> node_offset_;
+
+	// Scratch reused between queries.
+	c_search_state abstract_state_;
+	std::vector<int> bfs_queue_;
+	std::vector<std::uint8_t> cluster_grid_;         // Walkability of the cluster being searched, with a wall ring around it.
+	std::vector<int> start_distance_, start_parent_; // Cluster-local BFS from the start.
+	std::vector<int> goal_distance_, goal_parent_;   // Cluster-local BFS from the goal.
+	std::vector<int> segment_distance_, segment_parent_; // Cluster-local BFS refining one step through a cluster.
+	std::vector<int> abstract_path_;
+
+	int cluster_of(int x, int y) const { return (x / cluster_size_) * cluster_cols_ + y / cluster_size_; }
+
+	/**
+	 * @brief Recompute the entrances and distances of one cluster.
+	 */
+	void rebuild_cluster(int cluster);
+	/**
+	 * @brief Recompute the flattened abstract node ids after clusters were rebuilt.
+	 */
+	void flatten_nodes();
+	int node_cluster(int node) const; // Cluster owning an abstract node id.
+	int node_cell(int node) const;    // Cell index of an abstract node id.
+	/**
+	 * @brief Add the entrance pairs across one border of a cluster.
+	 * @param entrances - (own cell, partner cell) pairs are appended here.
+	 * @param vertical  - True for a border between two columns, false for one between two rows.
+	 * @param own_line  - The cluster's row or column along the border.
+	 * @param other_line - The neighbour's row or column along the border.
+	 * @param from, to  - Range along the border, [from, to).
+	 */
+	void add_border_entrances(std::vector<std::pair<int, int>>& entrances, bool vertical, int own_line, int other_line, int from, int to) const;
+	/**
+	 * @brief Copy a cluster's walkability into cluster_grid_, ready for cluster_bfs.
+	 */
+	void load_cluster_grid(const Cluster& cluster);
+	/**
+	 * @brief Breadth-first search from a cell, restricted to the cluster loaded by load_cluster_grid.
+	 * @param distance - Distances by cluster-local index, -1 where unreached.
+	 * @param parent   - Parents by cluster-local index, as cluster-local indices, -1 for the source.
+	 * @param target   - Cell to stop at once it is reached, or -1 to reach every cell the source can.
+	 */
+	void cluster_bfs(const Cluster& cluster, int source, std::vector<int>& distance, std::vector<int>& parent, int target = -1);
+	int local_index(const Cluster& cluster, int cell) const;
+	int global_index(const Cluster& cluster, int local) const;
+	/**
+	 * @brief Get the abstract id of the entrance at a cell, or -1 if the cell is not an entrance.
+	 */
+	int node_id(int cell) const;
+};
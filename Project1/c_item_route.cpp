@@ -0,0 +1,273 @@
+#include "c_item_route.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+	constexpr int UNREACHABLE = std::numeric_limits<int>::max();
+}
+
+c_item_route_planner::c_item_route_planner(const c_graph& graph, std::size_t max_exact_items)
+	: graph_(graph), max_exact_items_(max_exact_items) {
+	if (max_exact_items > 20) {
+		throw std::invalid_argument("Exact item limit is too large for the bitmask solver");
+	}
+}
+
+void c_item_route_planner::build_distances(const std::vector<int>& points) {
+	const int rows = graph_.rows();
+	const int cols = graph_.cols();
+	padded_cols_ = cols + 2;
+	const std::size_t padded_cells = static_cast<std::size_t>(rows + 2) * padded_cols_;
+	point_count_ = points.size();
+	distances_.assign(point_count_ * point_count_, -1);
+
+	// Copy the walkability into the padded grid, the ring around it stays wall.
+	open_.assign((padded_cells + 63) / 64, 0);
+	for (int x = 0; x < rows; ++x) {
+		for (int y = 0; y < cols; ++y) {
+			if (!graph_.is_walkable(graph_.cell_index(x, y))) continue;
+			const std::size_t padded = static_cast<std::size_t>(x + 1) * padded_cols_ + y + 1;
+			open_[padded >> 6] |= std::uint64_t(1) << (padded & 63);
+		}
+	}
+
+	// Mark the points so a search can tell in one bit test whether a cell is one of them.
+	target_bits_.assign(open_.size(), 0);
+	padded_points_.clear();
+	std::vector<std::pair<int, int>> by_cell;
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		const int padded = (points[i] / cols + 1) * padded_cols_ + points[i] % cols + 1;
+		padded_points_.push_back(padded);
+		by_cell.emplace_back(padded, static_cast<int>(i));
+		target_bits_[static_cast<std::size_t>(padded) >> 6] |= std::uint64_t(1) << (padded & 63);
+	}
+	std::sort(by_cell.begin(), by_cell.end());
+	sorted_points_.clear();
+	sorted_point_ids_.clear();
+	for (const auto& [cell, id] : by_cell) {
+		sorted_points_.push_back(cell);
+		sorted_point_ids_.push_back(id);
+	}
+
+	// Distances are symmetric, so the search from point i only has to find the points after it.
+	for (std::size_t i = 0; i + 1 < point_count_; ++i) {
+		search_from(i);
+	}
+	if (point_count_ > 0) {
+		distances_[(point_count_ - 1) * point_count_ + point_count_ - 1] = 0;
+	}
+}
+
+void c_item_route_planner::search_from(std::size_t source) {
+	int* row = distances_.data() + source * point_count_;
+	row[source] = 0;
+	const int source_cell = padded_points_[source];
+
+	// Count the later points still to be found, a point sharing the source cell is found already.
+	std::size_t remaining = 0;
+	for (std::size_t j = source + 1; j < point_count_; ++j) {
+		if (padded_points_[j] == source_cell) {
+			row[j] = 0;
+			distances_[j * point_count_ + source] = 0;
+		} else {
+			++remaining;
+		}
+	}
+	const std::uint64_t source_bit = std::uint64_t(1) << (source_cell & 63);
+	if (remaining == 0 || !(open_[static_cast<std::size_t>(source_cell) >> 6] & source_bit)) return;
+
+	// Level-by-level BFS, so the distance is the level number and needs no per-cell storage.
+	unvisited_ = open_;
+	unvisited_[static_cast<std::size_t>(source_cell) >> 6] &= ~source_bit;
+	frontier_.assign(1, source_cell);
+	const int steps[4] = { -padded_cols_, padded_cols_, -1, 1 };
+	for (int level = 1; !frontier_.empty() && remaining > 0; ++level) {
+		next_frontier_.clear();
+		for (const int cell : frontier_) {
+			for (const int step : steps) {
+				const int neighbor = cell + step;
+				const std::size_t word = static_cast<std::size_t>(neighbor) >> 6;
+				const std::uint64_t bit = std::uint64_t(1) << (neighbor & 63);
+				if (!(unvisited_[word] & bit)) continue;
+				unvisited_[word] &= ~bit;
+				next_frontier_.push_back(neighbor);
+				if (!(target_bits_[word] & bit)) continue;
+
+				// A point of interest, record it for every point on this cell.
+				const auto range = std::equal_range(sorted_points_.begin(), sorted_points_.end(), neighbor);
+				for (auto it = range.first; it != range.second; ++it) {
+					const std::size_t j = static_cast<std::size_t>(sorted_point_ids_[it - sorted_points_.begin()]);
+					if (j <= source || row[j] >= 0) continue;
+					row[j] = level;
+					distances_[j * point_count_ + source] = level;
+					--remaining;
+				}
+			}
+		}
+		frontier_.swap(next_frontier_);
+	}
+}
+
+int c_item_route_planner::tour_length(const std::vector<int>& order) const {
+	int length = 0;
+	for (std::size_t i = 1; i < order.size(); ++i) {
+		const int d = distance(order[i - 1], order[i]);
+		if (d < 0) return -1;
+		length += d;
+	}
+	return length;
+}
+
+int c_item_route_planner::solve_exact(std::size_t item_count, std::vector<int>& order) const {
+	// Points are laid out as start, items..., exit. best[mask * n + i] is the shortest walk from the
+	// start that collects the items in mask and ends on item i.
+	const int n = static_cast<int>(item_count);
+	const int exit = n + 1;
+	order.clear();
+	if (n == 0) {
+		order = { 0, exit };
+		return tour_length(order);
+	}
+	const std::size_t masks = std::size_t(1) << n;
+	std::vector<int> best(masks * n, UNREACHABLE);
+	std::vector<std::int8_t> previous(masks * n, -1);
+	for (int i = 0; i < n; ++i) {
+		const int d = distance(0, i + 1);
+		if (d >= 0) best[(std::size_t(1) << i) * n + i] = d;
+	}
+	for (std::size_t mask = 1; mask < masks; ++mask) {
+		for (int i = 0; i < n; ++i) {
+			const int here = best[mask * n + i];
+			if (here == UNREACHABLE) continue;
+			for (int j = 0; j < n; ++j) {
+				if (mask & (std::size_t(1) << j)) continue;
+				const int d = distance(i + 1, j + 1);
+				if (d < 0) continue;
+				const std::size_t next = (mask | (std::size_t(1) << j)) * n + j;
+				if (here + d < best[next]) {
+					best[next] = here + d;
+					previous[next] = static_cast<std::int8_t>(i);
+				}
+			}
+		}
+	}
+
+	// Close the tour at the exit, then walk the choices back.
+	const std::size_t full = masks - 1;
+	int length = UNREACHABLE;
+	int last = -1;
+	for (int i = 0; i < n; ++i) {
+		const int d = distance(i + 1, exit);
+		if (best[full * n + i] == UNREACHABLE || d < 0) continue;
+		if (best[full * n + i] + d < length) {
+			length = best[full * n + i] + d;
+			last = i;
+		}
+	}
+	if (last < 0) return -1;
+	order.push_back(exit);
+	for (std::size_t mask = full; last >= 0;) {
+		order.push_back(last + 1);
+		const int before = previous[mask * n + last];
+		mask &= ~(std::size_t(1) << last);
+		last = before;
+	}
+	order.push_back(0);
+	std::reverse(order.begin(), order.end());
+	return length;
+}
+
+int c_item_route_planner::solve_heuristic(std::size_t item_count, std::vector<int>& order) const {
+	const int n = static_cast<int>(item_count);
+	const int exit = n + 1;
+
+	// Nearest neighbour from the start.
+	order.assign(1, 0);
+	std::vector<bool> taken(n + 2, false);
+	for (int step = 0; step < n; ++step) {
+		int nearest = -1;
+		for (int j = 1; j <= n; ++j) {
+			const int d = distance(order.back(), j);
+			if (!taken[j] && d >= 0 && (nearest < 0 || d < distance(order.back(), nearest))) nearest = j;
+		}
+		if (nearest < 0) return -1;
+		taken[nearest] = true;
+		order.push_back(nearest);
+	}
+	order.push_back(exit);
+	if (tour_length(order) < 0) return -1;
+
+	// 2-opt: reverse any run of items that shortens the tour, the start and exit stay put.
+	for (bool improved = true; improved;) {
+		improved = false;
+		for (int i = 1; i < n; ++i) {
+			for (int j = i + 1; j <= n; ++j) {
+				const int before = distance(order[i - 1], order[i]) + distance(order[j], order[j + 1]);
+				const int after = distance(order[i - 1], order[j]) + distance(order[i], order[j + 1]);
+				if (after < before) {
+					std::reverse(order.begin() + i, order.begin() + j + 1);
+					improved = true;
+				}
+			}
+		}
+	}
+	return tour_length(order);
+}
+
+ItemRoute c_item_route_planner::plan() {
+	int start = -1;
+	int exit = -1;
+	std::vector<std::pair<char, int>> items; // (letter, cell), sorted by letter below.
+	for (const auto& [cell, ch] : graph_.special_cells()) {
+		if (ch == 's') start = cell;
+		else if (ch == 'x') exit = cell;
+		else items.emplace_back(ch, cell);
+	}
+	if (start < 0 || exit < 0) {
+		throw std::runtime_error("Map has no start or exit");
+	}
+	std::sort(items.begin(), items.end());
+
+	const int cols = graph_.cols();
+	std::vector<Node> item_nodes;
+	for (const auto& item : items) {
+		item_nodes.push_back(graph_.get_node(item.second / cols, item.second % cols));
+	}
+	return plan(graph_.get_node(start / cols, start % cols), graph_.get_node(exit / cols, exit % cols), item_nodes);
+}
+
+ItemRoute c_item_route_planner::plan(const Node& start, const Node& exit, const std::vector<Node>& items) {
+	std::vector<int> points;
+	points.push_back(graph_.cell_index(start.x, start.y));
+	for (const Node& item : items) {
+		points.push_back(graph_.cell_index(item.x, item.y));
+	}
+	points.push_back(graph_.cell_index(exit.x, exit.y));
+	build_distances(points);
+
+	ItemRoute route;
+	std::vector<int> order;
+	route.optimal = items.size() <= max_exact_items_;
+	route.length = route.optimal ? solve_exact(items.size(), order) : solve_heuristic(items.size(), order);
+	if (route.length < 0) {
+		route.length = 0;
+		return route;
+	}
+	route.found = true;
+	for (std::size_t i = 1; i + 1 < order.size(); ++i) {
+		route.order.push_back(order[i] - 1);
+		route.stops.emplace_back(items[order[i] - 1].x, items[order[i] - 1].y);
+	}
+
+	// Stitch the legs together with A*, dropping the first cell of each leg after the first.
+	const int cols = graph_.cols();
+	for (std::size_t i = 1; i < order.size(); ++i) {
+		const Node from = graph_.get_node(points[order[i - 1]] / cols, points[order[i - 1]] % cols);
+		const Node to = graph_.get_node(points[order[i]] / cols, points[order[i]] % cols);
+		const std::size_t leg = route.path.size();
+		graph_.a_star(from, to, state_, route.path);
+		if (i > 1) route.path.erase(route.path.begin() + leg);
+	}
+	return route;
+}
@@ -0,0 +1,98 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_item_route.h
+// Description : Shortest route from the start through every item to the exit.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "c_graph.h"
+#include "c_search_state.h"
+
+struct ItemRoute { // A planned tour, start -> items -> exit.
+	bool found = false;                      // False if an item or the exit cannot be reached.
+	bool optimal = false;                    // True if the order came from the exact solver.
+	int length = 0;                          // Number of steps along the path.
+	std::vector<int> order;                  // Indices into the items passed to plan, in visiting order.
+	std::vector<std::pair<int, int>> stops;  // Item cells in visiting order.
+	std::vector<std::pair<int, int>> path;   // Every cell from the start to the exit, for c_dungeon_map::mark_path.
+};
+
+/**
+ * @brief Plans the shortest 4-way tour that starts at the start, collects every item and ends at the exit.
+ * @note  Pairwise distances come from one breadth-first search per point that stops as soon as it has
+ *        reached every other point. The visiting order is solved exactly with the Held-Karp bitmask DP
+ *        up to max_exact_items items, and with nearest neighbour plus 2-opt above that.
+ */
+class c_item_route_planner {
+public:
+	/**
+	 * @brief Create a planner for the specified graph.
+	 * @param graph           - The graph to plan on, must outlive the planner.
+	 * @param max_exact_items - Largest item count solved exactly, Held-Karp is O(2^n * n^2).
+	 */
+	explicit c_item_route_planner(const c_graph& graph, std::size_t max_exact_items = 16);
+
+	/**
+	 * @brief Plan a route over the start, exit and items 'a' - 'j' recorded in the graph.
+	 * @return The route, with order indexing the item cells sorted by letter.
+	 */
+	ItemRoute plan();
+	/**
+	 * @brief Plan a route from start through every item to exit.
+	 */
+	ItemRoute plan(const Node& start, const Node& exit, const std::vector<Node>& items);
+
+	/**
+	 * @brief Fill the distance matrix between the points, one breadth-first search per point.
+	 * @param points - Cell indices of the points of interest.
+	 * @note  Exposed so the matrix phase can be benchmarked on its own, plan calls it.
+	 */
+	void build_distances(const std::vector<int>& points);
+	/**
+	 * @brief Get the number of steps between two points of the last build_distances, -1 if unreachable.
+	 */
+	int distance(std::size_t from, std::size_t to) const { return distances_[from * point_count_ + to]; }
+
+private:
+	const c_graph& graph_;
+	std::size_t max_exact_items_;
+
+	// Distance matrix phase, reused between plans.
+	std::size_t point_count_ = 0;
+	std::vector<int> distances_;              // point_count_ * point_count_, row per source point.
+	// The searches run on a copy of the grid with a ring of walls around it, indexed (x + 1) * padded_cols_ + y + 1,
+	// so a neighbour is one add away and never needs a bounds check.
+	int padded_cols_ = 0;
+	std::vector<std::uint64_t> open_;         // Bit per padded cell, set on floor.
+	std::vector<std::uint64_t> unvisited_;    // open_ with the cells reached by the current search cleared.
+	std::vector<std::uint64_t> target_bits_;  // Bit per padded cell, set on the points of interest.
+	std::vector<int> padded_points_;          // Padded cell of each point.
+	std::vector<int> sorted_points_;          // Padded cells sorted, for mapping a reached cell back to its point.
+	std::vector<int> sorted_point_ids_;       // Point id of each entry in sorted_points_.
+	std::vector<int> frontier_, next_frontier_;
+	c_search_state state_;                    // A* state for stitching the legs together.
+
+	/**
+	 * @brief Breadth-first search from one point, stopping once every other point has been reached.
+	 */
+	void search_from(std::size_t source);
+	/**
+	 * @brief Exact visiting order, order[0] is the start and order.back() the exit.
+	 * @return The tour length, or -1 if some point cannot be reached.
+	 */
+	int solve_exact(std::size_t item_count, std::vector<int>& order) const;
+	/**
+	 * @brief Nearest neighbour order improved with 2-opt, for item counts too large to solve exactly.
+	 */
+	int solve_heuristic(std::size_t item_count, std::vector<int>& order) const;
+	int tour_length(const std::vector<int>& order) const;
+};
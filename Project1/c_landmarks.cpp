@@ -0,0 +1,191 @@
+#include "c_landmarks.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+	constexpr char LANDMARK_MAGIC[4] = { 'D', 'A', 'L', 'T' };
+	constexpr std::uint32_t NOT_REACHED = std::numeric_limits<std::uint32_t>::max();
+}
+
+c_landmarks::c_landmarks(const c_graph& graph, int landmark_count)
+	: rows_(graph.rows()), cols_(graph.cols()), graph_version_(graph.version()), walkable_hash_(walkable_hash(graph)) {
+	if (landmark_count < 1 || landmark_count > 64) {
+		throw std::invalid_argument("Landmark count must be between 1 and 64");
+	}
+	const int cell_count = rows_ * cols_;
+	std::vector<std::uint32_t> distance(cell_count);
+	std::vector<int> queue(cell_count);
+
+	// Distance from each cell to its nearest landmark so far. Cells no landmark reaches count as
+	// farthest, so every disconnected region gets a landmark before any region gets a second.
+	std::vector<std::uint32_t> nearest(cell_count, NOT_REACHED);
+	int seed = -1;
+	for (int index = 0; index < cell_count && seed < 0; ++index) {
+		if (graph.is_walkable(index)) seed = index;
+	}
+	if (seed < 0) return; // No floor, nothing to guide.
+
+	// The first landmark is the cell farthest from an arbitrary floor cell, which is not a landmark itself.
+	breadth_first(graph, seed, distance, queue);
+	std::copy(distance.begin(), distance.end(), nearest.begin());
+	distances_.assign(static_cast<std::size_t>(cell_count) * landmark_count, UNREACHABLE);
+	landmark_count_ = landmark_count;
+	for (int k = 0; k < landmark_count; ++k) {
+		int farthest = -1;
+		for (int index = 0; index < cell_count; ++index) {
+			if (!graph.is_walkable(index)) continue;
+			if (farthest < 0 || nearest[index] > nearest[farthest]) farthest = index;
+		}
+		if (k > 0 && nearest[farthest] == 0) { // Every floor cell is a landmark already.
+			landmark_count_ = k;
+			break;
+		}
+		landmarks_.push_back(farthest);
+		breadth_first(graph, farthest, distance, queue);
+		for (int index = 0; index < cell_count; ++index) {
+			const std::uint32_t steps = distance[index];
+			if (steps == NOT_REACHED) continue;
+			distances_[static_cast<std::size_t>(index) * landmark_count + k] = static_cast<std::uint16_t>(std::min<std::uint32_t>(steps, MAX_DISTANCE));
+			if (k == 0 || steps < nearest[index]) nearest[index] = steps;
+		}
+	}
+
+	// Fewer floor cells than landmarks, drop the unused columns.
+	if (landmark_count_ < landmark_count) {
+		std::vector<std::uint16_t> packed(static_cast<std::size_t>(cell_count) * landmark_count_);
+		for (int index = 0; index < cell_count; ++index) {
+			std::copy_n(distances_.begin() + static_cast<std::size_t>(index) * landmark_count, landmark_count_,
+				packed.begin() + static_cast<std::size_t>(index) * landmark_count_);
+		}
+		distances_.swap(packed);
+	}
+}
+
+void c_landmarks::breadth_first(const c_graph& graph, int source, std::vector<std::uint32_t>& distance, std::vector<int>& queue) {
+	const int rows = graph.rows();
+	const int cols = graph.cols();
+	std::fill(distance.begin(), distance.end(), NOT_REACHED);
+	distance[source] = 0;
+	queue[0] = source;
+	std::size_t head = 0;
+	std::size_t tail = 1;
+	while (head < tail) {
+		const int current = queue[head++];
+		const std::uint32_t next = distance[current] + 1;
+		const int x = current / cols;
+		const int y = current % cols;
+		auto reach = [&](int neighbor) {
+			if (distance[neighbor] != NOT_REACHED || !graph.is_walkable(neighbor)) return;
+			distance[neighbor] = next;
+			queue[tail++] = neighbor;
+		};
+		if (x > 0) reach(current - cols);
+		if (x + 1 < rows) reach(current + cols);
+		if (y > 0) reach(current - 1);
+		if (y + 1 < cols) reach(current + 1);
+	}
+}
+
+bool c_landmarks::disconnected(int a, int b) const {
+	const std::uint16_t* from = distances(a);
+	const std::uint16_t* to = distances(b);
+	for (int k = 0; k < landmark_count_; ++k) {
+		if ((from[k] == UNREACHABLE) != (to[k] == UNREACHABLE)) return true;
+	}
+	return false;
+}
+
+std::uint64_t c_landmarks::walkable_hash(const c_graph& graph) {
+	// FNV-1a over the dimensions and the walkability, 64 cells at a time.
+	std::uint64_t hash = 14695981039346656037ull;
+	auto mix = [&hash](std::uint64_t value) {
+		hash ^= value;
+		hash *= 1099511628211ull;
+	};
+	mix(static_cast<std::uint64_t>(graph.rows()));
+	mix(static_cast<std::uint64_t>(graph.cols()));
+	const int cell_count = graph.rows() * graph.cols();
+	std::uint64_t word = 0;
+	for (int index = 0; index < cell_count; ++index) {
+		if (graph.is_walkable(index)) word |= std::uint64_t(1) << (index & 63);
+		if ((index & 63) == 63 || index + 1 == cell_count) {
+			mix(word);
+			word = 0;
+		}
+	}
+	return hash;
+}
+
+void c_landmarks::save(const std::string& filename) const {
+	landmark_file_header head{};
+	std::memcpy(head.magic, LANDMARK_MAGIC, sizeof(LANDMARK_MAGIC));
+	head.version = LANDMARK_FILE_VERSION;
+	head.landmark_count = static_cast<std::uint16_t>(landmark_count_);
+	head.rows = rows_;
+	head.cols = cols_;
+	head.walkable_hash = walkable_hash_;
+
+	std::ofstream file(filename, std::ios::binary);
+	if (!file.is_open()) {
+		throw std::runtime_error("Unable to open file for writing");
+	}
+	std::vector<std::int32_t> cells(landmarks_.begin(), landmarks_.end());
+	file.write(reinterpret_cast<const char*>(&head), sizeof(head));
+	file.write(reinterpret_cast<const char*>(cells.data()), static_cast<std::streamsize>(cells.size() * sizeof(std::int32_t)));
+	file.write(reinterpret_cast<const char*>(distances_.data()), static_cast<std::streamsize>(distances_.size() * sizeof(std::uint16_t)));
+	if (!file) {
+		throw std::runtime_error("Failed writing landmark file");
+	}
+}
+
+c_landmarks c_landmarks::load(const std::string& filename, const c_graph& graph) {
+	std::ifstream file(filename, std::ios::binary);
+	if (!file.is_open()) {
+		throw std::runtime_error("Unable to open landmark file");
+	}
+	landmark_file_header head{};
+	if (!file.read(reinterpret_cast<char*>(&head), sizeof(head))) {
+		throw std::runtime_error("Landmark file is too small");
+	}
+	if (std::memcmp(head.magic, LANDMARK_MAGIC, sizeof(LANDMARK_MAGIC)) != 0) {
+		throw std::runtime_error("Not a landmark file");
+	}
+	if (head.version != LANDMARK_FILE_VERSION) {
+		throw std::runtime_error("Unsupported landmark file version");
+	}
+	if (head.rows != graph.rows() || head.cols != graph.cols() || head.walkable_hash != walkable_hash(graph)) {
+		throw std::runtime_error("Landmark file was built for a different map");
+	}
+
+	c_landmarks landmarks;
+	landmarks.rows_ = head.rows;
+	landmarks.cols_ = head.cols;
+	landmarks.landmark_count_ = head.landmark_count;
+	landmarks.graph_version_ = graph.version();
+	landmarks.walkable_hash_ = head.walkable_hash;
+	std::vector<std::int32_t> cells(head.landmark_count);
+	landmarks.distances_.resize(static_cast<std::size_t>(head.rows) * head.cols * head.landmark_count);
+	file.read(reinterpret_cast<char*>(cells.data()), static_cast<std::streamsize>(cells.size() * sizeof(std::int32_t)));
+	file.read(reinterpret_cast<char*>(landmarks.distances_.data()), static_cast<std::streamsize>(landmarks.distances_.size() * sizeof(std::uint16_t)));
+	if (!file) {
+		throw std::runtime_error("Landmark file is truncated");
+	}
+	landmarks.landmarks_.assign(cells.begin(), cells.end());
+	return landmarks;
+}
+
+c_landmarks c_landmarks::load_or_build(const std::string& map_filename, const c_graph& graph, int landmark_count) {
+	const std::string filename = file_for_map(map_filename);
+	try {
+		return load(filename, graph);
+	}
+	catch (const std::runtime_error&) {
+		// Missing, unreadable or built for an older version of the map, preprocess it again.
+	}
+	c_landmarks landmarks(graph, landmark_count);
+	landmarks.save(filename);
+	return landmarks;
+}
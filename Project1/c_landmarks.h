@@ -0,0 +1,125 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_landmarks.h
+// Description : Landmark distance tables (ALT) giving a_star a tighter lower bound than Manhattan distance.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "c_graph.h"
+
+constexpr std::uint16_t LANDMARK_FILE_VERSION = 1; // Bump when the layout below changes.
+
+/**
+ * @brief Fixed-size header at the start of a landmark file, followed by the landmark cells and the distances.
+ * @note  Stored little-endian. The walkability hash ties the file to the map it was built from.
+ */
+struct landmark_file_header {
+	char magic[4];                // "DALT".
+	std::uint16_t version;        // LANDMARK_FILE_VERSION.
+	std::uint16_t landmark_count; // Number of landmarks.
+	std::int32_t rows, cols;      // Graph dimensions.
+	std::uint64_t walkable_hash;  // c_landmarks::walkable_hash of the graph.
+};
+
+/**
+ * @brief Exact 4-way step counts from a few landmark cells to every cell of a graph.
+ * @note  By the triangle inequality |d(L, goal) - d(L, cell)| never overestimates the distance from
+ *        cell to goal, and the largest over all landmarks is a consistent heuristic. On mazes it is far
+ *        tighter than the Manhattan distance, so a_star expands a fraction of the cells.
+ *        Distances are 16 bits, landmark-interleaved per cell so one lookup touches one cache line.
+ *        Distances past 65534 saturate, which keeps the bound admissible but loosens it.
+ */
+class c_landmarks {
+public:
+	static constexpr std::uint16_t UNREACHABLE = 0xFFFF;  // The cell and the landmark are not connected.
+	static constexpr std::uint16_t MAX_DISTANCE = 0xFFFE; // Longer distances are stored as this.
+
+	c_landmarks() = default;
+	/**
+	 * @brief Pick landmarks and compute their distance tables.
+	 * @param graph          - The graph to preprocess.
+	 * @param landmark_count - Number of landmarks, more give a tighter bound at 2 bytes per cell each.
+	 * @note  Landmarks are chosen farthest-first: each is the floor cell farthest from the ones already
+	 *        picked, so they end up around the edges of the map, with one per disconnected region.
+	 */
+	explicit c_landmarks(const c_graph& graph, int landmark_count = 8);
+
+	/**
+	 * @brief Load tables saved by save, throws if the file is not for this graph.
+	 * @param filename - The landmark file.
+	 * @param graph    - The graph the tables will be used with, its walkability must match the file.
+	 */
+	static c_landmarks load(const std::string& filename, const c_graph& graph);
+	/**
+	 * @brief Load the tables saved next to a map, or build and save them if there are none yet or they are stale.
+	 * @param map_filename   - The map the graph was loaded from, the tables go in file_for_map(map_filename).
+	 * @param graph          - The graph loaded from that map.
+	 * @param landmark_count - Number of landmarks to build with, a saved file keeps its own count.
+	 */
+	static c_landmarks load_or_build(const std::string& map_filename, const c_graph& graph, int landmark_count = 8);
+	/**
+	 * @brief Get the landmark file that goes with a map file.
+	 */
+	static std::string file_for_map(const std::string& map_filename) { return map_filename + ".alt"; }
+	/**
+	 * @brief Write the tables in the landmark file format.
+	 */
+	void save(const std::string& filename) const;
+
+	/**
+	 * @brief Hash of a graph's dimensions and walkability, identifies the map a saved file belongs to.
+	 */
+	static std::uint64_t walkable_hash(const c_graph& graph);
+
+	/**
+	 * @brief Lower bound on the 4-way steps from a cell to a goal.
+	 * @param index - Flat cell index, see c_graph::cell_index.
+	 * @param goal  - The goal's distances, see distances.
+	 */
+	int lower_bound(int index, const std::uint16_t* goal) const {
+		const std::uint16_t* here = distances_.data() + static_cast<std::size_t>(index) * landmark_count_;
+		int bound = 0;
+		for (int k = 0; k < landmark_count_; ++k) {
+			if (here[k] == UNREACHABLE || goal[k] == UNREACHABLE) continue;
+			const int difference = here[k] > goal[k] ? here[k] - goal[k] : goal[k] - here[k];
+			if (difference > bound) bound = difference;
+		}
+		return bound;
+	}
+	/**
+	 * @brief Get a cell's distance to every landmark, landmark_count() values.
+	 */
+	const std::uint16_t* distances(int index) const { return distances_.data() + static_cast<std::size_t>(index) * landmark_count_; }
+	/**
+	 * @brief Check whether the landmarks prove two cells are not connected: one reaches a landmark the other cannot.
+	 */
+	bool disconnected(int a, int b) const;
+
+	int landmark_count() const { return landmark_count_; }
+	const std::vector<int>& landmarks() const { return landmarks_; } // Landmark cell indices.
+	std::uint64_t graph_version() const { return graph_version_; }  // c_graph::version() the tables match.
+	std::size_t memory_usage() const { return distances_.capacity() * sizeof(std::uint16_t); }
+
+private:
+	int rows_ = 0;
+	int cols_ = 0;
+	int landmark_count_ = 0;
+	std::uint64_t graph_version_ = 0;
+	std::uint64_t walkable_hash_ = 0;      // walkable_hash of the graph the tables were built from.
+	std::vector<int> landmarks_;           // Cell index of each landmark.
+	std::vector<std::uint16_t> distances_; // distances_[cell * landmark_count_ + k] is the steps from landmark k.
+
+	/**
+	 * @brief Fill distance with the 4-way steps from source to every cell, UINT32_MAX where unreachable.
+	 */
+	static void breadth_first(const c_graph& graph, int source, std::vector<std::uint32_t>& distance, std::vector<int>& queue);
+};
@@ -0,0 +1,137 @@
+#include "c_load_generator.h"
+#include "c_binary_map.h"
+#include "c_dungeon_map.h"
+#include "c_local_socket.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+	// Path requests between random walkable cells, the connections pick from them.
+	std::vector<std::string> make_requests(const LoadTestOptions& options) {
+		std::mt19937 rng(options.seed);
+		std::vector<std::string> requests;
+		for (const auto& [name, filename] : options.maps) {
+			c_dungeon_map dungeon;
+			if (is_binary_map_file(filename)) dungeon.load_binary_map(filename);
+			else dungeon.load_map(filename);
+			const c_graph graph = dungeon.to_graph();
+			std::uniform_int_distribution<int> row(0, graph.rows() - 1), col(0, graph.cols() - 1);
+			auto walkable_cell = [&] {
+				while (true) {
+					const int x = row(rng), y = col(rng);
+					if (graph.is_walkable(graph.cell_index(x, y))) return std::to_string(x) + ' ' + std::to_string(y);
+				}
+			};
+			for (int i = 0; i < 256; ++i) {
+				requests.push_back("path " + name + ' ' + walkable_cell() + ' ' + walkable_cell());
+			}
+		}
+		if (requests.empty()) throw std::invalid_argument("No maps to query");
+		return requests;
+	}
+
+	double percentile(const std::vector<double>& sorted, double fraction) { // Nearest rank.
+		if (sorted.empty()) return 0.0;
+		const std::size_t rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+		return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+	}
+}
+
+LoadTestReport run_load_test(const LoadTestOptions& options) {
+	const std::vector<std::string> requests = make_requests(options);
+	std::vector<std::vector<double>> latencies(options.connections);
+	std::vector<std::size_t> errors(options.connections, 0);
+	std::vector<std::uint64_t> versions(options.connections, 0);
+	std::vector<std::exception_ptr> failures(options.connections);
+
+	// Connect everything before the clock starts.
+	std::vector<c_local_socket> sockets;
+	for (unsigned i = 0; i < options.connections; ++i) sockets.push_back(c_local_socket::connect(options.socket_path));
+	c_local_socket reload_socket;
+	if (options.reload_ms > 0) reload_socket = c_local_socket::connect(options.socket_path);
+
+	std::atomic<bool> querying{ true };
+	std::size_t reloads = 0;
+	const auto begin = std::chrono::steady_clock::now();
+	std::thread reloader([&] {
+		if (options.reload_ms == 0) return;
+		std::string answer;
+		try {
+			for (std::size_t next = 0; querying; ++next) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(options.reload_ms));
+				const auto& [name, filename] = options.maps[next % options.maps.size()];
+				reload_socket.write_line("load " + name + ' ' + filename);
+				if (reload_socket.read_line(answer) && answer.rfind("loaded ", 0) == 0) ++reloads;
+			}
+		}
+		catch (const std::exception&) {
+			// The server went away, the query connections report it.
+		}
+	});
+
+	std::vector<std::thread> workers;
+	for (unsigned connection = 0; connection < options.connections; ++connection) {
+		workers.emplace_back([&, connection] {
+			std::mt19937 rng(options.seed + connection + 1);
+			std::uniform_int_distribution<std::size_t> pick(0, requests.size() - 1);
+			std::vector<double>& times = latencies[connection];
+			times.reserve(options.queries);
+			std::string answer;
+			try {
+				for (std::size_t i = 0; i < options.queries; ++i) {
+					const auto sent = std::chrono::steady_clock::now();
+					sockets[connection].write_line(requests[pick(rng)]);
+					if (!sockets[connection].read_line(answer)) throw std::runtime_error("Server closed the connection");
+					times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent).count());
+					if (answer.rfind("error", 0) == 0) {
+						++errors[connection];
+					} else {
+						// "ok <version> ..." or "none <version>".
+						versions[connection] = std::max<std::uint64_t>(versions[connection], std::stoull(answer.substr(answer.find(' ') + 1)));
+					}
+				}
+			}
+			catch (...) {
+				failures[connection] = std::current_exception();
+			}
+		});
+	}
+	for (std::thread& worker : workers) worker.join();
+	querying = false;
+	reloader.join();
+	for (const std::exception_ptr& failure : failures) {
+		if (failure) std::rethrow_exception(failure);
+	}
+
+	LoadTestReport report;
+	report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	std::vector<double> all;
+	for (unsigned i = 0; i < options.connections; ++i) {
+		all.insert(all.end(), latencies[i].begin(), latencies[i].end());
+		report.errors += errors[i];
+		report.max_version = std::max(report.max_version, versions[i]);
+	}
+	std::sort(all.begin(), all.end());
+	report.queries = all.size();
+	report.reloads = reloads;
+	report.p50_us = percentile(all, 0.50);
+	report.p99_us = percentile(all, 0.99);
+	report.p999_us = percentile(all, 0.999);
+	report.max_us = all.empty() ? 0.0 : all.back();
+	return report;
+}
+
+std::string to_string(const LoadTestReport& report) {
+	std::ostringstream out;
+	out << report.queries << " queries in " << report.seconds << "s (" << report.queries / std::max(report.seconds, 1e-9) << "/s)"
+		<< " p50=" << report.p50_us << "us p99=" << report.p99_us << "us p999=" << report.p999_us << "us max=" << report.max_us << "us"
+		<< " errors=" << report.errors << " reloads=" << report.reloads << " max_version=" << report.max_version;
+	return out.str();
+}
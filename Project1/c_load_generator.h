@@ -0,0 +1,51 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_load_generator.h
+// Description : Load-generating client for the path server, reporting query latency percentiles.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct LoadTestOptions {
+	std::string socket_path;                                // Where the server listens, see c_path_server::serve.
+	std::vector<std::pair<std::string, std::string>> maps;  // (name, file) of each map to query, as the server has them.
+	unsigned connections = 4;                               // Connections sending queries at once, one thread each.
+	std::size_t queries = 1000;                             // Queries per connection.
+	unsigned reload_ms = 0;                                 // Reload one of the maps this often, round robin. 0 never reloads.
+	std::uint32_t seed = 1;                                 // Seed for the random start/goal cells.
+};
+
+struct LoadTestReport {
+	std::size_t queries = 0;       // Answers received.
+	std::size_t errors = 0;        // Answers that were error lines.
+	std::size_t reloads = 0;       // Reloads the server acknowledged during the run.
+	std::uint64_t max_version = 0; // Highest map version any answer came from, above 1 if reloads were seen.
+	double seconds = 0.0;          // Wall time of the run.
+	double p50_us = 0.0;           // Latency percentiles in microseconds, request sent to answer read.
+	double p99_us = 0.0;
+	double p999_us = 0.0;
+	double max_us = 0.0;
+};
+
+/**
+ * @brief Fire path queries at a running server from several connections and measure each one's latency.
+ * @note  The map files are read here too, only to pick random walkable start and goal cells.
+ *        With reload_ms set, one more connection reloads the maps while the queries run.
+ *        Throws if the server can't be reached.
+ */
+LoadTestReport run_load_test(const LoadTestOptions& options);
+
+/**
+ * @brief Format a report as one human readable line.
+ */
+std::string to_string(const LoadTestReport& report);
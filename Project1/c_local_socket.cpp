@@ -0,0 +1,130 @@
+#include "c_local_socket.h"
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+
+c_local_socket::~c_local_socket() = default;
+c_local_socket::c_local_socket(c_local_socket&& other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+c_local_socket& c_local_socket::operator=(c_local_socket&& other) noexcept {
+	fd_ = std::exchange(other.fd_, -1);
+	return *this;
+}
+
+namespace {
+	[[noreturn]] void unsupported() {
+		throw std::runtime_error("Local sockets are not supported on this platform, serve over stdin instead");
+	}
+}
+
+c_local_socket c_local_socket::listen(const std::string&) { unsupported(); }
+c_local_socket c_local_socket::connect(const std::string&) { unsupported(); }
+c_local_socket c_local_socket::accept() { unsupported(); }
+bool c_local_socket::read_line(std::string&) { unsupported(); }
+void c_local_socket::write_line(const std::string&) { unsupported(); }
+void c_local_socket::shutdown() {}
+
+#else
+
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+	sockaddr_un socket_address(const std::string& path) {
+		sockaddr_un address{};
+		address.sun_family = AF_UNIX;
+		if (path.size() >= sizeof(address.sun_path)) {
+			throw std::invalid_argument("Socket path is too long: " + path);
+		}
+		std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+		return address;
+	}
+
+	[[noreturn]] void throw_errno(const std::string& what) {
+		throw std::runtime_error(what + ": " + std::strerror(errno));
+	}
+}
+
+c_local_socket::~c_local_socket() {
+	if (fd_ >= 0) ::close(fd_);
+}
+
+c_local_socket::c_local_socket(c_local_socket&& other) noexcept
+	: fd_(std::exchange(other.fd_, -1)), buffer_(std::move(other.buffer_)), buffered_(other.buffered_) {
+}
+
+c_local_socket& c_local_socket::operator=(c_local_socket&& other) noexcept {
+	if (this != &other) {
+		if (fd_ >= 0) ::close(fd_);
+		fd_ = std::exchange(other.fd_, -1);
+		buffer_ = std::move(other.buffer_);
+		buffered_ = other.buffered_;
+	}
+	return *this;
+}
+
+c_local_socket c_local_socket::listen(const std::string& path) {
+	const sockaddr_un address = socket_address(path);
+	c_local_socket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+	if (!socket.is_open()) throw_errno("Could not create socket");
+	::unlink(path.c_str()); // A socket file left behind by an earlier server would make bind fail.
+	if (::bind(socket.fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) throw_errno("Could not bind " + path);
+	if (::listen(socket.fd_, 64) != 0) throw_errno("Could not listen on " + path);
+	return socket;
+}
+
+c_local_socket c_local_socket::connect(const std::string& path) {
+	const sockaddr_un address = socket_address(path);
+	c_local_socket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+	if (!socket.is_open()) throw_errno("Could not create socket");
+	if (::connect(socket.fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) throw_errno("Could not connect to " + path);
+	return socket;
+}
+
+c_local_socket c_local_socket::accept() {
+	while (true) {
+		const int fd = ::accept(fd_, nullptr, nullptr);
+		if (fd >= 0) return c_local_socket(fd);
+		if (errno != EINTR) return c_local_socket(); // Shut down, or the socket is broken either way.
+	}
+}
+
+bool c_local_socket::read_line(std::string& line) {
+	while (true) {
+		const std::size_t newline = buffer_.find('\n', buffered_);
+		if (newline != std::string::npos) {
+			line.assign(buffer_, buffered_, newline - buffered_);
+			buffered_ = newline + 1;
+			return true;
+		}
+		// Drop the lines already returned, then read more.
+		buffer_.erase(0, buffered_);
+		buffered_ = 0;
+		char chunk[4096];
+		const ssize_t count = ::read(fd_, chunk, sizeof(chunk));
+		if (count < 0 && errno == EINTR) continue;
+		if (count <= 0) return false;
+		buffer_.append(chunk, static_cast<std::size_t>(count));
+	}
+}
+
+void c_local_socket::write_line(const std::string& line) {
+	std::string data = line;
+	data += '\n';
+	std::size_t written = 0;
+	while (written < data.size()) {
+		const ssize_t count = ::send(fd_, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+		if (count < 0 && errno == EINTR) continue;
+		if (count <= 0) throw_errno("Could not write to socket");
+		written += static_cast<std::size_t>(count);
+	}
+}
+
+void c_local_socket::shutdown() {
+	if (fd_ >= 0) ::shutdown(fd_, SHUT_RD);
+}
+
+#endif
@@ -0,0 +1,65 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_local_socket.h
+// Description : A line-oriented Unix domain socket, used by the path server and its load generator.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief A connected or listening local socket, closed on destruction. Move-only.
+ * @note  Unix domain sockets only: on platforms without them every call throws std::runtime_error,
+ *        and the server can only be used over stdin (see c_path_server).
+ */
+class c_local_socket {
+public:
+	c_local_socket() = default;
+	~c_local_socket();
+	c_local_socket(c_local_socket&& other) noexcept;
+	c_local_socket& operator=(c_local_socket&& other) noexcept;
+	c_local_socket(const c_local_socket&) = delete;
+	c_local_socket& operator=(const c_local_socket&) = delete;
+
+	/**
+	 * @brief Create a socket listening at the specified path, replacing any stale socket file there.
+	 */
+	static c_local_socket listen(const std::string& path);
+	/**
+	 * @brief Connect to a socket listening at the specified path.
+	 */
+	static c_local_socket connect(const std::string& path);
+
+	/**
+	 * @brief Wait for the next connection on a listening socket.
+	 * @return The connection, or a closed socket once shutdown() has been called.
+	 */
+	c_local_socket accept();
+	/**
+	 * @brief Read up to the next newline, which is not stored.
+	 * @return False once the other end has closed the connection.
+	 */
+	bool read_line(std::string& line);
+	/**
+	 * @brief Write a line, appending the newline.
+	 */
+	void write_line(const std::string& line);
+	/**
+	 * @brief Stop reading, waking any thread blocked in accept or read_line. Lines can still be written. Safe from any thread.
+	 */
+	void shutdown();
+	bool is_open() const { return fd_ >= 0; }
+
+private:
+	explicit c_local_socket(int fd) : fd_(fd) {}
+
+	int fd_ = -1;              // The socket's file descriptor, -1 if closed.
+	std::string buffer_;       // Bytes read past the last line returned.
+	std::size_t buffered_ = 0; // Start of the unread bytes in buffer_.
+};
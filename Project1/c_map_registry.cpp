@@ -0,0 +1,60 @@
+#include "c_map_registry.h"
+#include "c_binary_map.h"
+#include "c_dungeon_map.h"
+#include <algorithm>
+
+c_map_registry::c_map_registry() : table_(std::make_shared<const table>()) {
+}
+
+c_map_registry::map_ptr c_map_registry::load(const std::string& name, const std::string& filename) {
+	// Everything slow happens before the swap, without the write lock.
+	c_dungeon_map dungeon;
+	if (is_binary_map_file(filename)) {
+		dungeon.load_binary_map(filename);
+	} else {
+		dungeon.load_map(filename);
+	}
+	auto loaded = std::make_shared<LoadedMap>();
+	loaded->name = name;
+	loaded->filename = filename;
+	loaded->graph = dungeon.to_graph();
+	const auto [start_x, start_y] = dungeon.get_start_node();
+	const auto [exit_x, exit_y] = dungeon.get_end_node();
+	loaded->start = loaded->graph.get_node(start_x, start_y);
+	loaded->exit = loaded->graph.get_node(exit_x, exit_y);
+
+	std::lock_guard<std::mutex> lock(write_mutex_);
+	const std::shared_ptr<const table> current = table_.load();
+	auto next = std::make_shared<table>(*current);
+	const auto it = current->find(name);
+	loaded->version = it != current->end() ? it->second->version + 1 : 1;
+	map_ptr result = loaded;
+	(*next)[name] = result;
+	table_.store(std::move(next));
+	return result;
+}
+
+bool c_map_registry::unload(const std::string& name) {
+	std::lock_guard<std::mutex> lock(write_mutex_);
+	const std::shared_ptr<const table> current = table_.load();
+	if (current->find(name) == current->end()) return false;
+	auto next = std::make_shared<table>(*current);
+	next->erase(name);
+	table_.store(std::move(next));
+	return true;
+}
+
+c_map_registry::map_ptr c_map_registry::find(const std::string& name) const {
+	const std::shared_ptr<const table> current = table_.load();
+	const auto it = current->find(name);
+	return it != current->end() ? it->second : nullptr;
+}
+
+std::vector<std::string> c_map_registry::names() const {
+	const std::shared_ptr<const table> current = table_.load();
+	std::vector<std::string> result;
+	result.reserve(current->size());
+	for (const auto& entry : *current) result.push_back(entry.first);
+	std::sort(result.begin(), result.end());
+	return result;
+}
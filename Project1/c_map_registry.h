@@ -0,0 +1,75 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_map_registry.h
+// Description : Named, immutable, reference-counted map graphs that can be reloaded while queries run on them.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "c_graph.h"
+
+struct LoadedMap { // One version of a map. Never changed after loading, shared by every query that started on it.
+	std::string name;      // Name the map is registered under.
+	std::string filename;  // File it was loaded from.
+	std::uint64_t version; // 1 for the first load, one more for each reload under the same name.
+	c_graph graph;         // The map's graph, only its const members may be used.
+	Node start;            // The map's start cell.
+	Node exit;             // The map's exit cell.
+};
+
+/**
+ * @brief A registry of loaded maps whose readers never wait for a load or reload to finish.
+ * @note  The registry is one immutable table of names to maps behind an atomic shared pointer. Loading, reloading or
+ *        unloading copies the table, changes the copy and swaps it in (read-copy-update), so a lookup is one atomic
+ *        load of the table. std::atomic<std::shared_ptr> is not lock-free with every standard library (it is not
+ *        with libstdc++): the load and the writer's swap take a short internal lock, held only to copy or replace
+ *        the pointer. A query keeps the LoadedMap it looked up alive for as long as it holds it: a search that
+ *        started on the old version of a reloaded map finishes on it holding no locks, and the old version is freed
+ *        when its last query lets go.
+ */
+class c_map_registry {
+public:
+	using map_ptr = std::shared_ptr<const LoadedMap>;
+
+	c_map_registry();
+
+	/**
+	 * @brief Load a map from a file and register it, replacing any map already registered under the name.
+	 * @param name     - Name to register the map under.
+	 * @param filename - Text map, or binary map if it ends in .dmap.
+	 * @return The new version.
+	 * @note  The file is read and the graph built before the registry is touched, so queries carry on against the
+	 *        current version meanwhile. Throws if the file can't be loaded, the registered version is then kept.
+	 */
+	map_ptr load(const std::string& name, const std::string& filename);
+	/**
+	 * @brief Remove a map from the registry. Queries holding it keep it until they finish.
+	 * @return False if no map was registered under the name.
+	 */
+	bool unload(const std::string& name);
+	/**
+	 * @brief Get the current version of a map, or null if there is none. Safe to call from any thread.
+	 */
+	map_ptr find(const std::string& name) const;
+	/**
+	 * @brief Get the names of every registered map, sorted.
+	 */
+	std::vector<std::string> names() const;
+
+private:
+	using table = std::unordered_map<std::string, map_ptr>;
+
+	std::atomic<std::shared_ptr<const table>> table_; // The current table, replaced whole on every change.
+	std::mutex write_mutex_;                          // Serialises writers, readers never take it.
+};
@@ -0,0 +1,210 @@
+#include "c_map_scan.h"
+#include "c_thread_pool.h"
+#include <algorithm>
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MAP_SCAN_SSE2 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define MAP_SCAN_AVX2_TARGET // MSVC accepts AVX2 intrinsics in any function.
+#else
+#define MAP_SCAN_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+	struct block_masks { // One bit per cell of a 64-cell block.
+		std::uint64_t wall;    // 'w'.
+		std::uint64_t plain;   // '.', 'r', 'm' or '~': walkable and nothing to record.
+		std::uint64_t terrain; // 'r', 'm' or '~'.
+	};
+
+	block_masks scalar_block(const char* block, int length) {
+		block_masks masks{ 0, 0, 0 };
+		for (int i = 0; i < length; ++i) {
+			const char ch = block[i];
+			const std::uint64_t bit = std::uint64_t(1) << i;
+			if (ch == 'w') masks.wall |= bit;
+			else if (ch == '.') masks.plain |= bit;
+			else if (ch == 'r' || ch == 'm' || ch == '~') {
+				masks.plain |= bit;
+				masks.terrain |= bit;
+			}
+		}
+		return masks;
+	}
+
+	// Record the cells of a block the masks left unclassified: specials, or characters the format does not allow.
+	void record_others(const char* block, std::size_t base, std::uint64_t others, MapScan& scan) {
+		while (others != 0) {
+			const int bit = std::countr_zero(others);
+			others &= others - 1;
+			const char ch = block[bit];
+			if (ch == 's' || ch == 'x' || (ch >= 'a' && ch <= 'j')) {
+				scan.specials.emplace_back(static_cast<int>(base + bit), ch);
+			} else if (scan.invalid_count++ == 0) {
+				scan.first_invalid = base + bit;
+			}
+		}
+	}
+
+	void finish_block(const char* block, std::size_t base, int length, const block_masks& masks, std::uint64_t* words, MapScan& scan) {
+		const std::uint64_t used = length == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << length) - 1;
+		words[base >> 6] = ~masks.wall & used;
+		scan.has_terrain |= masks.terrain != 0;
+		const std::uint64_t others = ~(masks.wall | masks.plain) & used;
+		if (others != 0) record_others(block, base, others, scan);
+	}
+
+	void begin_scan(std::size_t count, MapScan& scan) {
+		scan.walkable.assign((count + 63) / 64, 0);
+		scan.specials.clear();
+		scan.invalid_count = 0;
+		scan.first_invalid = 0;
+		scan.has_terrain = false;
+	}
+
+	// Cells [begin, end) in whole 64-cell blocks through Block, the tail through scalar_block. begin is a multiple of 64,
+	// the bits go to words[begin / 64] onwards and everything else the scan learns is added to scan.
+	template <typename Block>
+	void scan_blocks(const char* cells, std::size_t begin, std::size_t end, std::uint64_t* words, MapScan& scan, Block&& block) {
+		std::size_t base = begin;
+		for (; base + 64 <= end; base += 64) {
+			finish_block(cells + base, base, 64, block(cells + base), words, scan);
+		}
+		if (base < end) {
+			const int length = static_cast<int>(end - base);
+			finish_block(cells + base, base, length, scalar_block(cells + base, length), words, scan);
+		}
+	}
+
+	using range_scanner = void (*)(const char* cells, std::size_t begin, std::size_t end, std::uint64_t* words, MapScan& scan);
+
+	void scan_range_scalar(const char* cells, std::size_t begin, std::size_t end, std::uint64_t* words, MapScan& scan) {
+		scan_blocks(cells, begin, end, words, scan, [](const char* block) { return scalar_block(block, 64); });
+	}
+
+#ifdef MAP_SCAN_SSE2
+	std::uint64_t sse2_mask(__m128i a, __m128i b, __m128i c, __m128i d) {
+		return static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(a))) |
+			static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(b))) << 16 |
+			static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(c))) << 32 |
+			static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(d))) << 48;
+	}
+
+	struct sse2_block { block_masks operator()(const char* block) const; };
+	block_masks sse2_block::operator()(const char* block) const {
+		const __m128i wall = _mm_set1_epi8('w'), dot = _mm_set1_epi8('.');
+		const __m128i road = _mm_set1_epi8('r'), mud = _mm_set1_epi8('m'), water = _mm_set1_epi8('~');
+		__m128i walls[4], dots[4], terrain[4];
+		for (int i = 0; i < 4; ++i) {
+			const __m128i cells = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+			walls[i] = _mm_cmpeq_epi8(cells, wall);
+			dots[i] = _mm_cmpeq_epi8(cells, dot);
+			terrain[i] = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(cells, road), _mm_cmpeq_epi8(cells, mud)), _mm_cmpeq_epi8(cells, water));
+		}
+		const std::uint64_t terrain_mask = sse2_mask(terrain[0], terrain[1], terrain[2], terrain[3]);
+		return { sse2_mask(walls[0], walls[1], walls[2], walls[3]),
+			sse2_mask(dots[0], dots[1], dots[2], dots[3]) | terrain_mask, terrain_mask };
+	}
+
+	MAP_SCAN_AVX2_TARGET std::uint64_t avx2_mask(__m256i low, __m256i high) {
+		return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(low))) |
+			static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(high))) << 32;
+	}
+
+	struct avx2_block { MAP_SCAN_AVX2_TARGET block_masks operator()(const char* block) const; };
+	MAP_SCAN_AVX2_TARGET block_masks avx2_block::operator()(const char* block) const {
+		const __m256i wall = _mm256_set1_epi8('w'), dot = _mm256_set1_epi8('.');
+		const __m256i road = _mm256_set1_epi8('r'), mud = _mm256_set1_epi8('m'), water = _mm256_set1_epi8('~');
+		const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+		const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+		const std::uint64_t terrain = avx2_mask(
+			_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(low, road), _mm256_cmpeq_epi8(low, mud)), _mm256_cmpeq_epi8(low, water)),
+			_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(high, road), _mm256_cmpeq_epi8(high, mud)), _mm256_cmpeq_epi8(high, water)));
+		return { avx2_mask(_mm256_cmpeq_epi8(low, wall), _mm256_cmpeq_epi8(high, wall)),
+			avx2_mask(_mm256_cmpeq_epi8(low, dot), _mm256_cmpeq_epi8(high, dot)) | terrain, terrain };
+	}
+
+	MAP_SCAN_AVX2_TARGET void scan_range_avx2(const char* cells, std::size_t begin, std::size_t end, std::uint64_t* words, MapScan& scan) {
+		scan_blocks(cells, begin, end, words, scan, avx2_block());
+	}
+
+	void scan_range_sse2(const char* cells, std::size_t begin, std::size_t end, std::uint64_t* words, MapScan& scan) {
+		scan_blocks(cells, begin, end, words, scan, sse2_block());
+	}
+
+	bool cpu_has_avx2() {
+#if defined(_MSC_VER)
+		// AVX2 needs the CPU flag and the OS saving the YMM registers (OSXSAVE, then XCR0 bits 1 and 2).
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) return false;
+		__cpuid(info, 1);
+		if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6) return false;
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif
+
+	range_scanner fastest_scanner() {
+#ifdef MAP_SCAN_SSE2
+		static const range_scanner scanner = cpu_has_avx2() ? scan_range_avx2 : scan_range_sse2;
+		return scanner;
+#else
+		return scan_range_scalar;
+#endif
+	}
+}
+
+void scan_map_scalar(const char* cells, std::size_t count, MapScan& scan) {
+	begin_scan(count, scan);
+	scan_range_scalar(cells, 0, count, scan.walkable.data(), scan);
+}
+
+void scan_map(const char* cells, std::size_t count, MapScan& scan) {
+	begin_scan(count, scan);
+	fastest_scanner()(cells, 0, count, scan.walkable.data(), scan);
+}
+
+void scan_map(const char* cells, std::size_t count, MapScan& scan, c_thread_pool& pool) {
+	begin_scan(count, scan);
+	const std::size_t blocks = scan.walkable.size();
+	const std::size_t band_count = std::min<std::size_t>(blocks, static_cast<std::size_t>(pool.size()) * 4);
+	if (band_count <= 1) {
+		fastest_scanner()(cells, 0, count, scan.walkable.data(), scan);
+		return;
+	}
+
+	// Each band writes its own words of the bitset and collects its specials on the side.
+	std::vector<MapScan> bands(band_count);
+	const range_scanner scanner = fastest_scanner();
+	pool.parallel_for(band_count, 1, [&](unsigned, std::size_t first, std::size_t last) {
+		for (std::size_t band = first; band < last; ++band) {
+			const std::size_t begin = blocks * band / band_count * 64;
+			const std::size_t end = std::min(count, blocks * (band + 1) / band_count * 64);
+			scanner(cells, begin, end, scan.walkable.data(), bands[band]);
+		}
+	});
+
+	// Merge in band order, so the specials stay sorted and the first invalid cell is the first one in the map.
+	for (const MapScan& band : bands) {
+		scan.specials.insert(scan.specials.end(), band.specials.begin(), band.specials.end());
+		if (scan.invalid_count == 0 && band.invalid_count != 0) scan.first_invalid = band.first_invalid;
+		scan.invalid_count += band.invalid_count;
+		scan.has_terrain |= band.has_terrain;
+	}
+}
+
+const char* scan_map_backend() {
+#ifdef MAP_SCAN_SSE2
+	return cpu_has_avx2() ? "avx2" : "sse2";
+#else
+	return "scalar";
+#endif
+}
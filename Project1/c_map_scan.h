@@ -0,0 +1,54 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_map_scan.h
+// Description : One vectorised pass over the map cells that validates them, finds the special cells and builds the walkability bitset.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class c_thread_pool;
+
+struct MapScan { // Everything scan_map learns about a cell buffer.
+	std::vector<std::uint64_t> walkable;        // One bit per cell, set if the cell is not a wall. Same layout as c_graph.
+	std::vector<std::pair<int, char>> specials; // Every start, exit and item cell as (index, char), sorted by index.
+	std::size_t invalid_count = 0;              // Cells holding a character the map format does not allow.
+	std::size_t first_invalid = 0;              // Index of the first of them, only meaningful if invalid_count > 0.
+	bool has_terrain = false;                   // Whether any road, mud or water cell was seen, see c_terrain.h.
+};
+
+/**
+ * @brief Classify every cell in one pass, 64 cells at a time.
+ * @param cells - count map characters, row after row.
+ * @param count - Number of cells.
+ * @param scan  - Filled in, its buffers are reused.
+ * @note  Walls, floor and terrain are recognised with AVX2 or SSE2 compares where the CPU has them (checked at run
+ *        time), and only the few cells left over are looked at one by one.
+ */
+void scan_map(const char* cells, std::size_t count, MapScan& scan);
+
+/**
+ * @brief scan_map split into bands of whole 64-cell blocks scanned across a thread pool.
+ * @param pool - Pool to run the bands on.
+ * @note  The result is exactly scan_map's: each band fills its own words of the bitset, and the special cells are
+ *        merged in band order afterwards.
+ */
+void scan_map(const char* cells, std::size_t count, MapScan& scan, c_thread_pool& pool);
+
+/**
+ * @brief Get the name of the code path scan_map uses on this machine: "avx2", "sse2" or "scalar".
+ */
+const char* scan_map_backend();
+
+/**
+ * @brief scan_map restricted to the portable scalar code path, the reference the vector paths must match.
+ */
+void scan_map_scalar(const char* cells, std::size_t count, MapScan& scan);
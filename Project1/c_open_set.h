@@ -0,0 +1,251 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_open_set.h
+// Description : Open set back ends for the searches: binary heap, indexed 4-ary heap and bucket queue.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+// Every back end has the same interface, used by c_basic_search_state:
+//   using score_type = ...;                                   // double, or an integer type for integer searches.
+//   void begin(std::size_t cell_count, double max_step_cost); // Empty the set for a new search.
+//   void push(int index, score_type f_score);
+//   int pop();                                                // Remove and return the cell with the lowest f_score.
+//   score_type min_score() const;                             // Lower bound on the f_score pop would return.
+//   bool empty() const;
+//   std::size_t size() const;
+//   std::size_t memory_usage() const;                         // Bytes of scratch memory held.
+
+struct OpenEntry { // One open set entry: the f_score and the 32-bit cell index it belongs to.
+	double f_score;
+	std::uint32_t index;
+};
+
+struct OpenEntryComparator { // Min-heap ordering on f_score, same ordering as NodeComparator.
+	bool operator()(const OpenEntry& a, const OpenEntry& b) const {
+		return a.f_score > b.f_score;
+	}
+};
+
+/**
+ * @brief Binary heap without decrease-key. A cell that improves is pushed again and the old entry
+ *        is popped later as a stale duplicate, which the search skips.
+ * @tparam Score - Type of the f_scores, double for the usual searches.
+ */
+template <typename Score>
+class c_basic_binary_heap_open_set {
+public:
+	using score_type = Score;
+
+	void begin(std::size_t, double) { heap_.clear(); } // Keeps its capacity.
+	void push(int index, Score f_score) {
+		heap_.push_back({ f_score, static_cast<std::uint32_t>(index) });
+		std::push_heap(heap_.begin(), heap_.end(), comparator());
+	}
+	int pop() {
+		std::pop_heap(heap_.begin(), heap_.end(), comparator());
+		const int index = static_cast<int>(heap_.back().index);
+		heap_.pop_back();
+		return index;
+	}
+	Score min_score() const { return heap_.front().f_score; }
+	bool empty() const { return heap_.empty(); }
+	std::size_t size() const { return heap_.size(); }
+	std::size_t memory_usage() const { return heap_.capacity() * sizeof(entry); }
+
+private:
+	struct entry { // Same layout as OpenEntry, with the score type swapped.
+		Score f_score;
+		std::uint32_t index;
+	};
+	struct comparator {
+		bool operator()(const entry& a, const entry& b) const { return a.f_score > b.f_score; }
+	};
+	std::vector<entry> heap_;
+};
+
+using c_binary_heap_open_set = c_basic_binary_heap_open_set<double>;          // The default open set.
+using c_integer_heap_open_set = c_basic_binary_heap_open_set<std::uint64_t>; // For the fixed-point c_graph::weighted_a_star.
+
+/**
+ * @brief 4-ary heap that tracks each cell's slot, so pushing a cell that is already open lowers its
+ *        key in place. Never holds duplicates, so a search using it has no stale pops.
+ * @note  Costs one 32-bit slot per cell. The slots of cells left in the heap are reset by begin,
+ *        so a new search does not touch the whole array.
+ */
+class c_indexed_heap_open_set {
+public:
+	using score_type = double;
+
+	void begin(std::size_t cell_count, double) {
+		if (slot_.size() < cell_count) {
+			slot_.resize(cell_count, NOT_IN_HEAP);
+		}
+		for (const OpenEntry& entry : heap_) {
+			slot_[entry.index] = NOT_IN_HEAP;
+		}
+		heap_.clear();
+	}
+	void push(int index, double f_score) {
+		const std::uint32_t slot = slot_[index];
+		if (slot != NOT_IN_HEAP) {
+			// Already open, decrease-key if the new score is better.
+			if (f_score < heap_[slot].f_score) {
+				heap_[slot].f_score = f_score;
+				sift_up(slot);
+			}
+			return;
+		}
+		heap_.push_back({ f_score, static_cast<std::uint32_t>(index) });
+		sift_up(static_cast<std::uint32_t>(heap_.size() - 1));
+	}
+	int pop() {
+		const int index = static_cast<int>(heap_.front().index);
+		slot_[index] = NOT_IN_HEAP;
+		heap_.front() = heap_.back();
+		heap_.pop_back();
+		if (!heap_.empty()) {
+			slot_[heap_.front().index] = 0;
+			sift_down(0);
+		}
+		return index;
+	}
+	double min_score() const { return heap_.front().f_score; }
+	bool empty() const { return heap_.empty(); }
+	std::size_t size() const { return heap_.size(); }
+	std::size_t memory_usage() const { return heap_.capacity() * sizeof(OpenEntry) + slot_.capacity() * sizeof(std::uint32_t); }
+
+private:
+	static constexpr std::uint32_t NOT_IN_HEAP = std::numeric_limits<std::uint32_t>::max();
+	static constexpr std::uint32_t ARITY = 4; // Shallower than a binary heap, and the 4 children share a cache line.
+
+	std::vector<OpenEntry> heap_;
+	std::vector<std::uint32_t> slot_; // Per cell, position in heap_ or NOT_IN_HEAP.
+
+	void sift_up(std::uint32_t slot) {
+		const OpenEntry entry = heap_[slot];
+		while (slot > 0) {
+			const std::uint32_t parent = (slot - 1) / ARITY;
+			if (heap_[parent].f_score <= entry.f_score) break;
+			heap_[slot] = heap_[parent];
+			slot_[heap_[slot].index] = slot;
+			slot = parent;
+		}
+		heap_[slot] = entry;
+		slot_[entry.index] = slot;
+	}
+	void sift_down(std::uint32_t slot) {
+		const OpenEntry entry = heap_[slot];
+		const std::uint32_t count = static_cast<std::uint32_t>(heap_.size());
+		while (true) {
+			const std::uint32_t first = slot * ARITY + 1;
+			if (first >= count) break;
+			std::uint32_t best = first;
+			const std::uint32_t last = std::min(first + ARITY, count);
+			for (std::uint32_t child = first + 1; child < last; ++child) {
+				if (heap_[child].f_score < heap_[best].f_score) best = child;
+			}
+			if (heap_[best].f_score >= entry.f_score) break;
+			heap_[slot] = heap_[best];
+			slot_[heap_[slot].index] = slot;
+			slot = best;
+		}
+		heap_[slot] = entry;
+		slot_[entry.index] = slot;
+	}
+};
+
+/**
+ * @brief Bucket queue (Dial's algorithm) over fixed-point f_scores, O(1) push and amortised O(1) pop.
+ * @note  With a consistent heuristic every open f_score lies within 2 * max_step_cost of the lowest,
+ *        so a small ring of buckets covers them all. Scores are rounded down to 1/KEY_SCALE: exact for
+ *        the integer 4-way costs. For 8-way a popped cell's f_score may be up to 1/KEY_SCALE above the
+ *        lowest, and closed cells are never reopened, so that error adds up once per step. The path found
+ *        costs at most its step count / KEY_SCALE more than the shortest, under 1 part in KEY_SCALE since
+ *        every step costs at least 1. Ties pop last in, first out. Like the binary heap it keeps stale duplicates.
+ */
+class c_bucket_open_set {
+public:
+	using score_type = double;
+	static constexpr double KEY_SCALE = 1024.0; // Fixed-point units per unit of cost.
+
+	void begin(std::size_t, double max_step_cost) {
+		if (size_ != 0) {
+			for (auto& bucket : buckets_) bucket.clear();
+			size_ = 0;
+		}
+		const std::size_t span = static_cast<std::size_t>(std::ceil(2.0 * max_step_cost * KEY_SCALE)) + 2;
+		if (buckets_.size() < span) resize(span);
+		current_ = 0;
+		highest_ = 0;
+	}
+	void push(int index, double f_score) {
+		const std::uint64_t key = static_cast<std::uint64_t>(f_score * KEY_SCALE);
+		if (size_ == 0) {
+			current_ = key;
+			highest_ = key;
+		} else if (key < current_) {
+			// Below every open key, so the ring now starts here.
+			if (highest_ - key >= buckets_.size()) resize(static_cast<std::size_t>(highest_ - key + 1));
+			current_ = key;
+		} else if (key > highest_) {
+			if (key - current_ >= buckets_.size()) resize(static_cast<std::size_t>(key - current_ + 1));
+			highest_ = key;
+		}
+		buckets_[key & (buckets_.size() - 1)].push_back(static_cast<std::uint32_t>(index));
+		++size_;
+	}
+	int pop() {
+		std::vector<std::uint32_t>* bucket = &buckets_[current_ & (buckets_.size() - 1)];
+		while (bucket->empty()) {
+			++current_;
+			bucket = &buckets_[current_ & (buckets_.size() - 1)];
+		}
+		const int index = static_cast<int>(bucket->back());
+		bucket->pop_back();
+		--size_;
+		return index;
+	}
+	double min_score() const { // Rounded down to the bucket's key.
+		std::uint64_t key = current_;
+		while (buckets_[key & (buckets_.size() - 1)].empty()) ++key;
+		return static_cast<double>(key) / KEY_SCALE;
+	}
+	bool empty() const { return size_ == 0; }
+	std::size_t size() const { return size_; }
+	std::size_t memory_usage() const {
+		std::size_t bytes = buckets_.capacity() * sizeof(std::vector<std::uint32_t>);
+		for (const auto& bucket : buckets_) bytes += bucket.capacity() * sizeof(std::uint32_t);
+		return bytes;
+	}
+
+private:
+	std::vector<std::vector<std::uint32_t>> buckets_; // Ring of buckets, bucket for key k is k & (size - 1).
+	std::uint64_t current_ = 0;                        // Lowest key that may be non-empty.
+	std::uint64_t highest_ = 0;                        // Highest key pushed since the queue was last empty.
+	std::size_t size_ = 0;
+
+	void resize(std::size_t span) {
+		// Grow to a power of two and move every bucket from current_ on to its slot in the new ring.
+		std::size_t count = 64;
+		while (count < span) count *= 2;
+		std::vector<std::vector<std::uint32_t>> grown(count);
+		const std::size_t old_count = buckets_.size();
+		for (std::size_t offset = 0; offset < old_count; ++offset) {
+			const std::uint64_t key = current_ + offset;
+			grown[key & (count - 1)].swap(buckets_[key & (old_count - 1)]);
+		}
+		buckets_.swap(grown);
+	}
+};
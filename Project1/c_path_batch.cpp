@@ -0,0 +1,54 @@
+#include "c_path_batch.h"
+#include <algorithm>
+
+c_path_batch::c_path_batch(const c_graph& graph, unsigned thread_count)
+	: graph_(graph), pool_(thread_count), scratch_(pool_.size()) {
+}
+
+void c_path_batch::find_paths(std::span<const PathQuery> queries, c_path_batch_result& results) {
+	const std::size_t count = queries.size();
+	for (auto& scratch : scratch_) {
+		scratch.cells.clear();
+		scratch.spans.clear();
+	}
+
+	// Search phase: each worker appends the paths it finds to its own buffer.
+	pool_.parallel_for(count, 16, [&](unsigned worker, std::size_t begin, std::size_t end) {
+		WorkerScratch& scratch = scratch_[worker];
+		for (std::size_t i = begin; i < end; ++i) {
+			const std::size_t offset = scratch.cells.size();
+			if (graph_.a_star(queries[i].start, queries[i].goal, scratch.state, scratch.cells)) {
+				scratch.spans.emplace_back(i, offset);
+			}
+		}
+	});
+
+	// Work out where each path lands in the shared buffer, in query order.
+	owner_.assign(count, { 0u, 0 });
+	std::vector<std::size_t>& offsets = results.offsets_;
+	offsets.assign(count + 1, 0);
+	for (unsigned worker = 0; worker < scratch_.size(); ++worker) {
+		const WorkerScratch& scratch = scratch_[worker];
+		for (std::size_t k = 0; k < scratch.spans.size(); ++k) {
+			const std::size_t query = scratch.spans[k].first;
+			const std::size_t offset = scratch.spans[k].second;
+			const std::size_t next = k + 1 < scratch.spans.size() ? scratch.spans[k + 1].second : scratch.cells.size();
+			owner_[query] = { worker, offset };
+			offsets[query + 1] = next - offset; // Length for now, turned into an offset below.
+		}
+	}
+	for (std::size_t i = 0; i < count; ++i) {
+		offsets[i + 1] += offsets[i];
+	}
+
+	// Copy phase: move each worker's paths into place, also in parallel.
+	results.cells_.resize(offsets[count]);
+	pool_.parallel_for(count, 256, [&](unsigned, std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; ++i) {
+			const std::size_t length = offsets[i + 1] - offsets[i];
+			if (length == 0) continue;
+			const auto& source = scratch_[owner_[i].first].cells;
+			std::copy_n(source.begin() + owner_[i].second, length, results.cells_.begin() + offsets[i]);
+		}
+	});
+}
@@ -0,0 +1,77 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_path_batch.h
+// Description : Batched A* queries against one read-only graph, spread over a thread pool.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+#include "c_graph.h"
+#include "c_search_state.h"
+#include "c_thread_pool.h"
+
+struct PathQuery { // One start/goal request.
+	Node start;
+	Node goal;
+};
+
+/**
+ * @brief Paths for a batch of queries, stored back to back in one buffer that is reused between batches.
+ */
+class c_path_batch_result {
+public:
+	std::size_t size() const { return offsets_.empty() ? 0 : offsets_.size() - 1; } // Number of queries.
+	bool found(std::size_t query) const { return offsets_[query + 1] != offsets_[query]; }
+	/**
+	 * @brief Get the path for the specified query, empty if no path was found.
+	 */
+	std::span<const std::pair<int, int>> path(std::size_t query) const {
+		return { cells_.data() + offsets_[query], offsets_[query + 1] - offsets_[query] };
+	}
+
+private:
+	friend class c_path_batch;
+	std::vector<std::pair<int, int>> cells_; // All paths, back to back in query order.
+	std::vector<std::size_t> offsets_;       // Path i is cells_[offsets_[i], offsets_[i + 1]).
+};
+
+class c_path_batch {
+public:
+	/**
+	 * @brief Create a batch runner for the specified graph.
+	 * @param graph        - The graph to search, must outlive the runner and not change while a batch runs.
+	 * @param thread_count - Number of worker threads, 0 uses the number of hardware threads.
+	 */
+	explicit c_path_batch(const c_graph& graph, unsigned thread_count = 0);
+
+	/**
+	 * @brief Run A* for every query and write the paths into results.
+	 * @param queries - The start/goal pairs to answer.
+	 * @param results - Output buffer, its memory is reused when the same object is passed again.
+	 * @note  Does not print. Each worker has its own search state and path buffer, so a warm runner
+	 *        does not allocate unless a batch produces longer paths than any before it.
+	 */
+	void find_paths(std::span<const PathQuery> queries, c_path_batch_result& results);
+
+	unsigned thread_count() const { return pool_.size(); }
+
+private:
+	struct WorkerScratch {
+		c_search_state state;                           // Search state reused by this worker.
+		std::vector<std::pair<int, int>> cells;         // Paths found by this worker, back to back.
+		std::vector<std::pair<std::size_t, std::size_t>> spans; // (query, offset into cells) per path found.
+	};
+
+	const c_graph& graph_;
+	c_thread_pool pool_;
+	std::vector<WorkerScratch> scratch_; // One per worker.
+	std::vector<std::pair<unsigned, std::size_t>> owner_; // Per query: worker that answered it and offset in its cells.
+};
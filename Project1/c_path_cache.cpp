@@ -0,0 +1,185 @@
+#include "c_path_cache.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+	// Direction codes, in the same order as the straight then diagonal neighbours in a_star.
+	constexpr int STEPS[8][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {-1, 1}, {1, -1}, {1, 1} };
+
+	int step_code(int dx, int dy) {
+		for (int code = 0; code < 8; ++code) {
+			if (STEPS[code][0] == dx && STEPS[code][1] == dy) return code;
+		}
+		throw std::invalid_argument("Path cells are not adjacent");
+	}
+}
+
+void c_compact_path::encode(const std::pair<int, int>* cells, std::size_t count) {
+	codes_.clear();
+	cost_ = 0.0;
+	has_start_ = count > 0;
+	step_count_ = count > 0 ? count - 1 : 0;
+	if (count == 0) return;
+	start_x_ = cells[0].first;
+	start_y_ = cells[0].second;
+	codes_.assign((step_count_ + 1) / 2, 0);
+	for (std::size_t i = 1; i < count; ++i) {
+		const int code = step_code(cells[i].first - cells[i - 1].first, cells[i].second - cells[i - 1].second);
+		codes_[(i - 1) / 2] |= static_cast<std::uint8_t>(code << (((i - 1) & 1) * 4));
+		cost_ += code < 4 ? 1.0 : Neighbourhood8::diagonal_cost;
+	}
+}
+
+void c_compact_path::decode(std::vector<std::pair<int, int>>& path) const {
+	if (!has_start_) return;
+	path.reserve(path.size() + step_count_ + 1);
+	std::pair<int, int> at{ start_x_, start_y_ };
+	path.push_back(at);
+	for (std::size_t i = 0; i < step_count_; ++i) {
+		const int code = (codes_[i / 2] >> ((i & 1) * 4)) & 0xF;
+		at.first += STEPS[code][0];
+		at.second += STEPS[code][1];
+		path.push_back(at);
+	}
+}
+
+c_path_cache::c_path_cache(const c_graph& graph, std::size_t capacity, int region_size)
+	: graph_(graph), capacity_(std::max<std::size_t>(capacity, 1)), region_size_(region_size),
+	region_cols_(region_size > 0 ? (graph.cols() + region_size - 1) / region_size : 0), graph_version_(graph.version()) {
+	if (region_size < 1) {
+		throw std::invalid_argument("Region size must be at least 1");
+	}
+}
+
+void c_path_cache::path_regions(const std::vector<std::pair<int, int>>& cells, std::size_t first, std::vector<int>& regions) const {
+	regions.clear();
+	for (std::size_t i = first; i < cells.size(); ++i) {
+		regions.push_back(region_of(cells[i].first, cells[i].second));
+		// A diagonal step is only legal while both cells it passes between stay open.
+		if (i > first && cells[i].first != cells[i - 1].first && cells[i].second != cells[i - 1].second) {
+			regions.push_back(region_of(cells[i].first, cells[i - 1].second));
+			regions.push_back(region_of(cells[i - 1].first, cells[i].second));
+		}
+	}
+	std::sort(regions.begin(), regions.end());
+	regions.erase(std::unique(regions.begin(), regions.end()), regions.end());
+}
+
+bool c_path_cache::find_path(const Node& start, const Node& goal, PathOptions options, c_search_state& state, std::vector<std::pair<int, int>>& path) {
+	const Key key{ graph_.cell_index(start.x, start.y), graph_.cell_index(goal.x, goal.y), options.eight_way };
+	std::uint64_t version = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (graph_version_ != graph_.version()) { // Edited without on_cell_changed, nothing can be trusted.
+			entries_.clear();
+			recency_.clear();
+			graph_version_ = graph_.version();
+		}
+		version = graph_version_;
+		const auto found = entries_.find(key);
+		if (found != entries_.end()) {
+			++hits_;
+			recency_.splice(recency_.begin(), recency_, found->second.recency);
+			found->second.path.decode(path);
+			return found->second.found;
+		}
+	}
+
+	// Search without holding the lock, so misses on other threads are not serialised.
+	++misses_;
+	const std::size_t first = path.size();
+	const bool found = options.eight_way ? graph_.a_star<Neighbourhood8>(start, goal, state, path)
+		: graph_.a_star<Neighbourhood4>(start, goal, state, path);
+	Entry entry{ found, {}, {}, {} };
+	entry.path.encode(path.data() + first, path.size() - first);
+	path_regions(path, first, entry.regions);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (graph_version_ != version || entries_.count(key) != 0) {
+		return found; // The graph moved on or another thread cached it first.
+	}
+	if (entries_.size() >= capacity_) {
+		erase(entries_.find(recency_.back()));
+	}
+	recency_.push_front(key);
+	entry.recency = recency_.begin();
+	entries_.emplace(key, std::move(entry));
+	return found;
+}
+
+std::vector<std::pair<int, int>> c_path_cache::find_path(const Node& start, const Node& goal, PathOptions options, c_search_state& state) {
+	std::vector<std::pair<int, int>> path;
+	find_path(start, goal, options, state, path);
+	return path;
+}
+
+int c_path_cache::on_cell_changed(int x, int y) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	const int cols = graph_.cols();
+	const bool opened = graph_.is_walkable(graph_.cell_index(x, y));
+	const int region = region_of(x, y);
+	int dropped = 0;
+	for (auto it = entries_.begin(); it != entries_.end();) {
+		const Entry& entry = it->second;
+		bool stale;
+		if (!opened) {
+			// A new wall only breaks the paths that ran through or diagonally past it.
+			stale = std::binary_search(entry.regions.begin(), entry.regions.end(), region);
+		} else if (!entry.found) {
+			stale = true; // The new floor may connect the start to the goal.
+		} else {
+			// A path through a cell costs at least h(start, cell) + h(cell, goal), it can only win if that is shorter.
+			// An opened cell also frees the diagonal steps past it, which run through its neighbours.
+			const Key& key = it->first;
+			const int sx = key.start / cols, sy = key.start % cols;
+			const int gx = key.goal / cols, gy = key.goal % cols;
+			double bound;
+			if (key.eight_way) {
+				bound = Neighbourhood8::heuristic(std::abs(x - sx), std::abs(y - sy)) + Neighbourhood8::heuristic(std::abs(x - gx), std::abs(y - gy));
+				for (const auto& step : STEPS) {
+					const int nx = x + step[0], ny = y + step[1];
+					bound = std::min(bound, Neighbourhood8::heuristic(std::abs(nx - sx), std::abs(ny - sy)) + Neighbourhood8::heuristic(std::abs(nx - gx), std::abs(ny - gy)));
+				}
+			} else {
+				bound = Neighbourhood4::heuristic(std::abs(x - sx), std::abs(y - sy)) + Neighbourhood4::heuristic(std::abs(x - gx), std::abs(y - gy));
+			}
+			stale = bound < entry.path.cost() - 1e-9;
+		}
+		if (stale) {
+			recency_.erase(it->second.recency);
+			it = entries_.erase(it);
+			++dropped;
+		} else {
+			++it;
+		}
+	}
+	graph_version_ = graph_.version();
+	invalidated_ += dropped;
+	return dropped;
+}
+
+void c_path_cache::invalidate() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	entries_.clear();
+	recency_.clear();
+}
+
+std::size_t c_path_cache::size() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return entries_.size();
+}
+
+std::size_t c_path_cache::memory_usage() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::size_t bytes = 0;
+	for (const auto& [key, entry] : entries_) {
+		bytes += entry.path.memory_usage();
+	}
+	return bytes;
+}
+
+void c_path_cache::erase(std::unordered_map<Key, Entry, KeyHash>::iterator entry) {
+	recency_.erase(entry->second.recency);
+	entries_.erase(entry);
+}
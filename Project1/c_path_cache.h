@@ -0,0 +1,143 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_path_cache.h
+// Description : Bounded LRU cache of a_star results with per-region invalidation on cell edits.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "c_graph.h"
+#include "c_search_state.h"
+
+struct PathOptions { // Search options that are part of a cache key.
+	bool eight_way = false; // Neighbourhood8 instead of Neighbourhood4.
+};
+
+/**
+ * @brief A cell path stored as its first cell plus one 4-bit direction code per step.
+ * @note  A step is 8 bytes as a std::pair<int, int> and half a byte here.
+ */
+class c_compact_path {
+public:
+	/**
+	 * @brief Replace the stored path, throws if two consecutive cells are not adjacent.
+	 */
+	void encode(const std::pair<int, int>* cells, std::size_t count);
+	/**
+	 * @brief Append every cell of the path to a caller-owned buffer.
+	 */
+	void decode(std::vector<std::pair<int, int>>& path) const;
+
+	std::size_t size() const { return has_start_ ? step_count_ + 1 : 0; } // Number of cells.
+	double cost() const { return cost_; } // 1 per straight step, sqrt(2) per diagonal step.
+	std::size_t memory_usage() const { return codes_.capacity(); }
+
+private:
+	int start_x_ = 0;
+	int start_y_ = 0;
+	bool has_start_ = false;         // False for an empty path.
+	std::size_t step_count_ = 0;
+	double cost_ = 0.0;
+	std::vector<std::uint8_t> codes_; // Two direction codes per byte, low nibble first.
+};
+
+/**
+ * @brief Cache of shortest paths keyed by (start, goal, options), safe to share between threads.
+ * @note  Each entry remembers which regions of the grid its path crosses. When a cell is walled off,
+ *        only entries whose path crosses that cell's region are dropped. When a wall is opened, only
+ *        entries that a path through or diagonally past that cell could beat are dropped, found from the heuristic bound.
+ *        Failed searches are cached too, and dropped by any opened wall.
+ */
+class c_path_cache {
+public:
+	/**
+	 * @brief Create a cache for the specified graph.
+	 * @param graph       - The graph to search, must outlive the cache.
+	 * @param capacity    - Most paths kept at once, the least recently used is evicted first.
+	 * @param region_size - Width and height in cells of the regions edits are tracked by.
+	 */
+	explicit c_path_cache(const c_graph& graph, std::size_t capacity = 1024, int region_size = 32);
+
+	/**
+	 * @brief Get the path from the start node to the goal node, running a_star on a miss.
+	 * @param state - Search state for a miss, owned by the calling thread. The search runs without the cache locked.
+	 * @param path  - Buffer the path coordinates are appended to, left unchanged if no path exists.
+	 * @return True if a path exists.
+	 */
+	bool find_path(const Node& start, const Node& goal, PathOptions options, c_search_state& state, std::vector<std::pair<int, int>>& path);
+	/**
+	 * @brief Get the path from the start node to the goal node, running a_star on a miss.
+	 * @return A vector of pairs representing the path coordinates, empty if no path exists.
+	 */
+	std::vector<std::pair<int, int>> find_path(const Node& start, const Node& goal, PathOptions options, c_search_state& state);
+
+	/**
+	 * @brief Drop the entries a cell edit may have made wrong. Call after every c_graph::set_walkable.
+	 * @param x - The x-coordinate (row) of the changed cell.
+	 * @param y - The y-coordinate (column) of the changed cell.
+	 * @return  - The number of entries dropped.
+	 * @note  If the graph changes without this being called the whole cache is dropped on the next lookup.
+	 */
+	int on_cell_changed(int x, int y);
+	/**
+	 * @brief Drop every cached path.
+	 */
+	void invalidate();
+
+	std::size_t size() const;
+	std::size_t memory_usage() const;                     // Bytes of packed direction codes held.
+	std::size_t hits() const { return hits_.load(); }     // find_path calls answered from the cache.
+	std::size_t misses() const { return misses_.load(); } // find_path calls that ran a search.
+	std::size_t invalidated() const { return invalidated_.load(); } // Entries dropped by edits.
+
+private:
+	struct Key {
+		int start;  // Cell index of the start.
+		int goal;   // Cell index of the goal.
+		bool eight_way;
+		bool operator==(const Key& other) const { return start == other.start && goal == other.goal && eight_way == other.eight_way; }
+	};
+	struct KeyHash {
+		std::size_t operator()(const Key& key) const noexcept {
+			return std::hash<std::uint64_t>()((static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.start)) << 33) ^
+				(static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.goal)) << 1) ^ key.eight_way);
+		}
+	};
+	struct Entry {
+		bool found;
+		c_compact_path path;
+		std::vector<int> regions;         // Sorted ids of the regions the path depends on.
+		std::list<Key>::iterator recency; // Position in recency_.
+	};
+
+	const c_graph& graph_;
+	std::size_t capacity_;
+	int region_size_;
+	int region_cols_;
+	mutable std::mutex mutex_;
+	std::uint64_t graph_version_ = 0;                 // Version the cached paths are valid for.
+	std::unordered_map<Key, Entry, KeyHash> entries_;
+	std::list<Key> recency_;                          // Keys, most recently used first.
+	std::atomic<std::size_t> hits_{ 0 };
+	std::atomic<std::size_t> misses_{ 0 };
+	std::atomic<std::size_t> invalidated_{ 0 };
+
+	int region_of(int x, int y) const { return (x / region_size_) * region_cols_ + y / region_size_; }
+	/**
+	 * @brief Collect the regions a path depends on: those of its cells, and for diagonal steps the two corner cells.
+	 */
+	void path_regions(const std::vector<std::pair<int, int>>& cells, std::size_t first, std::vector<int>& regions) const;
+	void erase(std::unordered_map<Key, Entry, KeyHash>::iterator entry);
+};
@@ -0,0 +1,170 @@
+#include "c_path_server.h"
+#include <charconv>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+	std::vector<std::string> split_words(const std::string& line) {
+		std::istringstream stream(line);
+		std::vector<std::string> words;
+		for (std::string word; stream >> word;) words.push_back(std::move(word));
+		return words;
+	}
+
+	int parse_coordinate(const std::string& word) {
+		int value = 0;
+		const auto [end, error] = std::from_chars(word.data(), word.data() + word.size(), value);
+		if (error != std::errc() || end != word.data() + word.size()) {
+			throw std::invalid_argument("Bad coordinate: " + word);
+		}
+		return value;
+	}
+
+	void append_number(std::string& out, std::uint64_t value) {
+		char digits[24];
+		const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+		out.append(digits, result.ptr);
+	}
+}
+
+c_path_server::c_path_server(c_map_registry& registry) : registry_(registry) {
+}
+
+std::string c_path_server::handle(const std::string& request, Session& session) {
+	try {
+		const std::vector<std::string> words = split_words(request);
+		if (words.empty()) throw std::invalid_argument("Empty request");
+		const std::string& command = words[0];
+
+		if (command == "path" && (words.size() == 2 || words.size() == 6)) {
+			return find_path(words, session);
+		}
+		if (command == "info" && words.size() == 2) {
+			const c_map_registry::map_ptr map = registry_.find(words[1]);
+			if (!map) throw std::invalid_argument("No map named " + words[1]);
+			std::ostringstream out;
+			out << "map " << map->name << ' ' << map->version << ' ' << map->graph.rows() << ' ' << map->graph.cols() << ' '
+				<< map->start.x << ' ' << map->start.y << ' ' << map->exit.x << ' ' << map->exit.y;
+			return out.str();
+		}
+		if (command == "load" && words.size() == 3) {
+			const c_map_registry::map_ptr map = registry_.load(words[1], words[2]);
+			return "loaded " + map->name + ' ' + std::to_string(map->version);
+		}
+		if (command == "unload" && words.size() == 2) {
+			if (!registry_.unload(words[1])) throw std::invalid_argument("No map named " + words[1]);
+			return "unloaded " + words[1];
+		}
+		if (command == "maps" && words.size() == 1) {
+			std::string out = "maps";
+			for (const std::string& name : registry_.names()) out += ' ' + name;
+			return out;
+		}
+		if (command == "shutdown" && words.size() == 1) {
+			stop();
+			return "bye";
+		}
+		throw std::invalid_argument("Unknown request: " + request);
+	}
+	catch (const std::exception& e) {
+		return std::string("error ") + e.what();
+	}
+}
+
+std::string c_path_server::find_path(const std::vector<std::string>& words, Session& session) const {
+	// Holding the pointer keeps this version alive for the whole search, even if the map is reloaded meanwhile.
+	const c_map_registry::map_ptr map = registry_.find(words[1]);
+	if (!map) throw std::invalid_argument("No map named " + words[1]);
+	const c_graph& graph = map->graph;
+	Node start = map->start;
+	Node goal = map->exit;
+	if (words.size() == 6) {
+		start = graph.get_node(parse_coordinate(words[2]), parse_coordinate(words[3])); // Throws if out of range.
+		goal = graph.get_node(parse_coordinate(words[4]), parse_coordinate(words[5]));
+	}
+
+	session.path.clear();
+	const bool found = graph.has_terrain()
+		? graph.weighted_a_star(start, goal, session.weighted, session.path)
+		: graph.a_star(start, goal, session.state, session.path);
+
+	std::string out = found ? "ok " : "none ";
+	append_number(out, map->version);
+	if (!found) return out;
+	out += ' ';
+	append_number(out, session.path.size() - 1);
+	for (const auto& [x, y] : session.path) {
+		out += ' ';
+		append_number(out, static_cast<std::uint64_t>(x));
+		out += ' ';
+		append_number(out, static_cast<std::uint64_t>(y));
+	}
+	return out;
+}
+
+void c_path_server::serve(std::istream& in, std::ostream& out) {
+	Session session;
+	for (std::string line; !stopping_ && std::getline(in, line);) {
+		if (line.empty()) continue;
+		out << handle(line, session) << '\n' << std::flush; // Flushed per line so a piped client sees each answer.
+	}
+}
+
+void c_path_server::serve(const std::string& path) {
+	c_local_socket listener = c_local_socket::listen(path);
+	{
+		std::lock_guard<std::mutex> lock(connections_mutex_);
+		listener_ = &listener;
+	}
+	while (!stopping_) {
+		c_local_socket socket = listener.accept();
+		if (!socket.is_open()) break; // stop() shut the listener down.
+		reap_connections(false);
+
+		std::lock_guard<std::mutex> lock(connections_mutex_);
+		if (stopping_) break;
+		Connection& connection = connections_.emplace_back();
+		connection.socket = std::move(socket);
+		connection.thread = std::thread([this, &connection] {
+			Session session;
+			std::string line;
+			try {
+				while (!stopping_ && connection.socket.read_line(line)) {
+					if (!line.empty()) connection.socket.write_line(handle(line, session));
+				}
+			}
+			catch (const std::exception&) {
+				// The client went away mid-write, nothing to answer.
+			}
+			connection.done = true;
+		});
+	}
+	{
+		std::lock_guard<std::mutex> lock(connections_mutex_);
+		listener_ = nullptr;
+	}
+	stop();
+	reap_connections(true);
+}
+
+void c_path_server::stop() {
+	stopping_ = true;
+	std::lock_guard<std::mutex> lock(connections_mutex_);
+	if (listener_ != nullptr) listener_->shutdown();
+	for (Connection& connection : connections_) connection.socket.shutdown();
+}
+
+void c_path_server::reap_connections(bool all) {
+	std::list<Connection> finished;
+	{
+		std::lock_guard<std::mutex> lock(connections_mutex_);
+		for (auto it = connections_.begin(); it != connections_.end();) {
+			const auto next = std::next(it);
+			if (all || it->done) finished.splice(finished.end(), connections_, it);
+			it = next;
+		}
+	}
+	for (Connection& connection : finished) connection.thread.join();
+}
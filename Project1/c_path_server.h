@@ -0,0 +1,87 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_path_server.h
+// Description : Headless path query server over a map registry, reading requests from stdin or a local socket.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <atomic>
+#include <iosfwd>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "c_local_socket.h"
+#include "c_map_registry.h"
+#include "c_search_state.h"
+
+/**
+ * @brief Answers one request per line with one response line.
+ * @note  Requests:
+ *          path <map> [sx sy gx gy]  -> ok <version> <steps> x y x y ...  | none <version>
+ *                                       Without coordinates the path runs from the map's start to its exit.
+ *                                       Maps with terrain are searched with weighted_a_star, others with 4-way a_star.
+ *          info <map>                -> map <name> <version> <rows> <cols> <start x> <start y> <exit x> <exit y>
+ *          load <map> <file>         -> loaded <map> <version>   Loads or hot-reloads, see c_map_registry.
+ *          unload <map>              -> unloaded <map>
+ *          maps                      -> maps <name> ...
+ *          shutdown                  -> bye                      Stops the server.
+ *        Anything that fails answers error <message>. Each connection searches with its own state, against the
+ *        version of the map it looked up when the request arrived.
+ */
+class c_path_server {
+public:
+	struct Session { // Scratch reused by consecutive requests on one connection.
+		c_search_state state;
+		c_weighted_search_state weighted;
+		std::vector<std::pair<int, int>> path;
+	};
+
+	/**
+	 * @param registry - The maps to answer queries on, must outlive the server.
+	 */
+	explicit c_path_server(c_map_registry& registry);
+
+	/**
+	 * @brief Answer one request line.
+	 */
+	std::string handle(const std::string& request, Session& session);
+	/**
+	 * @brief Answer requests from a stream, one at a time, until it ends or a shutdown request.
+	 */
+	void serve(std::istream& in, std::ostream& out);
+	/**
+	 * @brief Listen on a local socket and answer each connection on its own thread until a shutdown request.
+	 * @param path - Socket file to create.
+	 */
+	void serve(const std::string& path);
+	/**
+	 * @brief Stop serving: the listener and every open connection stop reading, answers in flight are still sent.
+	 *        Safe from any thread.
+	 */
+	void stop();
+
+private:
+	struct Connection {
+		c_local_socket socket;
+		std::thread thread;
+		std::atomic<bool> done{ false };
+	};
+
+	c_map_registry& registry_;
+	std::atomic<bool> stopping_{ false };
+	std::mutex connections_mutex_;
+	std::list<Connection> connections_; // Live and finished connections, finished ones are joined on the next accept.
+	c_local_socket* listener_ = nullptr; // The listening socket while serve(path) runs, guarded by connections_mutex_.
+
+	std::string find_path(const std::vector<std::string>& words, Session& session) const;
+	void reap_connections(bool all);
+};
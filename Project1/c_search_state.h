@@ -0,0 +1,149 @@
+﻿// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_search_state.h
+// Description : Reusable per-cell scratch state for searches over a c_graph.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+#include "c_open_set.h"
+#include "c_search_stats.h"
+
+/**
+ * @brief Scratch memory for one search at a time, indexed by cell (x * cols + y).
+ * @tparam OpenSet - Open set back end, see c_open_set.h.
+ * @note  Records are stamped with a generation number instead of being cleared, so starting
+ *        a new search on a graph of the same size is O(1) and never touches the heap.
+ */
+template <typename OpenSet>
+class c_basic_search_state {
+public:
+	using score_type = typename OpenSet::score_type; // double, or an integer type for fixed-point searches.
+
+	struct cell_record {
+		score_type g_score;     // Cost of the cheapest known path from the start to this cell.
+		int came_from;          // Index of the previous cell on that path, -1 for the start.
+		std::uint32_t seen_gen; // Generation in which g_score/came_from were written.
+		std::uint32_t closed_gen; // Generation in which the cell was expanded.
+	};
+
+	/**
+	 * @brief Start a new search over a graph with the specified number of cells.
+	 * @param cell_count    - Number of cells (rows * cols) in the graph being searched.
+	 * @param max_step_cost - Most expensive single step the search can take, sizes the bucket queue.
+	 * @note  Only grows the buffers, records from the previous search are invalidated by the generation bump.
+	 */
+	void begin(std::size_t cell_count, double max_step_cost = 1.0) {
+		if constexpr (SEARCH_STATS_ENABLED) memory_at_begin_ = memory_usage();
+		if (records_.size() < cell_count) {
+			records_.resize(cell_count, cell_record{ score_type{}, -1, 0, 0 });
+		}
+		if (++generation_ == 0) { // Generation wrapped around, stale stamps could alias so clear them once.
+			std::fill(records_.begin(), records_.end(), cell_record{ score_type{}, -1, 0, 0 });
+			generation_ = 1;
+		}
+		open_set_.begin(cell_count, max_step_cost);
+		expansions_ = 0;
+		stale_pops_ = 0;
+		recorded_ = SearchStats{};
+	}
+
+	bool has_score(int index) const { return records_[index].seen_gen == generation_; }
+	bool is_closed(int index) const { return records_[index].closed_gen == generation_; }
+	score_type g_score(int index) const { return records_[index].g_score; }
+	int came_from(int index) const { return records_[index].came_from; }
+
+	void set_score(int index, score_type g_score, int came_from) {
+		cell_record& record = records_[index];
+		record.g_score = g_score;
+		record.came_from = came_from;
+		record.seen_gen = generation_;
+	}
+	void close(int index) {
+		records_[index].closed_gen = generation_;
+		++expansions_;
+	}
+	std::size_t expansions() const { return expansions_; } // Cells expanded by the current search.
+	void count_stale_pop() { ++stale_pops_; }
+	std::size_t stale_pops() const { return stale_pops_; } // Popped entries skipped because the cell was already closed.
+
+	/**
+	 * @brief Get the stats of the current or last search. Only the result, expansions and stale pops
+	 *        are filled in unless PATHFINDING_STATS is on, see c_search_stats.h.
+	 */
+	SearchStats stats() const {
+		SearchStats stats = recorded_;
+		stats.expanded = expansions_;
+		stats.stale_pops = stale_pops_;
+		if constexpr (SEARCH_STATS_ENABLED) {
+			const std::size_t memory = memory_usage();
+			stats.bytes_allocated = memory > memory_at_begin_ ? memory - memory_at_begin_ : 0;
+		}
+		return stats;
+	}
+	SearchStats& recorder() { return recorded_; } // For searches to record their result and phase timings into.
+	std::size_t memory_usage() const { return records_.capacity() * sizeof(cell_record) + open_set_.memory_usage(); }
+
+	// Open set, reused between searches.
+	void push_open(int index, score_type f_score) {
+		open_set_.push(index, f_score);
+		if constexpr (SEARCH_STATS_ENABLED) {
+			++recorded_.pushed;
+			recorded_.peak_open = std::max<std::uint64_t>(recorded_.peak_open, open_set_.size());
+		}
+	}
+	int pop_open() { return open_set_.pop(); }
+	score_type open_min_score() const { return open_set_.min_score(); } // May be a stale entry's, still a lower bound.
+	std::size_t open_size() const { return open_set_.size(); }      // Includes stale entries.
+	bool open_empty() const { return open_set_.empty(); }
+
+private:
+	std::vector<cell_record> records_; // One record per cell, reused across searches.
+	OpenSet open_set_;                 // Open set back end.
+	std::uint32_t generation_ = 0;     // Current search generation.
+	std::size_t expansions_ = 0;       // Number of close() calls since begin().
+	std::size_t stale_pops_ = 0;       // Number of count_stale_pop() calls since begin().
+	SearchStats recorded_;             // Result, plus counters and timings in instrumented builds.
+	std::size_t memory_at_begin_ = 0;  // memory_usage() when the search began, instrumented builds only.
+};
+
+using c_search_state = c_basic_search_state<c_binary_heap_open_set>;         // The default, used by every search.
+using c_indexed_search_state = c_basic_search_state<c_indexed_heap_open_set>; // No stale pops, for a_star.
+using c_bucket_search_state = c_basic_search_state<c_bucket_open_set>;       // O(1) push and pop, for a_star.
+using c_weighted_search_state = c_basic_search_state<c_integer_heap_open_set>; // Integer costs, for weighted_a_star.
+
+/**
+ * @brief Scratch memory for c_graph::bidirectional_a_star, one search state per direction.
+ */
+class c_bidirectional_search_state {
+public:
+	c_search_state& forward() { return forward_; }
+	c_search_state& backward() { return backward_; }
+	std::size_t expansions() const { return forward_.expansions() + backward_.expansions(); } // Cells expanded by both directions.
+	/**
+	 * @brief Get the stats of the last search, counters summed over both directions.
+	 */
+	SearchStats stats() const {
+		SearchStats stats = forward_.stats(); // The result and timings are recorded on the forward state.
+		const SearchStats backward = backward_.stats();
+		stats.expanded += backward.expanded;
+		stats.stale_pops += backward.stale_pops;
+		stats.pushed += backward.pushed;
+		stats.peak_open += backward.peak_open;
+		stats.bytes_allocated += backward.bytes_allocated;
+		return stats;
+	}
+
+private:
+	c_search_state forward_;  // Search from the start towards the goal.
+	c_search_state backward_; // Search from the goal towards the start.
+};
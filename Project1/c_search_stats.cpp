@@ -0,0 +1,32 @@
+#include "c_search_stats.h"
+#include <sstream>
+
+std::string to_json(const SearchStats& stats) {
+	std::ostringstream out;
+	out.precision(9);
+	out << "{\"found\":" << (stats.found ? "true" : "false")
+		<< ",\"path_length\":" << stats.path_length
+		<< ",\"expanded\":" << stats.expanded
+		<< ",\"stale_pops\":" << stats.stale_pops
+		<< ",\"pushed\":" << stats.pushed
+		<< ",\"peak_open\":" << stats.peak_open
+		<< ",\"bytes_allocated\":" << stats.bytes_allocated
+		<< ",\"build_seconds\":" << stats.build_seconds
+		<< ",\"search_seconds\":" << stats.search_seconds
+		<< ",\"reconstruct_seconds\":" << stats.reconstruct_seconds
+		<< ",\"instrumented\":" << (SEARCH_STATS_ENABLED ? "true" : "false") << '}';
+	return out.str();
+}
+
+std::string csv_header() {
+	return "found,path_length,expanded,stale_pops,pushed,peak_open,bytes_allocated,build_seconds,search_seconds,reconstruct_seconds";
+}
+
+std::string to_csv(const SearchStats& stats) {
+	std::ostringstream out;
+	out.precision(9);
+	out << (stats.found ? 1 : 0) << ',' << stats.path_length << ',' << stats.expanded << ',' << stats.stale_pops << ','
+		<< stats.pushed << ',' << stats.peak_open << ',' << stats.bytes_allocated << ',' << stats.build_seconds << ','
+		<< stats.search_seconds << ',' << stats.reconstruct_seconds;
+	return out.str();
+}
@@ -0,0 +1,71 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_search_stats.h
+// Description : Compile-time switchable search instrumentation and its JSON/CSV export.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Define PATHFINDING_STATS=1 (e.g. -DPATHFINDING_STATS=1) to turn the instrumentation on. When it is off
+// every counter and timer below compiles away, and only the result, expansion and stale pop counts are kept.
+#ifndef PATHFINDING_STATS
+#define PATHFINDING_STATS 0
+#endif
+constexpr bool SEARCH_STATS_ENABLED = PATHFINDING_STATS != 0;
+
+struct SearchStats { // What one search did, see c_basic_search_state::stats.
+	bool found = false;                 // Whether a path was found.
+	std::size_t path_length = 0;        // Cells on the path, 0 if none.
+	std::uint64_t expanded = 0;         // Cells expanded (closed).
+	std::uint64_t stale_pops = 0;       // Open set entries popped for cells already closed.
+	std::uint64_t pushed = 0;           // Open set pushes.                          Instrumented builds only.
+	std::uint64_t peak_open = 0;        // Largest open set size, stale entries included. Instrumented builds only.
+	std::uint64_t bytes_allocated = 0;  // Growth of the search state's scratch memory.  Instrumented builds only.
+	double build_seconds = 0.0;         // Time c_graph took to build the graph searched. Instrumented builds only.
+	double search_seconds = 0.0;        // Time spent searching, reconstruction excluded. Instrumented builds only.
+	double reconstruct_seconds = 0.0;   // Time spent turning came_from records into the path. Instrumented builds only.
+};
+
+/**
+ * @brief Add the time until it goes out of scope to a SearchStats timing. Does nothing when stats are off.
+ */
+template <bool Enabled = SEARCH_STATS_ENABLED>
+class c_phase_timer {
+public:
+	explicit c_phase_timer(double& seconds) : seconds_(seconds), begin_(std::chrono::steady_clock::now()) {}
+	~c_phase_timer() { seconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin_).count(); }
+	c_phase_timer(const c_phase_timer&) = delete;
+	c_phase_timer& operator=(const c_phase_timer&) = delete;
+
+private:
+	double& seconds_;                                  // The timing to add to.
+	std::chrono::steady_clock::time_point begin_;      // When the phase started.
+};
+
+template <>
+class c_phase_timer<false> {
+public:
+	explicit c_phase_timer(double&) {}
+};
+
+/**
+ * @brief Format the stats as one JSON object on a single line.
+ */
+std::string to_json(const SearchStats& stats);
+/**
+ * @brief Get the CSV header line matching to_csv, without a trailing newline.
+ */
+std::string csv_header();
+/**
+ * @brief Format the stats as one CSV row, without a trailing newline.
+ */
+std::string to_csv(const SearchStats& stats);
@@ -0,0 +1,69 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_terrain.h
+// Description : Terrain cost classes of the map format and the fixed-point step costs used by weighted_a_star.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <array>
+#include <cstdint>
+
+struct TerrainClass { // One cost class of the map format.
+	char symbol;       // Map character.
+	std::uint8_t cost; // Cost byte, the multiplier applied to every step into a cell of this class.
+	const char* name;
+};
+
+/**
+ * @brief The terrain classes a map may use besides walls. Start, exit and item cells cost the same as floor.
+ */
+constexpr std::array<TerrainClass, 4> TERRAIN_CLASSES = { {
+	{ 'r', 1, "road" },
+	{ '.', 2, "floor" },
+	{ 'm', 4, "mud" },
+	{ '~', 8, "water" },
+} };
+
+constexpr std::uint8_t FLOOR_COST = 2;
+
+/**
+ * @brief Check whether a map character is one of the terrain classes.
+ */
+constexpr bool is_terrain_symbol(char symbol) {
+	for (const TerrainClass& terrain : TERRAIN_CLASSES) {
+		if (terrain.symbol == symbol) return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Get the cost byte of a walkable map character, FLOOR_COST for anything that is not a terrain class.
+ */
+constexpr std::uint8_t terrain_cost(char symbol) {
+	for (const TerrainClass& terrain : TERRAIN_CLASSES) {
+		if (terrain.symbol == symbol) return terrain.cost;
+	}
+	return FLOOR_COST;
+}
+
+// Fixed-point step lengths: a straight step is 1000 units and a diagonal one 1414, sqrt(2) rounded down.
+// The heuristics are built from the same two numbers, so they stay admissible in this cost model.
+constexpr std::uint32_t STRAIGHT_STEP = 1000;
+constexpr std::uint32_t DIAGONAL_STEP = 1414;
+
+namespace terrain_detail {
+	constexpr std::array<std::uint32_t, 256> step_costs(std::uint32_t step) {
+		std::array<std::uint32_t, 256> costs{};
+		for (std::uint32_t cost = 0; cost < 256; ++cost) costs[cost] = cost * step;
+		return costs;
+	}
+}
+
+// Cost of a straight or diagonal step into a cell, indexed by the cell's cost byte.
+constexpr std::array<std::uint32_t, 256> STRAIGHT_STEP_COSTS = terrain_detail::step_costs(STRAIGHT_STEP);
+constexpr std::array<std::uint32_t, 256> DIAGONAL_STEP_COSTS = terrain_detail::step_costs(DIAGONAL_STEP);
@@ -0,0 +1,89 @@
+#include "c_thread_pool.h"
+#include <algorithm>
+
+c_thread_pool::c_thread_pool(unsigned thread_count) {
+	if (thread_count == 0) {
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+	slices_ = std::make_unique<WorkerSlice[]>(thread_count);
+	workers_.reserve(thread_count);
+	for (unsigned i = 0; i < thread_count; ++i) {
+		workers_.emplace_back(&c_thread_pool::worker_loop, this, i);
+	}
+}
+
+c_thread_pool::~c_thread_pool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+	start_cv_.notify_all();
+	for (auto& worker : workers_) {
+		worker.join();
+	}
+}
+
+void c_thread_pool::parallel_for(std::size_t count, std::size_t chunk, const range_fn& fn) {
+	if (count == 0) return;
+
+	// Split the range into one contiguous slice per worker.
+	const std::size_t workers = workers_.size();
+	for (std::size_t i = 0; i < workers; ++i) {
+		slices_[i].next.store(count * i / workers, std::memory_order_relaxed);
+		slices_[i].end = count * (i + 1) / workers;
+	}
+
+	// Publish the job and wake the workers.
+	std::unique_lock<std::mutex> lock(mutex_);
+	job_ = &fn;
+	chunk_ = std::max<std::size_t>(1, chunk);
+	error_ = nullptr;
+	active_ = static_cast<unsigned>(workers);
+	++generation_;
+	start_cv_.notify_all();
+
+	// Wait for all of them to run out of work.
+	done_cv_.wait(lock, [this] { return active_ == 0; });
+	job_ = nullptr;
+	if (error_) {
+		std::rethrow_exception(error_);
+	}
+}
+
+void c_thread_pool::worker_loop(unsigned worker) {
+	unsigned seen_generation = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			start_cv_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+			if (stopping_) return;
+			seen_generation = generation_;
+		}
+
+		try {
+			run_slices(worker);
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (!error_) error_ = std::current_exception();
+		}
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (--active_ == 0) {
+			done_cv_.notify_one();
+		}
+	}
+}
+
+void c_thread_pool::run_slices(unsigned worker) {
+	// Drain our own slice first, then go round the other workers' slices stealing chunks.
+	const unsigned workers = size();
+	for (unsigned offset = 0; offset < workers; ++offset) {
+		WorkerSlice& slice = slices_[(worker + offset) % workers];
+		while (true) {
+			const std::size_t begin = slice.next.fetch_add(chunk_, std::memory_order_relaxed);
+			if (begin >= slice.end) break;
+			(*job_)(worker, begin, std::min(begin + chunk_, slice.end));
+		}
+	}
+}
@@ -0,0 +1,72 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_thread_pool.h
+// Description : Fixed pool of worker threads that share out ranges of work by stealing.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class c_thread_pool {
+public:
+	/**
+	 * @brief Worker body: called with the worker's index and a [begin, end) chunk of the range.
+	 */
+	using range_fn = std::function<void(unsigned worker, std::size_t begin, std::size_t end)>;
+
+	/**
+	 * @brief Start the worker threads.
+	 * @param thread_count - Number of workers, 0 uses the number of hardware threads.
+	 */
+	explicit c_thread_pool(unsigned thread_count = 0);
+	~c_thread_pool();
+	c_thread_pool(const c_thread_pool&) = delete;
+	c_thread_pool& operator=(const c_thread_pool&) = delete;
+
+	unsigned size() const { return static_cast<unsigned>(workers_.size()); } // Number of workers.
+
+	/**
+	 * @brief Run fn over [0, count) in chunks across all workers and wait until every chunk is done.
+	 * @param count - Size of the range.
+	 * @param chunk - Number of items a worker claims at a time.
+	 * @param fn    - The work, must be safe to call from several threads at once with different workers.
+	 * @note  Each worker starts on its own slice of the range and steals chunks from the others' slices
+	 *        once its own runs dry, so uneven work still keeps every thread busy.
+	 *        Exceptions thrown by fn are rethrown on the calling thread after the range finishes.
+	 */
+	void parallel_for(std::size_t count, std::size_t chunk, const range_fn& fn);
+
+private:
+	struct alignas(64) WorkerSlice { // Padded to a cache line so workers don't false-share cursors.
+		std::atomic<std::size_t> next{ 0 }; // Next unclaimed item in this slice.
+		std::size_t end = 0;                // End of this slice.
+	};
+
+	std::vector<std::thread> workers_;
+	std::unique_ptr<WorkerSlice[]> slices_; // One slice of the current range per worker.
+	const range_fn* job_ = nullptr;         // Work for the current range.
+	std::size_t chunk_ = 1;                 // Chunk size for the current range.
+	std::exception_ptr error_;              // First exception thrown by the current range.
+
+	std::mutex mutex_;
+	std::condition_variable start_cv_;   // Signals workers that a new range is ready.
+	std::condition_variable done_cv_;    // Signals the caller that all workers finished.
+	unsigned generation_ = 0;            // Incremented for each range, workers wait for it to change.
+	unsigned active_ = 0;                // Workers still running the current range.
+	bool stopping_ = false;
+
+	void worker_loop(unsigned worker);
+	void run_slices(unsigned worker);
+};
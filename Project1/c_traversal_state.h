@@ -0,0 +1,88 @@
+// /***********************************************************************
+// Bachelor of Software Engineering
+// Media Design School
+// Auckland
+// New Zealand
+// (c) 2024 Media Design School
+// File Name : c_traversal_state.h
+// Description : Reusable visited bitset and frontiers for c_graph's visitor-based dfs/bfs.
+// Author : Foster Rae
+// Mail : Foster.Rae@mds.ac.nz
+// ************************************************************************/
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Scratch memory for one traversal at a time, indexed by cell (x * cols + y).
+ * @note  Buffers only grow, so once a state has traversed a graph it never allocates for that graph again.
+ */
+class c_traversal_state {
+public:
+	/**
+	 * @brief Start a new traversal over a graph with the specified number of cells.
+	 * @param cell_count - Number of cells (rows * cols) in the graph being traversed.
+	 */
+	void begin(std::size_t cell_count) {
+		visited_.assign((cell_count + 63) / 64, 0); // Keeps its capacity, clearing is one bit per cell.
+		head_ = 0;
+		size_ = 0;
+		stack_.clear();
+	}
+
+	/**
+	 * @brief Mark a cell visited.
+	 * @return True if the cell had not been visited yet.
+	 */
+	bool visit(int index) {
+		std::uint64_t& word = visited_[static_cast<std::size_t>(index) >> 6];
+		const std::uint64_t bit = std::uint64_t(1) << (index & 63);
+		const bool fresh = !(word & bit);
+		word |= bit;
+		return fresh;
+	}
+	bool is_visited(int index) const {
+		return (visited_[static_cast<std::size_t>(index) >> 6] >> (index & 63)) & 1;
+	}
+
+	// BFS frontier, a ring buffer with a power of two capacity that doubles when full.
+	void push_back(int index) {
+		if (size_ == queue_.size()) grow_queue();
+		queue_[(head_ + size_) & (queue_.size() - 1)] = index;
+		++size_;
+	}
+	int pop_front() {
+		const int index = queue_[head_];
+		head_ = (head_ + 1) & (queue_.size() - 1);
+		--size_;
+		return index;
+	}
+	bool queue_empty() const { return size_ == 0; }
+
+	// DFS frontier.
+	void push(int index) { stack_.push_back(index); }
+	int pop() {
+		const int index = stack_.back();
+		stack_.pop_back();
+		return index;
+	}
+	bool stack_empty() const { return stack_.empty(); }
+
+private:
+	std::vector<std::uint64_t> visited_; // One bit per cell.
+	std::vector<int> queue_;             // Ring buffer storage, size is always zero or a power of two.
+	std::size_t head_ = 0;               // Index of the front of the queue.
+	std::size_t size_ = 0;               // Number of queued cells.
+	std::vector<int> stack_;             // Stack storage, reused between traversals.
+
+	void grow_queue() {
+		// Unroll the ring into a buffer twice the size, front first.
+		std::vector<int> grown(queue_.empty() ? 64 : queue_.size() * 2);
+		for (std::size_t i = 0; i < size_; ++i) {
+			grown[i] = queue_[(head_ + i) & (queue_.size() - 1)];
+		}
+		queue_.swap(grown);
+		head_ = 0;
+	}
+};
@@ -1,10 +1,40 @@
 #include <iostream>
+#include <fstream>
 #include <limits>
+#include <algorithm>
 #include "c_dungeon_map.h"
 #include "c_graph.h"
+#include "c_binary_map.h"
+#include "c_item_route.h"
+#include "c_batch_runner.h"
+#include "c_load_generator.h"
+#include "c_map_registry.h"
+#include "c_path_server.h"
+
+constexpr int MAX_DISPLAY_SIZE = 120; // Maps with more rows or columns than this are shown downsampled.
 
 void display_map(const c_dungeon_map& map) {
-	map.display_map();
+	if (map.rows() <= MAX_DISPLAY_SIZE && map.cols() <= MAX_DISPLAY_SIZE) {
+		map.display_map();
+		return;
+	}
+	const MapViewport overview = map.fit_viewport(MAX_DISPLAY_SIZE, MAX_DISPLAY_SIZE);
+	map.display_map(overview);
+	std::cout << "Showing a " << overview.step << 'x' << overview.step << " downsampled overview of the "
+		<< map.rows() << 'x' << map.cols() << " map, use option 8 to view a region.\n";
+}
+
+/**
+ * @brief Report the exit and items that can't be reached from the start of a freshly loaded map.
+ */
+void report_reachability(const c_dungeon_map& map) {
+	const MapReachability& reachable = map.reachability();
+	std::string unreachable = reachable.exit ? "" : " exit";
+	for (int i = 0; i < 10; ++i) {
+		if (!reachable.items[i]) unreachable += std::string(" ") + static_cast<char>('a' + i);
+	}
+	if (unreachable.empty()) std::cout << "The exit and every item can be reached from the start.\n";
+	else std::cout << "Cut off from the start:" << unreachable << '\n';
 }
 
 void display_menu() {
@@ -13,7 +43,9 @@ void display_menu() {
 	std::cout << "3. Perform BFS\n";
 	std::cout << "4. Run A* algorithm\n";
 	std::cout << "5. Save current map\n";
-	std::cout << "6. Exit\n";
+	std::cout << "6. Exit\n"; // Exit keeps the number users know, new options take the numbers after it.
+	std::cout << "7. Plan item collection route\n";
+	std::cout << "8. View a region of the map\n";
 }
 
 /**
@@ -28,11 +60,17 @@ void handle_user_input(const int choice, c_dungeon_map& map, c_graph& graph) {
         std::string filename;
         std::cout << "Enter the filename to load: ";
         std::getline(std::cin >> std::ws, filename); // Read the filename with leading whitespace ignored
+        filename.erase(std::remove(filename.begin(), filename.end(), '\"'), filename.end()); // Quotation marks are ignored.
         std::cout << "Attempting to load file: " << filename << std::endl;
         try {
             // Load & verify the map, catching any exceptions.
-            map.load_map(filename);
+            if (is_binary_map_file(filename)) {
+                map.load_binary_map(filename);
+            } else {
+                map.load_map(filename);
+            }
             std::cout << "Map loaded and verified successfully.\n";
+            report_reachability(map);
             graph = map.to_graph(); // Convert the map to a graph
         }
         catch (const std::exception& e) {
@@ -78,8 +116,18 @@ void handle_user_input(const int choice, c_dungeon_map& map, c_graph& graph) {
             auto end_pos = map.get_end_node();
             Node start_node = graph.get_node(start_pos.first, start_pos.second);
             Node end_node = graph.get_node(end_pos.first, end_pos.second);
-            // Perform the A* algorithm.
-            std::vector<std::pair<int, int>> path = graph.a_star(start_node, end_node);
+            // Perform the A* algorithm, over the terrain costs if the map has roads, mud or water.
+            std::vector<std::pair<int, int>> path;
+            if (graph.has_terrain()) {
+                c_weighted_search_state state;
+                path = graph.weighted_a_star(start_node, end_node, state);
+                std::cout << (path.empty() ? "No path found!" : "Path found!") << std::endl;
+            } else {
+                path = graph.a_star(start_node, end_node);
+                if constexpr (SEARCH_STATS_ENABLED) {
+                    std::cout << to_json(graph.last_search_stats()) << '\n'; // Only built with -DPATHFINDING_STATS=1.
+                }
+            }
             if (!path.empty()) {
                 // Mark the path on the map.
                 map.mark_path(path);
@@ -112,13 +160,187 @@ void handle_user_input(const int choice, c_dungeon_map& map, c_graph& graph) {
     	exit(0);
     }
 
+    case 7: { // === Item collection route ===
+        try {
+            // Shortest route from the start through every item to the exit.
+            c_item_route_planner planner(graph);
+            const ItemRoute route = planner.plan();
+            if (route.found) {
+                std::cout << "Route of " << route.length << " steps" << (route.optimal ? "" : " (approximate)") << ":";
+                for (const auto& stop : route.stops) {
+                    std::cout << ' ' << graph.special_at(graph.cell_index(stop.first, stop.second));
+                }
+                std::cout << std::endl;
+                map.mark_path(route.path);
+            } else {
+                std::cout << "No route collects every item!" << std::endl;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error planning item route: " << e.what() << '\n';
+        }
+        break;
+    }
+
+    case 8: { // === View region ===
+        MapViewport viewport;
+        std::cout << "Enter the top row, left column, rows, columns and step (1 for every cell): ";
+        if (std::cin >> viewport.top >> viewport.left >> viewport.rows >> viewport.cols >> viewport.step) {
+            map.display_map(viewport);
+            std::cout << "Press Enter to continue...";
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            std::cin.get();
+        } else {
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            std::cerr << "Invalid region.\n";
+        }
+        break;
+    }
+
     default:
         std::cerr << "Invalid choice. Please try again.\n";
         break;
     }
 }
 
-int main() {
+/**
+ * @brief Convert a map between the text and binary formats, picking the direction from the input's extension.
+ * @return The process exit code.
+ */
+int run_convert(const std::string& input, const std::string& output) {
+    try {
+        if (is_binary_map_file(input)) {
+            convert_binary_to_text(input, output);
+        } else {
+            convert_text_to_binary(input, output);
+        }
+        std::cout << "Converted " << input << " to " << output << '\n';
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error converting map: " << e.what() << '\n';
+        return 1;
+    }
+}
+
+/**
+ * @brief Split a <name>=<map file> argument.
+ */
+std::pair<std::string, std::string> parse_map_argument(const std::string& argument) {
+    const std::size_t equals = argument.find('=');
+    if (equals == std::string::npos || equals == 0 || equals + 1 == argument.size()) {
+        throw std::invalid_argument("Expected <name>=<map file>, got " + argument);
+    }
+    return { argument.substr(0, equals), argument.substr(equals + 1) };
+}
+
+/**
+ * @brief Run the headless path server, see c_path_server for the requests it answers.
+ * @param arguments - [--socket=<path>] [<name>=<map file> ...], without a socket requests are read from stdin.
+ * @return The process exit code.
+ */
+int run_server(const std::vector<std::string>& arguments) {
+    try {
+        c_map_registry registry;
+        std::string socket_path;
+        for (const std::string& argument : arguments) {
+            if (argument.rfind("--socket=", 0) == 0) {
+                socket_path = argument.substr(9);
+            } else {
+                const auto [name, filename] = parse_map_argument(argument);
+                registry.load(name, filename);
+                std::cerr << "Loaded " << name << " from " << filename << '\n';
+            }
+        }
+        c_path_server server(registry);
+        if (socket_path.empty()) {
+            server.serve(std::cin, std::cout);
+        } else {
+            std::cerr << "Listening on " << socket_path << '\n';
+            server.serve(socket_path);
+        }
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Server error: " << e.what() << '\n';
+        return 1;
+    }
+}
+
+/**
+ * @brief Run the load generator against a running server and print the latency report.
+ * @param arguments - --socket=<path> [--connections=N] [--queries=N] [--reload-ms=N] <name>=<map file> ...
+ * @return The process exit code.
+ */
+int run_load_test_client(const std::vector<std::string>& arguments) {
+    try {
+        LoadTestOptions options;
+        for (const std::string& argument : arguments) {
+            if (argument.rfind("--socket=", 0) == 0) options.socket_path = argument.substr(9);
+            else if (argument.rfind("--connections=", 0) == 0) options.connections = static_cast<unsigned>(std::stoul(argument.substr(14)));
+            else if (argument.rfind("--queries=", 0) == 0) options.queries = std::stoul(argument.substr(10));
+            else if (argument.rfind("--reload-ms=", 0) == 0) options.reload_ms = static_cast<unsigned>(std::stoul(argument.substr(12)));
+            else options.maps.push_back(parse_map_argument(argument));
+        }
+        if (options.socket_path.empty()) throw std::invalid_argument("--socket=<path> is required");
+        std::cout << to_string(run_load_test(options)) << '\n';
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Load test error: " << e.what() << '\n';
+        return 1;
+    }
+}
+
+/**
+ * @brief Run a batch file through c_batch_runner without the menu or any rendering.
+ * @param arguments - <batch file> <output file> [--threads=N] [--no-timings]
+ * @return The process exit code, 1 if any map in the batch failed.
+ */
+int run_batch(const std::vector<std::string>& arguments) {
+    try {
+        if (arguments.size() < 2) throw std::invalid_argument("Expected <batch file> <output file>");
+        unsigned threads = 0;
+        bool timings = true;
+        for (std::size_t i = 2; i < arguments.size(); ++i) {
+            if (arguments[i].rfind("--threads=", 0) == 0) threads = static_cast<unsigned>(std::stoul(arguments[i].substr(10)));
+            else if (arguments[i] == "--no-timings") timings = false;
+            else throw std::invalid_argument("Unknown option " + arguments[i]);
+        }
+        const std::vector<BatchJob> jobs = parse_batch_file(arguments[0]);
+        std::ofstream out(arguments[1]);
+        if (!out.is_open()) throw std::runtime_error("Could not open " + arguments[1] + " for writing");
+        c_batch_runner runner(threads, timings);
+        const BatchSummary summary = runner.run(jobs, out);
+        std::cout << summary.maps << " maps (" << summary.failed << " failed), " << summary.paths_found << '/' << summary.queries
+            << " paths found in " << summary.seconds << "s on " << runner.thread_count() << " threads\n";
+        return summary.failed == 0 ? 0 : 1;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Batch error: " << e.what() << '\n';
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+	// Usage: Project1 --convert <input> <output>
+	//        Project1 --server [--socket=<path>] [<name>=<map file> ...]
+	//        Project1 --load-test --socket=<path> [--connections=N] [--queries=N] [--reload-ms=N] <name>=<map file> ...
+	//        Project1 --batch <batch file> <output file> [--threads=N] [--no-timings]
+	// otherwise the interactive menu runs.
+	if (argc == 4 && std::string(argv[1]) == "--convert") {
+		return run_convert(argv[2], argv[3]);
+	}
+	if (argc >= 2 && std::string(argv[1]) == "--server") {
+		return run_server(std::vector<std::string>(argv + 2, argv + argc));
+	}
+	if (argc >= 2 && std::string(argv[1]) == "--batch") {
+		return run_batch(std::vector<std::string>(argv + 2, argv + argc));
+	}
+	if (argc >= 2 && std::string(argv[1]) == "--load-test") {
+		return run_load_test_client(std::vector<std::string>(argv + 2, argv + argc));
+	}
+
 	try {
 		// Create the Objects.
 		c_dungeon_map map; // Initialize with an empty map